@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_ARENA_H
+#define CXXTOOLS_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace cxxtools
+{
+    /**
+     Monotonic memory region.
+
+     Memory is taken from large blocks and is not released individually. All
+     memory is made available again at once using `clear()`. The blocks are
+     kept for reuse, so that after a warm up phase no more memory is
+     allocated from the heap.
+
+     The arena does not run destructors of the objects placed into it. It is
+     not thread safe.
+     */
+    class Arena
+    {
+            struct Block
+            {
+                Block* next;
+                std::size_t size;
+            };
+
+            Block* _first;
+            Block* _current;
+            char* _ptr;
+            char* _end;
+            std::size_t _blockSize;
+
+            void* allocateBlock(std::size_t size, std::size_t align);
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+        public:
+            static const std::size_t defaultBlockSize = 16384;
+
+            explicit Arena(std::size_t blockSize = defaultBlockSize)
+                : _first(0),
+                  _current(0),
+                  _ptr(0),
+                  _end(0),
+                  _blockSize(blockSize)
+            { }
+
+            ~Arena()
+            { release(); }
+
+            /// Returns uninitialized memory of `size` bytes.
+            void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t))
+            {
+                std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(_ptr) + align - 1) & ~(align - 1);
+                if (_ptr == 0 || p + size > reinterpret_cast<std::uintptr_t>(_end))
+                    return allocateBlock(size, align);
+
+                _ptr = reinterpret_cast<char*>(p + size);
+                return _ptr - size;
+            }
+
+            /// Makes all memory available again but keeps the blocks.
+            void clear();
+
+            /// Releases all blocks.
+            void release();
+
+            /// Returns the number of bytes allocated from the heap.
+            std::size_t capacity() const;
+    };
+
+    /**
+     Allocator for standard containers, which takes memory from an Arena.
+
+     A default constructed allocator uses the heap. Copies of containers
+     always use the heap, so that they may outlive the arena.
+     */
+    template <typename T>
+    class ArenaAllocator
+    {
+            Arena* _arena;
+
+        public:
+            typedef T value_type;
+            typedef std::true_type propagate_on_container_move_assignment;
+            typedef std::true_type propagate_on_container_swap;
+
+            explicit ArenaAllocator(Arena* arena = 0) noexcept
+                : _arena(arena)
+            { }
+
+            template <typename U>
+            ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+                : _arena(other.arena())
+            { }
+
+            Arena* arena() const noexcept
+            { return _arena; }
+
+            T* allocate(std::size_t n)
+            {
+                if (_arena)
+                    return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            }
+
+            void deallocate(T* p, std::size_t)
+            {
+                if (!_arena)
+                    ::operator delete(p);
+            }
+
+            ArenaAllocator select_on_container_copy_construction() const
+            { return ArenaAllocator(); }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+    { return a.arena() == b.arena(); }
+
+    template <typename T, typename U>
+    bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+    { return a.arena() != b.arena(); }
+}
+
+#endif // CXXTOOLS_ARENA_H
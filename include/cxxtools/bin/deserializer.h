@@ -47,12 +47,15 @@ namespace bin
 
             /// Default construct binary deserializer.
             Deserializer()
+                : _in(0)
             { }
 
             /// Creates a binary deserializer and processes all input from passed stream.
             explicit Deserializer(std::istream& in)
+                : _in(0)
             { read(in); }
             explicit Deserializer(std::streambuf& in)
+                : _in(0)
             { read(in); }
 
             Deserializer(const char* data, size_t size);
@@ -61,6 +64,12 @@ namespace bin
             void read(std::istream& in);
             void read(std::streambuf& in);
 
+            /// Prepares reading the elements of an array one by one using next().
+            /// The stream must stay valid until all elements are read.
+            void beginStream(std::istream& in)
+            { beginStream(*in.rdbuf()); }
+            void beginStream(std::streambuf& in);
+
             /// Initialize the binary deserializer to receive data.
             void begin(bool resetDictionary = true);
 
@@ -75,9 +84,13 @@ namespace bin
             void skip()
             { _parser.skip(); }
 
+        protected:
+            bool readElement();
+
         private:
             void doDeserialize(std::istream& in);
             Parser _parser;
+            std::streambuf* _in;
     };
 }
 }
@@ -31,7 +31,7 @@
 
 #include <cxxtools/formatter.h>
 #include <iosfwd>
-#include <vector>
+#include <unordered_map>
 
 namespace cxxtools
 {
@@ -49,7 +49,9 @@ public:
         : _out(&out)
         { }
 
-    void begin(std::streambuf& out);
+    /// Starts writing to the passed stream. Unless resetDictionary is
+    /// false, names written before are not referenced any more.
+    void begin(std::streambuf& out, bool resetDictionary = true);
 
     void format(const SerializationInfo& si);
 
@@ -106,7 +108,8 @@ private:
     void outputString(const std::string& value);
 
     std::streambuf* _out = nullptr;
-    std::vector<std::string> _dictionary;
+    // maps names and type names already written to their index in the data stream
+    std::unordered_map<std::string, unsigned> _dictionary;
 };
 
 }
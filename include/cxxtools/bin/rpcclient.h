@@ -167,6 +167,17 @@ class RpcClient : public RemoteClient
 
         void domain(const std::string& p);
 
+        /** @brief Enables a dictionary which persists over calls on one connection.
+
+            When enabled, the client negotiates with the server, whether
+            strings and procedure names may be referenced across messages.
+            Repeated calls then transfer member names only once per
+            connection. Servers not supporting it are called as usual.
+         */
+        void persistentDictionary(bool sw);
+
+        bool persistentDictionary() const;
+
         Delegate<bool, const SslCertificate&>& acceptSslCertificate();
 };
 
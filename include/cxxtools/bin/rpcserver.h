@@ -102,6 +102,15 @@ class RpcServer : public ServiceRegistry
         unsigned maxThreads() const;
         void maxThreads(unsigned m);
 
+        /** Open one listener per minimum number of threads with SO_REUSEPORT.
+
+            The kernel then distributes new connections between the
+            listeners, so that the threads accept in parallel. It must be set
+            before calling `listen`.
+         */
+        bool reusePort() const;
+        void reusePort(bool sw);
+
         enum Runmode {
           Stopped,
           Starting,
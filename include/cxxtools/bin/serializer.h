@@ -30,7 +30,10 @@
 #define CXXTOOLS_BIN_SERIALIZER_H
 
 #include <cxxtools/serializationinfo.h>
-#include <iosfwd>
+#include <cxxtools/bin/formatter.h>
+#include <cxxtools/decomposer.h>
+#include <iostream>
+#include <sstream>
 
 namespace cxxtools
 {
@@ -108,6 +111,8 @@ public:
         RpcRequest = 0xc0,
         RpcResponse = 0xc1,
         RpcException = 0xc2,
+        RpcRequestDomain = 0xc3,
+        RpcRequestPersistent = 0xc4, // request with persistent dictionary
         Eod = 0xff
     };
 
@@ -128,7 +133,7 @@ public:
     /// object interface
     template <typename T>
     Serializer& serialize(const T& v)
-    { serialize(_streambuf, v); return *this; }
+    { serialize(*_streambuf, v); return *this; }
 
     void finish()
     { }
@@ -140,19 +145,14 @@ public:
     template <typename T>
     static void serialize(std::ostream& out, const T& v)
     {
-        SerializationInfo si;
-        si <<= v;
-        serialize(out, si);
+        serialize(*out.rdbuf(), v);
     }
 
     /// static interface
     template <typename T>
     static void serialize(std::ostream& out, const T& v, const std::string& name)
     {
-        SerializationInfo si;
-        si <<= v;
-        si.setName(name);
-        serialize(out, si);
+        serialize(*out.rdbuf(), v, name);
     }
 
     /// static interface
@@ -161,19 +161,16 @@ public:
     template <typename T>
     static void serialize(std::streambuf& out, const T& v, const std::string& name)
     {
-        SerializationInfo si;
-        si <<= v;
-        si.setName(name);
-        serialize(out, si);
+        Formatter formatter(out);
+        formatDirect(formatter, name, v);
     }
 
     /// static interface
     template <typename T>
     static void serialize(std::streambuf& out, const T& v)
     {
-        SerializationInfo si;
-        si <<= v;
-        serialize(out, si);
+        Formatter formatter(out);
+        formatDirect(formatter, std::string(), v);
     }
 
     /// static interface
@@ -183,9 +180,9 @@ public:
     template <typename T>
     static std::string toString(const T& obj)
     {
-        SerializationInfo si;
-        si <<= obj;
-        return toString(si);
+        std::stringbuf s;
+        serialize(s, obj);
+        return s.str();
     }
 
 private:
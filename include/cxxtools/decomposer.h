@@ -29,13 +29,12 @@
 #define cxxtools_Decomposer_h
 
 #include <cxxtools/serializationinfo.h>
+#include <cxxtools/formatter.h>
 #include <string>
 
 namespace cxxtools
 {
 
-class Formatter;
-
 class IDecomposer
 {
     public:
@@ -84,6 +83,169 @@ class Decomposer : public IDecomposer
 };
 
 
+/** @brief Streaming serialization
+
+    Serializers normally convert a object into a SerializationInfo using the
+    serialization operator and pass that to the formatter. For large objects
+    the SerializationInfo takes much more memory than the object itself.
+
+    A type may be formatted directly without building a SerializationInfo by
+    defining a function:
+
+        void formatValue(cxxtools::Formatter& formatter, const std::string& name, const YourType& object)
+        {
+            formatter.beginObject(name, "YourType");
+            cxxtools::formatMember(formatter, "a", object.a);
+            cxxtools::formatMember(formatter, "b", object.b);
+            formatter.finishObject();
+        }
+
+    It must produce the same calls to the formatter, which
+    IDecomposer::formatEach would produce for the SerializationInfo of the
+    object. Types without such a function use the serialization operator.
+
+    Scalar types and the standard sequence containers are formatted
+    directly. A container of types without formatValue passes just one
+    element at a time through a SerializationInfo, so that memory usage
+    stays constant. When you define your own serialization operator for a
+    standard container, define formatValue for it as well.
+ */
+template <typename T>
+void formatValue(Formatter& formatter, const std::string& name, const T& value) = delete;
+
+inline void formatValue(Formatter& formatter, const std::string& name, bool value)
+{ formatter.addValueBool(name, "bool", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, char value)
+{ formatter.addValueChar(name, "char", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, signed char value)
+{ formatter.addValueInt(name, "char", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned char value)
+{ formatter.addValueUnsigned(name, "char", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, short value)
+{ formatter.addValueInt(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned short value)
+{ formatter.addValueUnsigned(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, int value)
+{ formatter.addValueInt(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned int value)
+{ formatter.addValueUnsigned(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, long value)
+{ formatter.addValueInt(name, "int", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned long value)
+{ formatter.addValueUnsigned(name, "int", value); }
+
+#ifdef HAVE_LONG_LONG
+inline void formatValue(Formatter& formatter, const std::string& name, long long value)
+{ formatter.addValueInt(name, "int", value); }
+#endif
+
+#ifdef HAVE_UNSIGNED_LONG_LONG
+inline void formatValue(Formatter& formatter, const std::string& name, unsigned long long value)
+{ formatter.addValueUnsigned(name, "int", value); }
+#endif
+
+inline void formatValue(Formatter& formatter, const std::string& name, float value)
+{ formatter.addValueFloat(name, "float", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, double value)
+{ formatter.addValueDouble(name, "double", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, long double value)
+{ formatter.addValueLongDouble(name, "double", value); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, const std::string& value)
+{ formatter.addValueStdString(name, "string", std::string(value)); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, const String& value)
+{ formatter.addValueString(name, "string", String(value)); }
+
+template <typename T>
+void formatDirect(Formatter& formatter, const std::string& name, const T& value);
+
+template <typename Iterator>
+void formatArray(Formatter& formatter, const std::string& name, const char* type, Iterator begin, Iterator end)
+{
+    formatter.beginArray(name, type);
+    for ( ; begin != end; ++begin)
+        formatDirect(formatter, std::string(), *begin);
+    formatter.finishArray();
+}
+
+template <typename T, typename A>
+void formatValue(Formatter& formatter, const std::string& name, const std::vector<T, A>& vec)
+{ formatArray(formatter, name, "array", vec.begin(), vec.end()); }
+
+template <typename T, typename A>
+void formatValue(Formatter& formatter, const std::string& name, const std::list<T, A>& list)
+{ formatArray(formatter, name, "list", list.begin(), list.end()); }
+
+template <typename T, typename A>
+void formatValue(Formatter& formatter, const std::string& name, const std::deque<T, A>& deque)
+{ formatArray(formatter, name, "deque", deque.begin(), deque.end()); }
+
+template <typename T, typename C, typename A>
+void formatValue(Formatter& formatter, const std::string& name, const std::set<T, C, A>& set)
+{ formatArray(formatter, name, "set", set.begin(), set.end()); }
+
+template <typename T, typename C, typename A>
+void formatValue(Formatter& formatter, const std::string& name, const std::multiset<T, C, A>& multiset)
+{ formatArray(formatter, name, "multiset", multiset.begin(), multiset.end()); }
+
+inline void formatValue(Formatter& formatter, const std::string& name, const SerializationInfo& si)
+{
+    if (si.name() == name)
+    {
+        IDecomposer::formatEach(si, formatter);
+    }
+    else
+    {
+        SerializationInfo s(si);
+        s.setName(name);
+        IDecomposer::formatEach(s, formatter);
+    }
+}
+
+template <typename T>
+auto formatDirectImpl(Formatter& formatter, const std::string& name, const T& value, int)
+    -> decltype(formatValue(formatter, name, value), void())
+{
+    formatValue(formatter, name, value);
+}
+
+template <typename T>
+void formatDirectImpl(Formatter& formatter, const std::string& name, const T& value, long)
+{
+    SerializationInfo si;
+    si <<= value;
+    si.setName(name);
+    IDecomposer::formatEach(si, formatter);
+}
+
+/// Formats the value using formatValue if available or through a SerializationInfo otherwise.
+template <typename T>
+void formatDirect(Formatter& formatter, const std::string& name, const T& value)
+{
+    formatDirectImpl(formatter, name, value, 0);
+}
+
+/// Formats a member of an object using formatDirect.
+template <typename T>
+void formatMember(Formatter& formatter, const std::string& name, const T& value)
+{
+    formatter.beginMember(name);
+    formatDirect(formatter, name, value);
+    formatter.finishMember();
+}
+
 } // namespace cxxtools
 
 #endif
@@ -54,6 +54,10 @@ namespace cxxtools
 #endif
 
             Deserializer()
+                : _arena(0),
+                  _streaming(false),
+                  _elementReady(false),
+                  _streamEnd(false)
             { }
 
             virtual ~Deserializer()
@@ -87,6 +91,26 @@ namespace cxxtools
                 *p >>= type;
             }
 
+            /** @brief Deserialize the next element of a top level array
+
+                The input is read only until the next element of the array is
+                complete. The previous element is released, so that huge
+                arrays can be processed in constant memory.
+
+                The input is passed using beginStream() of the actual
+                deserializer. Returns false when the end of the array is
+                reached.
+            */
+            template <typename T>
+            bool next(T& element)
+            {
+                if (!nextElement())
+                    return false;
+
+                *static_cast<const SerializationInfo&>(_si).begin() >>= element;
+                return true;
+            }
+
             SerializationInfo& si()
             { return _si; }
 
@@ -97,6 +121,18 @@ namespace cxxtools
 
             void clear();
 
+            /** @brief Places the deserialized tree into the passed arena
+
+                The tree is released and the arena is cleared when the
+                deserializer is cleared, so that each deserialized tree is
+                freed in one step. Hence the arena must not be shared with
+                other trees. It must live longer than the deserializer.
+             */
+            void setArena(Arena* arena);
+
+            Arena* arena() const
+            { return _arena; }
+
             SerializationInfo* current()
             { return _current.empty() ? 0 : _current.top(); }
 
@@ -149,9 +185,28 @@ namespace cxxtools
 
             void leaveMember();
 
+            /// Returns true, when a element of a top level array is complete while streaming.
+            bool elementReady() const
+            { return _elementReady; }
+
+        protected:
+            /// Initializes the deserializer to deliver the elements of a top level array with next().
+            void beginStream();
+
+            /// Processes input until elementReady() is set or the end of data is reached.
+            /// Returns true, when the end of data is reached.
+            virtual bool readElement();
+
         private:
+            bool nextElement();
+            void releaseElement();
+
             SerializationInfo _si;
             std::stack<SerializationInfo*> _current;
+            Arena* _arena;
+            bool _streaming;
+            bool _elementReady;
+            bool _streamEnd;
     };
 
 }
@@ -30,6 +30,8 @@
 #define cxxtools_EVENT_H
 
 #include <typeinfo>
+#include <cstddef>
+#include <new>
 
 namespace cxxtools
 {
@@ -51,6 +53,18 @@ namespace cxxtools
 
             virtual Event* clone() const = 0;
 
+            /** \brief Copies the event into the passed buffer.
+
+                The buffer must be aligned like std::max_align_t. When the
+                event does not fit into the buffer, it is copied to the heap
+                like with clone(). An event returned in the buffer is released
+                by calling its destructor, otherwise with destroy().
+             */
+            virtual Event* cloneTo(void* /*buffer*/, std::size_t /*size*/) const
+            {
+                return clone();
+            }
+
             virtual void destroy() = 0;
 
             virtual const std::type_info& typeInfo() const = 0;
@@ -78,6 +92,14 @@ namespace cxxtools
                 return new T(*static_cast<const T*>(this));
             }
 
+            virtual Event* cloneTo(void* buffer, std::size_t size) const
+            {
+                if (sizeof(T) <= size && alignof(T) <= alignof(std::max_align_t))
+                    return new (buffer) T(*static_cast<const T*>(this));
+
+                return clone();
+            }
+
             virtual void destroy()
             {
                 delete this;
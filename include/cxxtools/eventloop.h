@@ -148,6 +148,10 @@ namespace cxxtools
             */
             EventLoop();
 
+            /** @brief Constructs the EventLoop using the given selector backend
+            */
+            explicit EventLoop(Backend backend);
+
             /** @brief Destructs the EventLoop
              */
             virtual ~EventLoop();
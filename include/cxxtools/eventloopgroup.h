@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef CXXTOOLS_EVENTLOOPGROUP_H
+#define CXXTOOLS_EVENTLOOPGROUP_H
+
+#include <functional>
+
+namespace cxxtools
+{
+
+    class EventLoop;
+    class Selectable;
+
+    /** @brief A number of event loops, each running in its own thread.
+
+        The group runs one EventLoop per core or the number given to the
+        constructor. When supported by the system, the thread of each loop is
+        pinned to a core.
+
+        Selectables are distributed to the loops either round robin or to the
+        loop with the least load. The load of a loop is the number of
+        selectables or other units of work assigned to it.
+
+        Functions can be posted to a loop from any thread and are executed in
+        the thread of the loop. Posting does not allocate memory for small
+        function objects.
+
+        Stopping the group executes all functions posted before and then
+        exits the loops, so a group can be shared by multiple servers and each
+        of them can clean up in the threads of the loops when it terminates.
+     */
+    class EventLoopGroup
+    {
+            EventLoopGroup(const EventLoopGroup&) = delete;
+            EventLoopGroup& operator=(const EventLoopGroup&) = delete;
+
+        public:
+            /// How new selectables are distributed to the loops.
+            enum Assignment
+            {
+                RoundRobin,
+                LeastLoaded
+            };
+
+            /** @brief Creates a group of n event loops
+
+                When n is 0, one loop per core is created. The loops are not
+                started yet.
+             */
+            explicit EventLoopGroup(unsigned n = 0);
+
+            /** @brief Stops the loops and destroys the group
+             */
+            ~EventLoopGroup();
+
+            /** @brief Starts a thread for each loop
+             */
+            void start();
+
+            /** @brief Stops all loops and waits for their threads
+
+                Functions posted before are executed before the loops exit.
+             */
+            void stop();
+
+            bool running() const;
+
+            /// Returns the number of loops.
+            unsigned size() const;
+
+            /// Returns the n'th loop.
+            EventLoop& loop(unsigned n);
+
+            /// Returns the index of the loop or -1 if it is not part of the group.
+            int indexOf(const EventLoop& loop) const;
+
+            /// Returns true, when the threads are pinned to cores. The default is true.
+            bool pinToCores() const;
+
+            /// Pins the threads to cores; must be set before starting the group.
+            void pinToCores(bool sw);
+
+            Assignment assignment() const;
+
+            /// Sets the distribution of new selectables. The default is LeastLoaded.
+            void assignment(Assignment a);
+
+            /** @brief Selects a loop and adds one to its load
+
+                The loop is selected according to the assignment policy. The
+                caller must call release with the returned index, when the work
+                is finished.
+             */
+            unsigned assign();
+
+            /// Adds one to the load of the n'th loop.
+            void assign(unsigned n);
+
+            /// Subtracts one from the load of the n'th loop.
+            void release(unsigned n);
+
+            /// Returns the current load of the n'th loop.
+            unsigned load(unsigned n) const;
+
+            /** @brief Adds the selectable to one of the loops
+
+                The loop is selected using assign and the selectable is added
+                in the thread of the loop. Returns the selected loop.
+             */
+            EventLoop& add(Selectable& s);
+
+            /** @brief Removes the selectable from its loop
+
+                It must be called in the thread of the loop, the selectable was
+                added to.
+             */
+            void remove(Selectable& s);
+
+            /** @brief Executes the function in the thread of the n'th loop
+
+                The function is queued and the loop is woken up. It is thread
+                safe. Exceptions thrown by the function are logged and ignored.
+             */
+            void post(unsigned n, std::function<void()> fn);
+
+            /** @brief Executes the function in the thread of the loop
+
+                The loop must be part of the group.
+             */
+            void post(EventLoop& loop, std::function<void()> fn);
+
+            /** @brief Executes the function in the thread of the n'th loop and waits for it
+
+                When called in the thread of the loop or when the group is not
+                running, the function is called directly. Exceptions thrown by
+                the function are passed to the caller.
+             */
+            void execute(unsigned n, const std::function<void()>& fn);
+
+        private:
+            class Impl;
+            Impl* _impl;
+    };
+
+} // namespace cxxtools
+
+#endif // CXXTOOLS_EVENTLOOPGROUP_H
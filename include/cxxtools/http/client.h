@@ -215,6 +215,34 @@ class Client
          */
         const Reply& readBody();
 
+        /** Sends a request without waiting for the reply.
+
+            Several requests can be sent this way on the same connection
+            before the replies are read with readReply in the same order
+            (http pipelining). This saves a round trip per request. Since the
+            server sends the replies only while the client reads them, the
+            number of outstanding requests should be limited.
+
+            Unlike execute, a request is not repeated when the server has
+            closed a keep alive connection in the meantime. Calling execute
+            discards all outstanding replies.
+         */
+        void sendRequest(const Request& request,
+            Milliseconds timeout = Selectable::WaitInfinite,
+            Milliseconds connectTimeout = Selectable::WaitInfinite);
+
+        /** Reads the reply of the oldest request sent with sendRequest.
+
+            This method blocks until header and body are received.
+         */
+        const Reply& readReply(Milliseconds timeout = Selectable::WaitInfinite);
+
+        /// Returns the number of requests sent with sendRequest, which replies are not read yet.
+        unsigned pendingReplies() const;
+
+        /// Returns true, if the client has an open connection to the server.
+        bool isConnected() const;
+
         /** Returns the reply of the last executed request.
          */
         const Reply& reply() const;
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_HTTP_CLIENTPOOL_H
+#define CXXTOOLS_HTTP_CLIENTPOOL_H
+
+#include <cxxtools/http/client.h>
+#include <cxxtools/sslctx.h>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace cxxtools
+{
+namespace http
+{
+
+class PooledClient;
+
+/**
+ A thread safe pool of http clients.
+
+ The clients are kept per server, which is identified by host, port and
+ ssl context. A client returned to the pool keeps its keep alive
+ connection, so that the next request to the same server does not need to
+ connect again. The number of clients per server, which are in use at the
+ same time, is limited by maxConnections. When all are in use, acquire
+ blocks until one is released.
+
+ \code
+   cxxtools::http::ClientPool pool(4);
+
+   // may be called from many threads
+   cxxtools::http::PooledClient client = pool.acquire("localhost", 8000);
+   std::string body = client->get("/").body();
+ \endcode
+ */
+class ClientPool
+{
+        friend class PooledClient;
+
+        typedef std::tuple<std::string, unsigned short, const SslCtx::Impl*> Key;
+
+        struct Server
+        {
+            SslCtx sslCtx;
+            std::vector<Client*> idle;
+            unsigned active;
+
+            Server()
+                : active(0)
+                { }
+        };
+
+        typedef std::map<Key, Server> Servers;
+
+        Servers _servers;
+        unsigned _maxConnections;
+        unsigned _maxIdle;
+        std::mutex _mutex;
+        std::condition_variable _released;
+
+        void release(Server* server, Client* client, bool reuse);
+
+        // make non copyable
+        ClientPool(const ClientPool&) = delete;
+        ClientPool& operator=(const ClientPool&) = delete;
+
+    public:
+        /// Creates a pool, which uses up to \a maxConnections connections
+        /// per server.
+        explicit ClientPool(unsigned maxConnections = 8)
+            : _maxConnections(maxConnections),
+              _maxIdle(maxConnections)
+            { }
+
+        /// Closes all idle connections. All clients must be released
+        /// before the pool is destroyed.
+        ~ClientPool();
+
+        /// Returns a client for the server. It blocks while maxConnections
+        /// clients for this server are in use.
+        PooledClient acquire(const std::string& host, unsigned short port,
+                             const SslCtx& sslCtx = SslCtx());
+
+        unsigned maxConnections() const       { return _maxConnections; }
+        void maxConnections(unsigned n);
+
+        /// Sets the number of idle connections per server, which are kept
+        /// open. More connections are closed when released.
+        unsigned maxIdle() const              { return _maxIdle; }
+        void maxIdle(unsigned n)              { _maxIdle = n; }
+
+        /// Closes all idle connections.
+        void clear();
+};
+
+/**
+ A http client taken from a ClientPool.
+
+ The client is returned to the pool when this object is destroyed or
+ release is called. The object can be moved but not copied.
+ */
+class PooledClient
+{
+        friend class ClientPool;
+
+        ClientPool* _pool;
+        ClientPool::Server* _server;
+        Client* _client;
+
+        PooledClient(ClientPool* pool, ClientPool::Server* server, Client* client)
+            : _pool(pool),
+              _server(server),
+              _client(client)
+            { }
+
+        // make non copyable
+        PooledClient(const PooledClient&) = delete;
+        PooledClient& operator=(const PooledClient&) = delete;
+
+    public:
+        PooledClient()
+            : _pool(0),
+              _server(0),
+              _client(0)
+            { }
+
+        PooledClient(PooledClient&& other)
+            : _pool(other._pool),
+              _server(other._server),
+              _client(other._client)
+            { other._client = 0; }
+
+        PooledClient& operator=(PooledClient&& other);
+
+        ~PooledClient()
+            { release(); }
+
+        Client& operator*() const    { return *_client; }
+        Client* operator->() const   { return _client; }
+        Client* get() const          { return _client; }
+
+        /// Returns the client to the pool. Its connection is kept for
+        /// reuse, if it is still open.
+        void release();
+
+        /// Returns the client to the pool after closing the connection.
+        /// This should be used when the state of the connection is unknown
+        /// e.g. after an error.
+        void discard();
+};
+
+}
+}
+
+#endif // CXXTOOLS_HTTP_CLIENTPOOL_H
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_HTTP_FILESERVICE_H
+#define CXXTOOLS_HTTP_FILESERVICE_H
+
+#include <cxxtools/http/service.h>
+#include <string>
+
+namespace cxxtools
+{
+namespace http
+{
+
+/** @brief A service, which delivers static files from a directory
+
+    The service maps the url of the request to a file below the document
+    root. The \a prefix, if given, is stripped from the url first, so that
+    the service can be registered with a regular expression like
+    "^/static/" and serve the directory contents under that path.
+
+    Only GET and HEAD requests are accepted. The service sets
+    Last-Modified and answers If-Modified-Since with 304 and it supports
+    requests with a single byte range.
+
+    On plain connections the file is sent with sendfile(2), so that the
+    content is not copied through user space. On ssl connections it is
+    read and sent in chunks.
+
+    @code
+    cxxtools::http::Server server(loop, 8000);
+    cxxtools::http::FileService files("/var/www", "/static");
+    server.addService(cxxtools::Regex("^/static/"), files);
+    @endcode
+ */
+class FileService : public CachedServiceBase
+{
+    public:
+        explicit FileService(const std::string& documentRoot, const std::string& prefix = std::string())
+            : _documentRoot(documentRoot),
+              _prefix(prefix)
+            { }
+
+        const std::string& documentRoot() const  { return _documentRoot; }
+        const std::string& prefix() const        { return _prefix; }
+
+    protected:
+        Responder* newResponder();
+
+    private:
+        std::string _documentRoot;
+        std::string _prefix;
+};
+
+}
+}
+
+#endif // CXXTOOLS_HTTP_FILESERVICE_H
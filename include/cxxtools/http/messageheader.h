@@ -29,6 +29,7 @@
 #ifndef cxxtools_Http_MessageHeader_h
 #define cxxtools_Http_MessageHeader_h
 
+#include <cxxtools/datetime.h>
 #include <string>
 #include <cstring>
 #include <utility>
@@ -170,6 +171,14 @@ class MessageHeader
         /// The buffer must have at least 30 bytes.
         static char* htdateCurrent(char* buffer);
 
+        /// Returns a properly formatted time-string of the given utc time, as needed in http.
+        /// The buffer must have at least 30 bytes.
+        static char* htdate(const DateTime& dt, char* buffer);
+
+        /// Parses a http time-string in rfc 1123 format.
+        /// Returns false if the string is not a valid date.
+        static bool parseHtdate(const std::string& s, DateTime& dt);
+
 };
 
 } // namespace http
@@ -41,13 +41,41 @@ class Request;
 
 class Reply
 {
+    public:
+        /** @brief Sends the body of a reply directly to the peer
+
+            This is implemented by the server connection, which owns the
+            reply. See Reply::beginStream.
+         */
+        class Streamer
+        {
+            public:
+                virtual ~Streamer() { }
+                virtual std::ostream& beginStream(Reply& reply) = 0;
+        };
+
+    private:
         ReplyHeader _header;
         std::stringstream _body;
+        int _fileFd;
+        std::size_t _fileOffset;
+        std::size_t _fileSize;
+        Streamer* _streamer;
+        std::ostream* _stream;
+
+        void closeBodyFile();
 
     public:
         Reply()
+            : _fileFd(-1),
+              _fileOffset(0),
+              _fileSize(0),
+              _streamer(0),
+              _stream(0)
             { }
 
+        ~Reply();
+
         ReplyHeader& header()
         { return _header; }
 
@@ -84,6 +112,8 @@ class Reply
             _header.clear();
             _body.clear();
             _body.str(std::string());
+            closeBodyFile();
+            _stream = 0;
         }
 
         unsigned httpReturnCode() const
@@ -101,8 +131,56 @@ class Reply
         std::stringstream& bodyStream()
         { return _body; }
 
-        std::size_t bodySize() const
-        { return _body.str().size(); }
+        std::size_t bodySize() const;
+
+        /** @brief Starts sending the body directly to the peer
+
+            The header of the reply is sent immediately, so it must be
+            complete before this is called. The body is then written to the
+            returned stream instead of the body stream. When a Content-Length
+            header is set, exactly that many bytes must be written. Otherwise
+            the body is sent with chunked transfer encoding, or for HTTP/1.0
+            clients until the connection is closed.
+
+            The stream has a buffer of fixed size and blocks when the peer
+            does not read fast enough, so the memory needed for a reply does
+            not grow with the size of the body. When the connection fails,
+            writing to the stream throws an exception.
+
+            If the reply is not attached to a server connection, the body
+            stream is returned and the body is sent as usual.
+         */
+        std::ostream& beginStream();
+
+        /// Returns true, if the body is sent using beginStream.
+        bool streaming() const
+        { return _stream != 0; }
+
+        /// Sets the object, which implements beginStream.
+        void streamer(Streamer* s)
+        { _streamer = s; }
+
+        /** @brief Sends a part of a file as body
+
+            The server sends \a size bytes from the open file descriptor
+            \a fd starting at \a offset instead of the body stream. It uses
+            sendfile(2) where possible, so that the data is not copied to
+            user space. The reply takes ownership of the file descriptor
+            and closes it when it is cleared or destroyed.
+         */
+        void bodyFile(int fd, std::size_t offset, std::size_t size);
+
+        bool hasBodyFile() const
+        { return _fileFd >= 0; }
+
+        int bodyFileFd() const
+        { return _fileFd; }
+
+        std::size_t bodyFileOffset() const
+        { return _fileOffset; }
+
+        std::size_t bodyFileSize() const
+        { return _fileSize; }
 
         void sendBody(std::ostream& out) const
         { out << _body.str(); }
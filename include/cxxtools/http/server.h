@@ -38,6 +38,7 @@ namespace cxxtools
 {
 
 class EventLoopBase;
+class EventLoopGroup;
 class SslCertificate;
 class SslCtx;
 class Regex;
@@ -53,13 +54,35 @@ class Server
 {
         Server(const Server& server) = delete;
         Server& operator=(const Server& server) = delete;
-        ServerImplBase* newImpl(EventLoopBase& eventLoop);
+    public:
+        /** How connections are processed.
+
+            In `WorkerThreads` mode, which is the default, each active
+            connection occupies a worker thread while it is read and replied.
+
+            In `EventLoops` mode, connections are owned by a few event loop
+            threads (see `ioThreads`), which read requests without blocking.
+            Only complete requests are passed to a pool of worker threads for
+            calling the responder. This scales to many thousands of idle
+            keep-alive connections.
+         */
+        enum ThreadingMode {
+          WorkerThreads,
+          EventLoops
+        };
+
+    private:
+        ServerImplBase* newImpl(EventLoopBase& eventLoop, ThreadingMode mode = WorkerThreads);
 
     public:
         explicit Server(EventLoopBase& eventLoop)
             : _impl(newImpl(eventLoop))
             { }
 
+        Server(EventLoopBase& eventLoop, ThreadingMode mode)
+            : _impl(newImpl(eventLoop, mode))
+            { }
+
         Server(EventLoopBase& eventLoop, const std::string& ip, unsigned short int port)
             : _impl(newImpl(eventLoop))
             { listen(ip, port); }
@@ -102,12 +125,49 @@ class Server
         void writeTimeout(Milliseconds ms);
         void keepAliveTimeout(Milliseconds ms);
 
+        /** Maximum size of a request body in `EventLoops` mode.
+
+            In `EventLoops` mode the body is read completely before the
+            request is passed to a worker thread. Requests with a larger
+            Content-Length are rejected with 413. 0 means no limit; the
+            default is 16 MB. In `WorkerThreads` mode the responder reads the
+            body itself and the size is not checked.
+         */
+        std::size_t maxRequestBodySize() const;
+        void maxRequestBodySize(std::size_t size);
+
         unsigned minThreads() const;
         void minThreads(unsigned m);
 
         unsigned maxThreads() const;
         void maxThreads(unsigned m);
 
+        /// Number of event loop threads in `EventLoops` mode.
+        /// Defaults to the number of cores and must be set before the server starts.
+        unsigned ioThreads() const;
+        void ioThreads(unsigned n);
+
+        /** Runs the connections in `EventLoops` mode on the loops of the given group.
+            The group may be shared by multiple servers and must outlive
+            them. It is started when the server starts and is not already
+            running. When no group is set, the server creates its own group
+            with `ioThreads` loops. It must be set before the server starts.
+         */
+        EventLoopGroup* eventLoopGroup() const;
+        void eventLoopGroup(EventLoopGroup& group);
+
+        /** Open multiple listeners per `listen` call with SO_REUSEPORT.
+
+            The kernel then distributes new connections between the
+            listeners, so that accepting does not serialize on a single
+            socket. In `EventLoops` mode each event loop gets its own
+            listener, in `WorkerThreads` mode one listener per minimum
+            number of threads is opened. It must be set before calling
+            `listen`.
+         */
+        bool reusePort() const;
+        void reusePort(bool sw);
+
         enum Runmode {
           Stopped,
           Starting,
@@ -75,6 +75,18 @@ inline IOS_OpenMode operator~(IOS_OpenMode a)
 
 class IODeviceImpl;
 
+/** @brief A memory area for vectored writes
+
+    A list of %IOVecs is passed to IODevice::writev or IODevice::beginWritev
+    to write several buffers with a single system call. The data is not
+    copied; the buffers are borrowed from the caller.
+*/
+struct IOVec
+{
+    const char* data;
+    size_t size;
+};
+
 /** @brief Endpoint for I/O operations
 
     This class serves as the base class for all kinds of I/O devices. The
@@ -148,6 +160,28 @@ class IODevice : public Selectable
          */
         size_t write(const char* buffer, size_t n);
 
+        /** @brief Starts writing a list of buffers asynchronously
+
+            Like beginWrite but gathers the data from \a count buffers. The
+            list and the buffers must stay valid until endWrite is called.
+            The list must not be empty. endWrite returns the total number
+            of bytes written, which may end within any of the buffers.
+         */
+        size_t beginWritev(const IOVec* vec, size_t count);
+
+        //! @brief Write a list of buffers to I/O device
+        /**
+            Writes the data from \a count buffers with a single operation
+            where the device supports it. Returns the total number of bytes
+            written, which may be less than requested.
+
+            \param vec list of buffers to be written.
+            \param count number of buffers in the list.
+            \return number of bytes written, which may be less than requested.
+            \throw IOError
+         */
+        size_t writev(const IOVec* vec, size_t count);
+
         /** @brief Cancels asynchronous reading and writing
         */
         void cancel();
@@ -259,6 +293,12 @@ class IODevice : public Selectable
         size_t wavail() const
         { return _wavail; }
 
+        const IOVec* wvec() const
+        { return _wvec; }
+
+        size_t wveclen() const
+        { return _wveclen; }
+
     protected:
         //! @brief Default Constructor
         IODevice();
@@ -277,6 +317,11 @@ class IODevice : public Selectable
         //! @brief Write bytes to device
         virtual size_t onWrite(const char* buffer, size_t count);
 
+        virtual size_t onBeginWritev(const IOVec* vec, size_t count);
+
+        //! @brief Write a list of buffers to device
+        virtual size_t onWritev(const IOVec* vec, size_t count);
+
         virtual void onClose();
 
         virtual void onCancel();
@@ -321,6 +366,8 @@ class IODevice : public Selectable
         const char* _wbuf;
         size_t _wbuflen;
         size_t _wavail;
+        const IOVec* _wvec;
+        size_t _wveclen;
 };
 
 } // namespace cxxtools
@@ -43,6 +43,11 @@ namespace net
     class AddrInfo;
 }
 
+namespace http
+{
+    class ClientPool;
+}
+
 namespace json
 {
 
@@ -132,6 +137,16 @@ namespace json
             void url(const std::string& url);
             void auth(const std::string& username, const std::string& password);
 
+            /** Uses connections from a pool for syncronous calls.
+
+                The connection is taken from the pool for each call and
+                returned afterwards, so that many clients can share a limited
+                number of keep alive connections to the server. Asyncronous
+                calls still use the own connection of the client. Passing a
+                null pointer disables the pool.
+             */
+            void clientPool(http::ClientPool* pool);
+
             void clearAuth();
 
             void setSelector(SelectorBase* selector);
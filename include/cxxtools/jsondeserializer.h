@@ -33,6 +33,7 @@
 #include <cxxtools/jsonparser.h>
 #include <cxxtools/textstream.h>
 #include <cxxtools/utf8codec.h>
+#include <memory>
 
 namespace cxxtools
 {
@@ -108,8 +109,34 @@ namespace cxxtools
             explicit JsonDeserializer(std::basic_istream<Char>& in);
 
             JsonDeserializer()
+                : _in(0),
+                  _byteIn(0)
             { }
 
+            /// Processes json data from the passed stream.
+            void read(std::istream& in, TextCodec<Char, char>* codec = new Utf8Codec());
+
+            /// Processes json data from the passed stream.
+            void read(std::basic_istream<Char>& in);
+
+            /** @brief Prepares reading the elements of a json array one by one.
+
+                The elements are fetched with next(). The stream must
+                stay valid until all elements are read.
+
+                @code
+                  cxxtools::JsonDeserializer deserializer;
+                  deserializer.beginStream(std::cin);
+                  Record record;
+                  while (deserializer.next(record))
+                      process(record);
+                @endcode
+             */
+            void beginStream(std::istream& in, TextCodec<Char, char>* codec = new Utf8Codec());
+
+            /// Prepares reading the elements of a json array one by one.
+            void beginStream(std::basic_istream<Char>& in);
+
             void begin();
 
             int advance(Char ch) // 1: end character detected; -1: end but char not consumed; 0: no end
@@ -118,8 +145,16 @@ namespace cxxtools
             void finish()
             { return _parser.finish(); }
 
+        protected:
+            bool readElement();
+
         private:
             JsonParser _parser;
+            std::basic_istream<Char>* _in;
+            std::istream* _byteIn;
+            std::unique_ptr<TextIStream> _textStream;
+
+            int parseUtf8(std::istream& in);
     };
 }
 
@@ -31,6 +31,7 @@
 
 #include <cxxtools/string.h>
 #include <cxxtools/serializationerror.h>
+#include <cxxtools/utf8codec.h>
 
 namespace cxxtools
 {
@@ -68,6 +69,9 @@ namespace cxxtools
             {
                     JsonParser* _jsonParser;
                     String _str;
+                    std::string _str8;
+                    bool _utf8;     // collect utf-8 in _str8 instead of _str
+                    bool _ascii;
                     unsigned _count;
                     unsigned short _value;
                     unsigned short _surrogateValue;
@@ -88,13 +92,16 @@ namespace cxxtools
                 public:
                     explicit JsonStringParser(JsonParser* jsonParser)
                         : _jsonParser(jsonParser),
+                          _utf8(false),
+                          _ascii(true),
                           _state(state_0)
                         { }
 
                     bool advance(Char ch);
+                    bool advance(const char*& p, const char* e);
 
                     void clear()
-                    { _state = state_0; _str.clear(); }
+                    { _state = state_0; _str.clear(); _str8.clear(); _utf8 = false; _ascii = true; }
 
                     const String& str() const
                     { return _str; }
@@ -102,8 +109,20 @@ namespace cxxtools
                     String&& str()
                     { return std::move(_str); }
 
-                    void str(String&& s)
-                    { _str = std::move(s); }
+                    // Returns the string utf-8 encoded.
+                    std::string str8()
+                    { return _utf8 ? std::move(_str8) : Utf8Codec::encode(_str); }
+
+                    void str8(std::string&& s)
+                    { _str8 = std::move(s); _utf8 = true; }
+
+                    // Returns true, when the string collected by the utf-8
+                    // parser has only ascii characters.
+                    bool ascii() const
+                    { return _ascii; }
+
+                private:
+                    void append(Char ch);
             };
 
             JsonParser(const JsonParser&) = delete;
@@ -117,10 +136,22 @@ namespace cxxtools
             {
                 _state = state_beforestart;
                 _token.clear();
+                _utf8Count = 0;
                 _deserializer = &handler;
             }
 
             int advance(Char ch); // 1: end character detected; -1: end but char not consumed; 0: no end
+
+            /** @brief Processes utf-8 encoded json data.
+
+                This is faster than passing the data character by character.
+                The pointer is moved behind the processed bytes. The return
+                value has the same meaning as in advance(Char). When 0 is
+                returned before the end of the data, the deserializer has
+                an element ready (see Deserializer::next).
+             */
+            int advance(const char*& p, const char* e);
+
             void finish();
 
         private:
@@ -151,13 +182,19 @@ namespace cxxtools
                 state_end
             } _state, _nextState;
 
-            String _token;
+            std::string _token;
 
             JsonDeserializer* _deserializer;
             JsonStringParser _stringParser;
             JsonParser* _next;
             unsigned _lineNo;
+            unsigned _utf8Count;
+            char32_t _utf8Value;
+            char32_t _utf8Min;      // smallest value, which needs the sequence length
 
+            int step(Char ch);
+            int parse(const char*& p, const char* e);
+            bool nextChar(const char*& p, const char* e, Char& ch);
             void doThrow(const std::string& msg);
             void throwInvalidCharacter(Char ch);
     };
@@ -271,6 +271,12 @@ namespace cxxtools
 
       typedef Logger::log_level_type log_level_type;
 
+      /// What happens, when the buffer of asynchronous logging is full.
+      enum OverflowPolicy {
+        OverflowBlock,  // wait until the writer thread made room
+        OverflowDrop    // discard the message and count it
+      };
+
       LogConfiguration();
       LogConfiguration(const LogConfiguration&);
       LogConfiguration& operator=(const LogConfiguration&);
@@ -306,6 +312,35 @@ namespace cxxtools
       void setStdout();
       void setStderr();
       void setLogFormat(const LogFormat& logFormat);
+
+      /**
+       Enables asynchronous logging.
+
+       Formatted messages are passed through a ring buffer of bufferSize
+       messages to a background thread, which writes them to the file,
+       console or loghost. Logging threads do not wait for the output
+       unless the buffer is full and the policy is OverflowBlock. Fatal
+       messages and program exit flush the buffer.
+
+       The buffer size is used when asynchronous logging is enabled the
+       first time.
+       */
+      void setAsync(bool sw, unsigned bufferSize = 8192, OverflowPolicy overflow = OverflowBlock);
+
+      /**
+       Enables binary log files.
+
+       Instead of text lines compact records are written to the log file.
+       Level, category and the constant text of a message are written only
+       once and referenced by id; numbers are stored unformatted. The tool
+       cxxlogdecode converts the file to the usual text format.
+
+       Only integers and doubles with default formatting are stored as
+       arguments; everything else becomes part of the message text.
+       Binary logging applies to file output only. Rolling files are not
+       supported, but file name patterns are.
+       */
+      void setBinary(bool sw = true);
   };
 
   void operator>>= (const SerializationInfo& si, LogConfiguration& logConfiguration);
@@ -350,6 +385,12 @@ namespace cxxtools
 
       int rootFlags() const;
       int logFlags(const std::string& category) const;
+
+      /// Waits until all messages of asynchronous logging are written.
+      void flush();
+
+      /// Returns the number of messages discarded by asynchronous logging because the buffer was full.
+      unsigned long droppedMessages() const;
   };
 
   //////////////////////////////////////////////////////////////////////
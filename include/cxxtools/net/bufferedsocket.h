@@ -32,6 +32,7 @@
 #include <cxxtools/net/tcpsocket.h>
 #include <cxxtools/connectable.h>
 #include <cxxtools/destructionsentry.h>
+#include <cxxtools/callable.h>
 #include <vector>
 #include <exception>
 
@@ -55,6 +56,9 @@ namespace net
     arrives. The data is not discarded after signalling inputReady.
 
     Writing is done in the background. More data can be added always if needed.
+    Large buffers can be passed with writeBorrowed, which writes them
+    together with the output buffer using vectored writes instead of
+    copying them.
 
     Note that the bufferes are not discarded when the socket is disconnected.
     After connecting the write operation is not resumed but must be manually
@@ -68,12 +72,25 @@ class BufferedSocket : public TcpSocket, public Connectable
     std::vector<char> _inputBuffer;
     std::vector<char> _outputBuffer;
     std::vector<char> _outputBufferNext;
+
+    struct Borrowed
+    {
+        const char* data;
+        size_t size;
+        size_t pos;     // number of buffered bytes written before the data
+        Callable<void>* released;
+    };
+
+    std::vector<Borrowed> _borrowed;
+    std::vector<IOVec> _outputVec;
     DestructionSentry* _sentry = nullptr;
     std::exception_ptr _inputException;
 
     void onInput(IODevice&);
     size_t onEndRead(bool& eof) override;
     void onOutput(IODevice&);
+    void consumeOutput(size_t count);
+    void releaseBorrowed(size_t count);
 
 
 public:
@@ -112,6 +129,22 @@ public:
      */
     BufferedSocket& write(const std::string& buffer, bool begin = true)    { return write(buffer.data(), buffer.size(), begin); }
 
+    /** Adds data to the output without copying it.
+
+        The data is written after the data already added and before
+        anything added later. It must stay valid until it is written
+        completely or discarded.
+     */
+    BufferedSocket& writeBorrowed(const char* buffer, size_t n, bool begin = true);
+
+    /** Adds data to the output without copying it.
+
+        The callable `released` is called, when the socket does not refer
+        to the data any more, i.e. when it is written, discarded by
+        cancel or the socket is destroyed.
+     */
+    BufferedSocket& writeBorrowed(const char* buffer, size_t n, const Callable<void>& released, bool begin = true);
+
     /** Returns a output buffer, where user can add data to.
 
         This gives direct access to the buffer, which may reduce copy operations.
@@ -145,8 +178,8 @@ public:
     /// Cancels reading and writing operations and discards buffers.
     void cancel();
 
-    /// Returns the number of bytes in the output buffer, which are not yet written
-    unsigned outputSize() const         { return _outputBuffer.size() + _outputBufferNext.size(); }
+    /// Returns the number of bytes in the output buffer and borrowed buffers, which are not yet written
+    unsigned outputSize() const;
 
     /** Returns the input buffer.
 
@@ -66,7 +66,15 @@ namespace net
     class TcpServerImpl* _impl;
 
     public:
-      enum { INHERIT = 1, DEFER_ACCEPT = 2, REUSEADDR = 4 };
+      /** @brief Flags for listen
+
+          REUSEPORT allows multiple sockets to listen on the same address and
+          port. The kernel then distributes incoming connections between
+          them, so that each accepting thread can have its own listener.
+          It is ignored where the system does not support SO_REUSEPORT; a
+          second listener on the same port fails then with AddressInUse.
+       */
+      enum { INHERIT = 1, DEFER_ACCEPT = 2, REUSEADDR = 4, REUSEPORT = 8 };
 
       TcpServer();
 
@@ -139,6 +139,19 @@ class TcpSocket : public IODevice
         /// blocking call to terminate ssl
         void sslShutdown();
 
+        /** @brief Starts sending a part of a file asynchronously
+
+            Sends up to \a n bytes from the file descriptor \a fd starting
+            at \a offset. Like with beginWrite, outputReady is signaled when
+            the operation can be finished and endWrite returns the number of
+            bytes sent, which may be less than requested.
+
+            On plain connections the data is sent with sendfile(2) without
+            copying it to user space. On ssl connections the next part of
+            the file is read into a buffer and written.
+         */
+        size_t beginSendFile(int fd, size_t offset, size_t n);
+
     protected:
         TcpSocket(TcpSocketImpl* impl)
         : _impl(impl)
@@ -150,6 +163,9 @@ class TcpSocket : public IODevice
         // inherit doc
         virtual size_t onBeginWrite(const char* buffer, size_t n);
 
+        // inherit doc
+        virtual size_t onBeginWritev(const IOVec* vec, size_t count);
+
     public:
         // inherit doc
         virtual SelectableImpl& simpl();
@@ -33,12 +33,91 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <string>
+#include <vector>
+
+struct mmsghdr;
 
 namespace cxxtools
 {
 
 namespace net
 {
+  /**
+   * Reusable buffers for sending or receiving multiple datagrams with one
+   * system call.
+   *
+   * The batch holds up to `capacity` datagrams of up to `maxSize` bytes each.
+   * The memory is allocated once in the constructor, so that receiving into
+   * and sending from a batch do not allocate.
+   */
+  class UdpBatch
+  {
+      friend class UdpSender;
+      friend class UdpReceiver;
+
+    public:
+      typedef size_t size_type;
+
+    private:
+      unsigned _capacity;
+      size_type _maxSize;
+      unsigned _size;
+      std::vector<char> _data;
+      std::vector<size_type> _length;
+      std::vector<char> _truncated;
+      std::vector<struct sockaddr_storage> _peer;
+      std::vector<socklen_t> _peerLen;
+      mutable std::vector<struct iovec> _iov;
+      struct mmsghdr* _msgs;
+
+      UdpBatch(const UdpBatch&) = delete;
+      UdpBatch& operator=(const UdpBatch&) = delete;
+
+    public:
+      explicit UdpBatch(unsigned capacity = 64, size_type maxSize = 65507);
+      ~UdpBatch();
+
+      /// Returns the maximum number of datagrams in the batch.
+      unsigned capacity() const      { return _capacity; }
+      /// Returns the maximum size of a datagram.
+      size_type maxSize() const      { return _maxSize; }
+
+      /// Returns the number of datagrams in the batch.
+      unsigned size() const          { return _size; }
+      bool empty() const             { return _size == 0; }
+      bool full() const              { return _size >= _capacity; }
+
+      /// Removes all datagrams from the batch.
+      void clear()                   { _size = 0; }
+
+      /// Appends a copy of the message to the batch.
+      /// Throws std::length_error when the batch is full or the message
+      /// is larger than `maxSize`.
+      void add(const void* message, size_type length);
+      void add(const std::string& message)
+        { add(message.data(), message.size()); }
+
+      /// Appends a datagram of `length` bytes and returns a pointer to its
+      /// data so that the message can be written directly into the batch.
+      char* add(size_type length);
+
+      /// Returns the data of the n-th datagram.
+      const char* data(unsigned n) const   { return &_data[n * _maxSize]; }
+      char* data(unsigned n)               { return &_data[n * _maxSize]; }
+      /// Returns the length of the n-th datagram.
+      size_type length(unsigned n) const   { return _length[n]; }
+      /// Returns a copy of the n-th datagram.
+      std::string str(unsigned n) const    { return std::string(data(n), length(n)); }
+      /// Returns true, when the n-th received datagram was longer than
+      /// `maxSize`. Only the first `maxSize` bytes were received then.
+      bool truncated(unsigned n) const     { return _truncated[n] != 0; }
+
+      /// Returns the address of the sender of the n-th received datagram.
+      std::string peerAddr(unsigned n) const;
+  };
+
   class UdpSender : public Socket
   {
       bool connected;
@@ -59,6 +138,16 @@ namespace net
       size_type send(const std::string& message, int flags = 0) const;
       size_type recv(void* buffer, size_type length, int flags = 0) const;
       std::string recv(size_type length, int flags = 0) const;
+
+      /// Sends all datagrams of the batch and returns the number of
+      /// datagrams sent.
+      unsigned send(const UdpBatch& batch, int flags = 0) const;
+
+      /// Receives up to `batch.capacity()` datagrams into the batch.
+      /// Waits for the first datagram and returns the number of datagrams
+      /// received. Datagrams longer than `batch.maxSize()` are truncated
+      /// and marked with `batch.truncated(n)`.
+      unsigned recv(UdpBatch& batch, int flags = 0) const;
   };
 
   class UdpReceiver : public Socket
@@ -78,6 +167,17 @@ namespace net
       std::string recv(size_type length, int flags = 0);
       size_type send(const void* message, size_type length, int flags = 0) const;
       size_type send(const std::string& message, int flags = 0) const;
+
+      /// Receives up to `batch.capacity()` datagrams into the batch.
+      /// Waits for the first datagram and returns the number of datagrams
+      /// received. The sender of each datagram is kept in the batch.
+      /// Datagrams longer than `batch.maxSize()` are truncated and marked
+      /// with `batch.truncated(n)`.
+      unsigned recv(UdpBatch& batch, int flags = 0);
+
+      /// Sends each datagram of the batch back to the peer it was received
+      /// from and returns the number of datagrams sent.
+      unsigned send(const UdpBatch& batch, int flags = 0) const;
   };
 
 } // namespace net
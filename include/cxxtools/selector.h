@@ -32,7 +32,8 @@
 
 #include <cxxtools/timespan.h>
 #include <cxxtools/connectable.h>
-#include <map>
+#include <vector>
+#include <cstddef>
 
 namespace cxxtools {
 
@@ -86,6 +87,20 @@ namespace cxxtools {
         public:
             static const int WaitInfinite = -1;
 
+            /** @brief The system interface used to wait for activity
+
+                The DefaultBackend uses epoll where available. It can be
+                overridden by setting the environment variable
+                CXXTOOLS_SELECTOR to "poll" or "epoll". When epoll is not
+                available, poll is used as a fallback.
+             */
+            enum Backend
+            {
+                DefaultBackend,
+                PollBackend,
+                EpollBackend
+            };
+
             //! @brief Destructor
             virtual ~SelectorBase();
 
@@ -214,19 +229,41 @@ namespace cxxtools {
             bool updateTimer(Timespan& timeout);
 
             //! @internal
-            typedef std::multimap<Timespan, Timer*> TimerMap;
+            void pushTimer(Timer& timer);
+
+            //! @internal
+            void eraseTimer(std::size_t idx);
+
+            //! @internal
+            void siftUpTimer(std::size_t idx);
 
             //! @internal
-            TimerMap _timers;
+            void siftDownTimer(std::size_t idx);
+
+            //! @internal
+            static const std::size_t noTimerIndex = static_cast<std::size_t>(-1);
+
+            /** @internal Active timers as a binary heap ordered by expiry
+
+                Each timer knows its position in the heap, so that it can be
+                removed or moved in O(log n).
+             */
+            std::vector<Timer*> _timers;
+
+            //! @internal Timer, which is updated and not in the heap
+            Timer* _updating;
     };
 
     class Selector : public SelectorBase
     {
         public:
-            Selector();
+            explicit Selector(Backend backend = DefaultBackend);
 
             virtual ~Selector();
 
+            /// Returns the backend actually used by this selector.
+            Backend backend() const;
+
             SelectorImpl& impl();
 
         protected:
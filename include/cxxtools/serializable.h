@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_SERIALIZABLE_H
+#define CXXTOOLS_SERIALIZABLE_H
+
+#include <cxxtools/serializationinfo.h>
+#include <cxxtools/decomposer.h>
+
+namespace cxxtools
+{
+    /** @brief Looks up the members of an object in serialization order.
+
+        Members are expected in the order, in which they were serialized.
+        When the next member has the requested name, it is returned without
+        a lookup. Otherwise the member is searched by name.
+
+        This is used by the operators generated by CXXTOOLS_SERIALIZABLE.
+     */
+    class MemberCursor
+    {
+            const SerializationInfo& _si;
+            SerializationInfo::ConstIterator _it;
+            SerializationInfo::ConstIterator _end;
+
+        public:
+            explicit MemberCursor(const SerializationInfo& si)
+                : _si(si),
+                  _it(si.begin()),
+                  _end(si.end())
+            { }
+
+            /** @brief Returns the member with the passed name.
+
+                @throws SerializationMemberNotFound when the member is missing.
+             */
+            const SerializationInfo& get(const std::string& name)
+            {
+                if (_it != _end && _it->name() == name)
+                    return *_it++;
+
+                return _si.getMember(name);
+            }
+    };
+}
+
+/** @brief Generates the serialization operators for a struct.
+
+    The macro takes the type and the names of the data members to serialize.
+    It defines operator<<=, operator>>= and formatValue, so it must be used
+    in the namespace of the type. The members get their variable names.
+
+    @code
+      namespace app
+      {
+          struct Customer
+          {
+              std::string name;
+              int age;
+              std::vector<std::string> phones;
+          };
+
+          CXXTOOLS_SERIALIZABLE(Customer, name, age, phones)
+      }
+    @endcode
+
+    Up to 64 members are supported.
+ */
+#define CXXTOOLS_SERIALIZABLE(Type, ...) \
+    inline void operator<<= (cxxtools::SerializationInfo& si, const Type& obj) \
+    { \
+        CXXTOOLS_SERIALIZABLE_FOR_EACH(CXXTOOLS_SERIALIZABLE_ADD, __VA_ARGS__) \
+        si.setTypeName(#Type); \
+    } \
+    inline void operator>>= (const cxxtools::SerializationInfo& si, Type& obj) \
+    { \
+        cxxtools::MemberCursor cursor(si); \
+        CXXTOOLS_SERIALIZABLE_FOR_EACH(CXXTOOLS_SERIALIZABLE_GET, __VA_ARGS__) \
+    } \
+    inline void formatValue(cxxtools::Formatter& formatter, const std::string& name, const Type& obj) \
+    { \
+        formatter.beginObject(name, #Type); \
+        CXXTOOLS_SERIALIZABLE_FOR_EACH(CXXTOOLS_SERIALIZABLE_FORMAT, __VA_ARGS__) \
+        formatter.finishObject(); \
+    }
+
+// implementation details of CXXTOOLS_SERIALIZABLE
+
+#define CXXTOOLS_SERIALIZABLE_NAME(field) \
+    static const std::string field ## _cxxtools_name(#field);
+
+#define CXXTOOLS_SERIALIZABLE_ADD(field) \
+    { CXXTOOLS_SERIALIZABLE_NAME(field) si.addMember(field ## _cxxtools_name) <<= obj.field; }
+
+#define CXXTOOLS_SERIALIZABLE_GET(field) \
+    { CXXTOOLS_SERIALIZABLE_NAME(field) cursor.get(field ## _cxxtools_name) >>= obj.field; }
+
+#define CXXTOOLS_SERIALIZABLE_FORMAT(field) \
+    { CXXTOOLS_SERIALIZABLE_NAME(field) cxxtools::formatMember(formatter, field ## _cxxtools_name, obj.field); }
+
+#define CXXTOOLS_SERIALIZABLE_COUNT(...) \
+    CXXTOOLS_SERIALIZABLE_COUNT_N(__VA_ARGS__, 64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+#define CXXTOOLS_SERIALIZABLE_COUNT_N(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, _40, _41, _42, _43, _44, _45, _46, _47, _48, _49, _50, _51, _52, _53, _54, _55, _56, _57, _58, _59, _60, _61, _62, _63, _64, N, ...) N
+
+#define CXXTOOLS_SERIALIZABLE_CONCAT(a, b) CXXTOOLS_SERIALIZABLE_CONCAT_(a, b)
+#define CXXTOOLS_SERIALIZABLE_CONCAT_(a, b) a ## b
+
+#define CXXTOOLS_SERIALIZABLE_FOR_EACH(m, ...) \
+    CXXTOOLS_SERIALIZABLE_CONCAT(CXXTOOLS_SERIALIZABLE_FE_, CXXTOOLS_SERIALIZABLE_COUNT(__VA_ARGS__))(m, __VA_ARGS__)
+
+#define CXXTOOLS_SERIALIZABLE_FE_1(m, x) m(x)
+#define CXXTOOLS_SERIALIZABLE_FE_2(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_1(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_3(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_2(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_4(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_3(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_5(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_4(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_6(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_5(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_7(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_6(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_8(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_7(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_9(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_8(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_10(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_9(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_11(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_10(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_12(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_11(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_13(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_12(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_14(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_13(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_15(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_14(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_16(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_15(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_17(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_16(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_18(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_17(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_19(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_18(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_20(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_19(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_21(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_20(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_22(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_21(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_23(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_22(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_24(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_23(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_25(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_24(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_26(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_25(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_27(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_26(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_28(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_27(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_29(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_28(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_30(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_29(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_31(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_30(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_32(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_31(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_33(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_32(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_34(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_33(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_35(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_34(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_36(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_35(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_37(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_36(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_38(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_37(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_39(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_38(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_40(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_39(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_41(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_40(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_42(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_41(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_43(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_42(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_44(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_43(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_45(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_44(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_46(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_45(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_47(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_46(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_48(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_47(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_49(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_48(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_50(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_49(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_51(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_50(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_52(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_51(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_53(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_52(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_54(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_53(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_55(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_54(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_56(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_55(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_57(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_56(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_58(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_57(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_59(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_58(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_60(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_59(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_61(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_60(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_62(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_61(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_63(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_62(m, __VA_ARGS__)
+#define CXXTOOLS_SERIALIZABLE_FE_64(m, x, ...) m(x) CXXTOOLS_SERIALIZABLE_FE_63(m, __VA_ARGS__)
+
+#endif // CXXTOOLS_SERIALIZABLE_H
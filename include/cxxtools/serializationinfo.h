@@ -30,6 +30,7 @@
 #define cxxtools_SerializationInfo_h
 
 #include <cxxtools/string.h>
+#include <cxxtools/arena.h>
 #include <vector>
 #include <set>
 #include <map>
@@ -43,6 +44,7 @@
 #include <array>
 #include <type_traits>
 #include <iosfwd>
+#include <cstdint>
 
 #include <cxxtools/config.h>
 
@@ -74,6 +76,12 @@ namespace cxxtools
     SerializationInfo and a deserialization operator is used to convert the
     SerializationInfo back to the desired object.
 
+    The member nodes of a tree may be placed in an Arena (see `setArena`).
+    Then a large tree does not need many small heap allocations and the
+    memory is released at once by clearing the arena. The tree must be
+    destroyed before the arena is cleared. Copies of the tree do not use the
+    arena.
+
     To serialize and deserialize a object, those operators are needed.
     For all standard types there are predefined operators. For user types
     like own classes a operator can easily be written. The signature is
@@ -109,7 +117,16 @@ namespace cxxtools
 
 class SerializationInfo
 {
-        typedef std::deque<SerializationInfo> Nodes;
+        typedef std::deque<SerializationInfo, ArenaAllocator<SerializationInfo> > Nodes;
+
+        // Maps member names to the position of the first member with that
+        // name.
+        struct MemberIndex
+        {
+            std::unordered_map<std::string, unsigned> positions;
+            Nodes* nodes;
+        };
+
         friend void operator <<=(SerializationInfo& si, const SerializationInfo& ssi);
 
     public:
@@ -141,6 +158,9 @@ class SerializationInfo
     public:
         SerializationInfo();
 
+        /// Creates an empty SerializationInfo, which places its members into the passed arena.
+        explicit SerializationInfo(Arena* arena);
+
         SerializationInfo(const SerializationInfo& si);
 
         ~SerializationInfo();
@@ -156,6 +176,21 @@ class SerializationInfo
             return _category;
         }
 
+        /** @brief Sets the arena, where members are allocated from
+
+            The arena is used for members added afterwards and is inherited by
+            them. Passing a null pointer makes new members use the heap.
+         */
+        void setArena(Arena* arena)
+        {
+            _arena = arena;
+        }
+
+        Arena* arena() const
+        {
+            return _arena;
+        }
+
         void setCategory(Category cat)
         {
             _category = cat;
@@ -163,36 +198,36 @@ class SerializationInfo
 
         const std::string& typeName() const
         {
-            return _type;
+            return _type.str();
         }
 
         void setTypeName(const std::string& type)
         {
-            _type = type;
+            _type.assign(type);
             if (_category == Void)
                 _category = Object;
         }
 
         void setTypeName(std::string&& type)
         {
-            _type = std::move(type);
-            if (_category == Void)
-                _category = Object;
+            setTypeName(static_cast<const std::string&>(type));
         }
 
         const std::string& name() const
         {
-            return _name;
+            return _name.str();
         }
 
         void setName(const std::string& name)
         {
-            _name = name;
+            _name.assign(name);
+            _nameChanged();
         }
 
         void setName(std::string&& name)
         {
-            _name = std::move(name);
+            _name.assign(name);
+            _nameChanged();
         }
 
         /** @brief Serialization of flat data-types
@@ -407,9 +442,80 @@ class SerializationInfo
         void dump(std::ostream& out, const std::string& prefix = std::string()) const;
 
     private:
-        Category _category;
-        std::string _name;
-        std::string _type;
+        // Name or type name of a node.
+        //
+        // Names are interned in a global symbol table, so that a node just
+        // holds a pointer and names are compared by address. To keep the
+        // table small with arbitrary input, only a limited number of short
+        // names are interned. Other names are owned by the node, which is
+        // marked in the lowest bit of the pointer.
+        class Symbol
+        {
+                std::uintptr_t _p;
+
+                static const std::string _empty;
+
+                bool owned() const
+                { return _p & 1; }
+
+                const std::string* ptr() const
+                { return reinterpret_cast<const std::string*>(_p & ~static_cast<std::uintptr_t>(1)); }
+
+            public:
+                Symbol() noexcept
+                    : _p(0)
+                { }
+
+                Symbol(const Symbol& s);
+
+                Symbol(Symbol&& s) noexcept
+                    : _p(s._p)
+                { s._p = 0; }
+
+                ~Symbol()
+                { clear(); }
+
+                Symbol& operator=(const Symbol& s)
+                {
+                    Symbol(s).swap(*this);
+                    return *this;
+                }
+
+                Symbol& operator=(Symbol&& s) noexcept
+                {
+                    swap(s);
+                    return *this;
+                }
+
+                void swap(Symbol& s) noexcept
+                { std::swap(_p, s._p); }
+
+                void assign(const std::string& s);
+
+                void clear()
+                {
+                    if (owned())
+                        delete ptr();
+                    _p = 0;
+                }
+
+                bool empty() const
+                { return _p == 0; }
+
+                const std::string& str() const
+                { return _p ? *ptr() : _empty; }
+
+                // Returns true, when this is the passed interned symbol.
+                bool is(const std::string* sym) const
+                { return _p == reinterpret_cast<std::uintptr_t>(sym); }
+
+                // Returns the interned symbol or null, when the string is not
+                // known to the calling thread.
+                static const std::string* lookup(const std::string& s);
+        };
+
+        Symbol _name;
+        Symbol _type;
 
         void _releaseValue();
         void _setString(String&& value);
@@ -433,9 +539,23 @@ class SerializationInfo
         long double _getLongDouble() const;
         Nodes& nodes();
         const Nodes& nodes() const;
+        void _deleteNodes();
         // assignment without name
         void assignData(const SerializationInfo& si);
 
+        // name index of large objects
+        void _updateIndex();
+        void _dropIndex();
+        const SerializationInfo* _findMember(const std::string& name) const;
+        static void _rebuildIndex(MemberIndex& index);
+
+        // keeps the index of the parent up to date, when a member is renamed
+        void _nameChanged()
+        {
+            if (_memberOf)
+                _rebuildIndex(*_memberOf);
+        }
+
         union U
         {
             char _s[sizeof(String) >= sizeof(std::string) ? sizeof(String) : sizeof(std::string)];
@@ -472,15 +592,39 @@ class SerializationInfo
           t_double,
           t_ldouble
         } _t;
+        Category _category;
 
         Nodes* _nodes;             // objects/arrays
+
+        // Name index of the members. It is created by addMember when the
+        // object grows beyond a threshold and covers all members except the
+        // last one, which may still be renamed by the caller of addMember.
+        MemberIndex* _index;
+
+        // index of the parent, which covers this member
+        MemberIndex* _memberOf;
+
+        Arena* _arena;
 };
 
 
 inline SerializationInfo::SerializationInfo()
-: _category(Void),
-  _t(t_none),
-  _nodes(0)
+: _t(t_none),
+  _category(Void),
+  _nodes(0),
+  _index(0),
+  _memberOf(0),
+  _arena(0)
+{ }
+
+
+inline SerializationInfo::SerializationInfo(Arena* arena)
+: _t(t_none),
+  _category(Void),
+  _nodes(0),
+  _index(0),
+  _memberOf(0),
+  _arena(arena)
 { }
 
 
@@ -30,6 +30,7 @@
 #define CXXTOOLS_SSLCTX_H
 
 #include <string>
+#include <cxxtools/timespan.h>
 
 namespace cxxtools
 {
@@ -48,6 +49,10 @@ class SerializationInfo;
     state even after using network classes. Note that ssl cannot be enabled
     later that way since a disabled state do not reference anything.
 
+    Ssl sessions are cached so that reconnects can skip the full handshake.
+    Client connections remember the last session per host and port, server
+    connections use the internal cache of openssl and session tickets.
+
  */
 class SslCtx
 {
@@ -129,6 +134,31 @@ public:
     /** Sets allowed ciphers. See openssl documentation for syntax. */
     SslCtx& setCiphers(const std::string& ciphers);
 
+    /** Sets the maximum number of cached ssl sessions.
+
+        The size limits the server side cache and the number of peers, to
+        which client sessions are remembered. 0 disables the session cache.
+     */
+    SslCtx& setSessionCacheSize(unsigned n);
+
+    /** Sets the time, after which cached sessions expire. */
+    SslCtx& setSessionTimeout(Timespan timeout);
+
+    /** Enables rotation of the keys used to encrypt session tickets.
+
+        A new key is generated when the current one is older than the passed
+        lifetime. Tickets encrypted with the previous key are still accepted
+        but replaced with a new one. By default openssl uses a single key
+        for the lifetime of the context.
+     */
+    SslCtx& setTicketKeyLifetime(Timespan lifetime);
+
+    /** Returns the number of handshakes, which resumed a previous session. */
+    unsigned long sessionHits() const;
+
+    /** Returns the number of full handshakes. */
+    unsigned long sessionMisses() const;
+
     /** return standard ctx with low security */
     static SslCtx standard() { return SslCtx().enable(); }
 
@@ -31,6 +31,8 @@
 #include <ios>
 #include <streambuf>
 #include <cxxtools/iodevice.h>
+#include <cxxtools/callable.h>
+#include <vector>
 
 namespace cxxtools
 {
@@ -136,6 +138,30 @@ class StreamBuffer : public BasicStreamBuffer<char>,
         bool writing() const
             { return _ioDevice && _ioDevice->writing(); }
 
+        /** Appends data to the output without copying it.
+         *
+         *  The data is written after the output already in the buffer and
+         *  before anything put into the stream buffer later. Borrowed
+         *  buffers are passed to the device together with the buffered
+         *  output in a single vectored write.
+         *
+         *  The data must stay valid until it is written completely or
+         *  discarded.
+         */
+        void writeBorrowed(const char* data, size_t size);
+
+        /** Appends data to the output without copying it.
+         *
+         *  The callable \a released is called when the stream buffer does
+         *  not refer to the data any more, i.e. when it is written
+         *  completely, discarded or the stream buffer is destroyed.
+         */
+        void writeBorrowed(const char* data, size_t size, const Callable<void>& released);
+
+        /** Returns the number of borrowed bytes not yet written.
+         */
+        size_t borrowedAvail() const;
+
         /** Empties the data in the buffer.
          *
          *  The device must not be in reading or writing mode.  A exception of
@@ -175,6 +201,22 @@ class StreamBuffer : public BasicStreamBuffer<char>,
 
         void onWrite(IODevice& dev);
 
+        void fillOutputVec();
+
+        size_t writeOutput();
+
+        void consumeOutput(size_t n);
+
+        void releaseBorrowed(size_t count);
+
+        struct Borrowed
+        {
+            const char* data;
+            size_t size;
+            size_t pos;     // offset in the output buffer, where the data is inserted
+            Callable<void>* released;
+        };
+
     private:
         IODevice* _ioDevice;
         size_t _ibufferSize;
@@ -183,6 +225,8 @@ class StreamBuffer : public BasicStreamBuffer<char>,
         char* _obuffer;
         const size_t _pbmax;
         bool _oextend;
+        std::vector<Borrowed> _oborrowed;
+        std::vector<IOVec> _ovec;
 };
 
 } // namespace cxxtools
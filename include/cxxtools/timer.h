@@ -69,6 +69,7 @@ namespace cxxtools {
     */
     class Timer
     {
+        friend class SelectorBase;
         class Sentry;
 
         public:
@@ -198,6 +199,8 @@ namespace cxxtools {
             Timespan      _interval;
             Timespan      _finished;
             bool          _once;
+            // position in the timer heap of the selector
+            std::size_t   _heapIndex;
     };
 
 }
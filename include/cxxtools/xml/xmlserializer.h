@@ -143,10 +143,7 @@ class XmlSerializer
         template <typename T>
         void serialize(const T& type, const std::string& name)
         {
-            Decomposer<T> decomposer;
-            decomposer.begin(type);
-            decomposer.setName(name);
-            decomposer.format(_formatter);
+            formatDirect(_formatter, name, type);
             _formatter.finish();
             _formatter.flush();
         }
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/arena.h>
+#include <cxxtools/log.h>
+
+log_define("cxxtools.arena")
+
+namespace cxxtools
+{
+
+void* Arena::allocateBlock(std::size_t size, std::size_t align)
+{
+    std::size_t needed = sizeof(Block) + size + align;
+
+    // reuse the next block if it is large enough
+    Block* block = _current ? _current->next : _first;
+    if (block == 0 || block->size < needed)
+    {
+        std::size_t blockSize = needed > _blockSize ? needed : _blockSize;
+        log_debug("allocate block of " << blockSize << " bytes");
+
+        Block* newBlock = static_cast<Block*>(::operator new(blockSize));
+        newBlock->next = block;
+        newBlock->size = blockSize;
+
+        if (_current)
+            _current->next = newBlock;
+        else
+            _first = newBlock;
+
+        block = newBlock;
+    }
+
+    _current = block;
+    _ptr = reinterpret_cast<char*>(block + 1);
+    _end = reinterpret_cast<char*>(block) + block->size;
+
+    return allocate(size, align);
+}
+
+void Arena::clear()
+{
+    _current = 0;
+    _ptr = 0;
+    _end = 0;
+}
+
+void Arena::release()
+{
+    while (_first)
+    {
+        Block* next = _first->next;
+        ::operator delete(_first);
+        _first = next;
+    }
+
+    clear();
+}
+
+std::size_t Arena::capacity() const
+{
+    std::size_t ret = 0;
+    for (Block* block = _first; block; block = block->next)
+        ret += block->size;
+    return ret;
+}
+
+}
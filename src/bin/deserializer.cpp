@@ -41,6 +41,7 @@ namespace bin
 {
 
 Deserializer::Deserializer(const char* data, size_t size)
+    : _in(0)
 {
     begin();
 
@@ -84,6 +85,31 @@ void Deserializer::read(std::streambuf& in)
     }
 }
 
+void Deserializer::beginStream(std::streambuf& in)
+{
+    cxxtools::Deserializer::beginStream();
+    _parser.begin(*this);
+    _in = &in;
+}
+
+bool Deserializer::readElement()
+{
+    while (_in->sgetc() != std::streambuf::traits_type::eof())
+    {
+        if (_parser.advance(*_in, true))
+        {
+            _parser.finish();
+            return true;
+        }
+
+        if (elementReady())
+            return false;
+    }
+
+    SerializationError::doThrow("binary deserialization failed - unexpected eof");
+    return true;
+}
+
 void Deserializer::begin(bool resetDictionary)
 {
     cxxtools::Deserializer::begin();
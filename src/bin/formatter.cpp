@@ -93,10 +93,11 @@ void Formatter::format(const SerializationInfo& si)
     IDecomposer::formatEach(si, *this);
 }
 
-void Formatter::begin(std::streambuf& out)
+void Formatter::begin(std::streambuf& out, bool resetDictionary)
 {
     _out = &out;
-    _dictionary.clear();
+    if (resetDictionary)
+        _dictionary.clear();
 }
 
 void Formatter::finish()
@@ -876,23 +877,21 @@ void Formatter::outputString(const std::string& value)
         return;
     }
 
-    unsigned idx;
-    for (idx = 0; idx < _dictionary.size(); ++idx)
+    auto it = _dictionary.find(value);
+    if (it != _dictionary.end())
     {
-        if (_dictionary[idx] == value)
-        {
-            log_debug("use dictionary value \"" << value << "\" idx=" << idx);
-            _out->sputc('\1');
-            _out->sputc(static_cast<char>(idx >> 8));
-            _out->sputc(static_cast<char>(idx));
-            return;
-        }
+        unsigned idx = it->second;
+        log_debug("use dictionary value \"" << value << "\" idx=" << idx);
+        _out->sputc('\1');
+        _out->sputc(static_cast<char>(idx >> 8));
+        _out->sputc(static_cast<char>(idx));
+        return;
     }
 
     if (_dictionary.size() <= 0xffff)
     {
         log_debug("add dictionary value \"" << value << "\" idx=" << _dictionary.size());
-        _dictionary.push_back(value);
+        _dictionary.emplace(value, _dictionary.size());
     }
 
     _out->sputn(value.data(), value.size());
@@ -958,9 +958,14 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
             case state_array_member_value:
                 if (_next->advance(in, atLeastOne))
                 {
+                    _state = state_array_member_value_next;
                     if (_deserializer)
+                    {
                         _deserializer->leaveMember();
-                    _state = state_array_member_value_next;
+                        // let the streaming deserializer take the element
+                        if (_deserializer->elementReady())
+                            return false;
+                    }
                 }
                 break;
 
@@ -1052,14 +1057,14 @@ void Parser::dict(const std::string& value)
     if (value.empty())
         return;
 
-    for (unsigned idx = 0; idx < _dictionary->size(); ++idx)
+    // The formatter sends strings, which are already in the dictionary, as
+    // references, so a string received here is always new unless the
+    // dictionary is full.
+    if (_dictionary->size() <= 0xffff)
     {
-        if ((*_dictionary)[idx] == value)
-            return;
+        log_debug("add dictionary value \"" << value << "\" idx=" << _dictionary->size());
+        _dictionary->push_back(value);
     }
-
-    log_debug("add dictionary value \"" << value << "\" idx=" << _dictionary->size());
-    _dictionary->push_back(value);
 }
 
 std::ostream& operator << (std::ostream& out, const Parser::StringBuffer& s)
@@ -28,6 +28,7 @@
 
 #include "responder.h"
 #include "rpcserverimpl.h"
+#include "protocol.h"
 #include <cxxtools/bin/parser.h>
 #include <cxxtools/serviceprocedure.h>
 #include <cxxtools/remoteexception.h>
@@ -49,10 +50,10 @@ void Responder::reply(IOStream& out)
 {
     log_info("send reply");
 
+    // the dictionary is reset when a request without persistent dictionary starts
     out << '\xc1';
-    _formatter.begin(out.buffer());
+    _formatter.begin(out.buffer(), false);
     _result->format(_formatter);
-    _formatter.finish();
     out << '\xff';
 }
 
@@ -75,7 +76,15 @@ bool Responder::onInput(IOStream& ios)
     {
         if (advance(ios.buffer()))
         {
-            if (_failed)
+            if (_handshake)
+            {
+                log_debug("client requests persistent dictionary");
+                Decomposer<bool> result;
+                result.begin(true);
+                _result = &result;
+                reply(ios);
+            }
+            else if (_failed)
             {
                 replyError(ios, _errorMessage.c_str(), 0);
             }
@@ -103,9 +112,10 @@ bool Responder::onInput(IOStream& ios)
             _args = 0;
             _result = 0;
             _state = state_0;
+            _handshake = false;
             _failed = false;
             _errorMessage.clear();
-            _deserializer.begin();
+            _deserializer.clear();
 
             return true;
         }
@@ -114,6 +124,52 @@ bool Responder::onInput(IOStream& ios)
     return false;
 }
 
+void Responder::nameComplete()
+{
+    if (_haveDomain)
+    {
+        _methodName = std::move(_name);
+        lookupProcedure();
+    }
+    else
+    {
+        log_info_if(!_name.empty(), "rpc method domain \"" << _name << '"');
+        _domain = std::move(_name);
+        _haveDomain = true;
+        _state = state_name0;
+    }
+}
+
+void Responder::lookupProcedure()
+{
+    log_info("rpc method \"" << _methodName << '"');
+
+    if (_domain.empty() && _methodName == persistentDictionaryMethod)
+    {
+        _handshake = true;
+        _state = state_params_skip;
+    }
+    else
+    {
+        _proc = _serviceRegistry.getProcedure(_domain.empty() ? _methodName : _domain + '\0' + _methodName);
+
+        if (_proc)
+        {
+            _args = _proc->beginCall();
+            _state = state_params;
+        }
+        else
+        {
+            _failed = true;
+            _errorMessage = "unknown method \"" + _methodName + '"';
+            _state = state_params_skip;
+        }
+    }
+
+    _methodName.clear();
+    _domain.clear();
+}
+
 bool Responder::advance(std::streambuf& in)
 {
     std::streambuf::int_type chi;
@@ -125,15 +181,64 @@ bool Responder::advance(std::streambuf& in)
             case state_0:
                 log_debug("new rpc request");
 
-                if (ch == '\xc0')
-                    _state = state_method;
-                else if (ch == '\xc3')
-                    _state = state_domain;
+                if (ch == '\xc0' || ch == '\xc3')
+                {
+                    // a request without persistent dictionary resets the
+                    // dictionaries of the connection
+                    _names.clear();
+                    _deserializer.begin();
+                    _formatter.finish();
+                    _state = (ch == '\xc0' ? state_method : state_domain);
+                }
+                else if (ch == '\xc4')
+                {
+                    _haveDomain = false;
+                    _state = state_name0;
+                }
                 else
                     throw std::runtime_error("domain or method name expected");
                 in.sbumpc();
                 break;
 
+            case state_name0:
+                _name.clear();
+                if (ch == '\1')
+                {
+                    _state = state_name_idx0;
+                    in.sbumpc();
+                    break;
+                }
+
+                _state = state_name;
+                // no break
+
+            case state_name:
+                in.sbumpc();
+                if (ch == '\0')
+                {
+                    if (!_name.empty() && _names.size() <= 0xffff)
+                        _names.push_back(_name);
+                    nameComplete();
+                }
+                else
+                    _name += ch;
+                break;
+
+            case state_name_idx0:
+                _nameIdx = static_cast<unsigned char>(ch) << 8;
+                _state = state_name_idx1;
+                in.sbumpc();
+                break;
+
+            case state_name_idx1:
+                _nameIdx |= static_cast<unsigned char>(ch);
+                if (_nameIdx >= _names.size())
+                    throw std::runtime_error("invalid name index");
+                _name = _names[_nameIdx];
+                in.sbumpc();
+                nameComplete();
+                break;
+
             case state_domain:
                 if (ch == '\0')
                 {
@@ -147,26 +252,7 @@ bool Responder::advance(std::streambuf& in)
 
             case state_method:
                 if (ch == '\0')
-                {
-                    log_info("rpc method \"" << _methodName << '"');
-
-                    _proc = _serviceRegistry.getProcedure(_domain.empty() ? _methodName : _domain + '\0' + _methodName);
-
-                    if (_proc)
-                    {
-                        _args = _proc->beginCall();
-                        _state = state_params;
-                    }
-                    else
-                    {
-                        _failed = true;
-                        _errorMessage = "unknown method \"" + _methodName + '"';
-                        _state = state_params_skip;
-                    }
-
-                    _methodName.clear();
-                    _domain.clear();
-                }
+                    lookupProcedure();
                 else
                     _methodName += ch;
                 in.sbumpc();
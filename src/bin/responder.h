@@ -35,6 +35,7 @@
 #include <cxxtools/serviceregistry.h>
 
 #include <iosfwd>
+#include <vector>
 
 namespace cxxtools
 {
@@ -57,6 +58,10 @@ class Responder
             state_0,
             state_domain,
             state_method,
+            state_name0,
+            state_name,
+            state_name_idx0,
+            state_name_idx1,
             state_params,
             state_params_skip,
             state_param,
@@ -70,8 +75,11 @@ class Responder
               _proc(0),
               _args(0),
               _result(0),
+              _nameIdx(0),
+              _haveDomain(false),
+              _handshake(false),
               _failed(false)
-        { }
+        { _deserializer.setArena(&_arena); }
 
         ~Responder();
 
@@ -82,10 +90,14 @@ class Responder
         void replyError(IOStream& out, const char* msg, int rc);
 
     private:
+        void nameComplete();
+        void lookupProcedure();
+
         ServiceRegistry& _serviceRegistry;
         State _state;
         std::string _domain;
         std::string _methodName;
+        Arena _arena;   // parameter trees; must be destroyed after _deserializer
         Deserializer _deserializer;
 
         ServiceProcedure* _proc;
@@ -93,6 +105,14 @@ class Responder
         IDecomposer* _result;
         Formatter _formatter;
 
+        // requests with persistent dictionary (0xc4) pass domain and method
+        // name through a dictionary of their own
+        std::vector<std::string> _names;
+        std::string _name;
+        unsigned _nameIdx;
+        bool _haveDomain;
+        bool _handshake;
+
         bool _failed;
         std::string _errorMessage;
 };
@@ -189,6 +189,16 @@ void RpcClient::domain(const std::string& p)
     getImpl()->domain(p);
 }
 
+void RpcClient::persistentDictionary(bool sw)
+{
+    getImpl()->persistentDictionary(sw);
+}
+
+bool RpcClient::persistentDictionary() const
+{
+    return getImpl()->persistentDictionary();
+}
+
 Delegate<bool, const SslCertificate&>& RpcClient::acceptSslCertificate()
 {
     return getImpl()->socket().acceptSslCertificate;
@@ -27,6 +27,7 @@
  */
 
 #include "rpcclientimpl.h"
+#include "protocol.h"
 #include <cxxtools/log.h>
 #include <cxxtools/remoteprocedure.h>
 #include <cxxtools/bin/rpcclient.h>
@@ -44,8 +45,13 @@ namespace bin
 
 RpcClientImpl::RpcClientImpl()
     : _stream(_socket, 8192, true),
+      _persistentDictionary(false),
+      _dictionaryState(dictionary_none),
+      _handshakeResult(false),
+      _persistentRequest(false),
       _exceptionPending(false),
       _proc(0),
+      _composer(0),
       _timeout(Selectable::WaitInfinite),
       _connectTimeoutSet(false),
       _connectTimeout(Selectable::WaitInfinite)
@@ -54,10 +60,12 @@ RpcClientImpl::RpcClientImpl()
     cxxtools::connect(_socket.sslConnected, *this, &RpcClientImpl::onSslConnect);
     cxxtools::connect(_stream.buffer().outputReady, *this, &RpcClientImpl::onOutput);
     cxxtools::connect(_stream.buffer().inputReady, *this, &RpcClientImpl::onInput);
+    _handshakeComposer.begin(_handshakeResult);
 }
 
 void RpcClientImpl::connect()
 {
+    resetDictionary();
     _socket.setTimeout(_connectTimeout);
     _socket.close();
     _socket.connect(_addrInfo);
@@ -68,6 +76,7 @@ void RpcClientImpl::connect()
 void RpcClientImpl::close()
 {
     _socket.close();
+    resetDictionary();
 }
 
 void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc)
@@ -79,6 +88,10 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
         throw std::logic_error("asyncronous request already running");
 
     _proc = &method;
+    _composer = &r;
+
+    if (!_socket.isConnected())
+        resetDictionary();
 
     prepareRequest(method.name(), argv, argc);
 
@@ -93,6 +106,13 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
             catch (const IOError&)
             {
                 log_debug("write failed, connection is not active any more");
+                if (_dictionaryState != dictionary_none)
+                {
+                    // the new connection does not know our dictionary
+                    _stream.buffer().discard();
+                    resetDictionary();
+                    prepareRequest(method.name(), argv, argc);
+                }
                 _socket.beginConnect(_addrInfo);
             }
         }
@@ -116,13 +136,12 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
             throw;
     }
 
-    _scanner.begin(_deserializer, r);
+    beginReply();
 }
 
 void RpcClientImpl::endCall()
 {
     _proc = 0;
-    _formatter.finish();
 
     if (_exceptionPending)
     {
@@ -136,6 +155,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
     try
     {
         _proc = &method;
+        _composer = &r;
         StreamBuffer& sb = _stream.buffer();
 
         if (_socket.isConnected())
@@ -168,6 +188,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
         if (!_socket.isConnected())
         {
             log_debug("socket is not connected");
+            resetDictionary();
             _socket.setTimeout(_connectTimeout);
             _socket.connect(_addrInfo);
             if (_sslCtx.enabled())
@@ -178,7 +199,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
             sb.pubsync();
         }
 
-        _scanner.begin(_deserializer, r);
+        beginReply();
 
         while (true)
         {
@@ -190,6 +211,13 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
 
             if (_scanner.advance(sb))
             {
+                if (_dictionaryState == dictionary_requested)
+                {
+                    finishHandshake();
+                    beginReply();
+                    continue;
+                }
+
                 _proc = 0;
                 _scanner.finish();
                 break;
@@ -215,6 +243,7 @@ void RpcClientImpl::cancel()
     _stream.buffer().discard();
     _proc = 0;
     _exceptionPending = false;
+    resetDictionary();
 }
 
 void RpcClientImpl::wait(Timespan timeout)
@@ -244,11 +273,32 @@ void RpcClientImpl::wait(Timespan timeout)
 
 void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsigned argc)
 {
-    _formatter.begin(_stream.buffer());
-    if (_domain.empty())
-        _stream << '\xc0' << name << '\0';
+    if (_dictionaryState == dictionary_active)
+    {
+        _formatter.begin(_stream.buffer(), false);
+        _stream << '\xc4';
+        outputName(_domain);
+        outputName(name.narrow());
+        _persistentRequest = true;
+    }
     else
-        _stream << '\xc3' << _domain << '\0' << name << '\0';
+    {
+        if (_persistentDictionary && _dictionaryState == dictionary_none)
+        {
+            // ask the server and send the request without waiting for the reply
+            log_debug("request persistent dictionary");
+            _stream << '\xc0' << persistentDictionaryMethod << '\0' << '\xff';
+            _dictionaryState = dictionary_requested;
+        }
+
+        _names.clear();
+        _persistentRequest = false;
+        _formatter.begin(_stream.buffer());
+        if (_domain.empty())
+            _stream << '\xc0' << name << '\0';
+        else
+            _stream << '\xc3' << _domain << '\0' << name << '\0';
+    }
 
     for(unsigned n = 0; n < argc; ++n)
     {
@@ -258,6 +308,58 @@ void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsig
     _stream << '\xff';
 }
 
+void RpcClientImpl::outputName(const std::string& name)
+{
+    if (name.empty())
+    {
+        _stream << '\0';
+        return;
+    }
+
+    auto it = _names.find(name);
+    if (it != _names.end())
+    {
+        _stream << '\1'
+                << static_cast<char>(it->second >> 8)
+                << static_cast<char>(it->second);
+        return;
+    }
+
+    if (_names.size() <= 0xffff)
+        _names.emplace(name, _names.size());
+
+    _stream << name << '\0';
+}
+
+void RpcClientImpl::beginReply()
+{
+    if (_dictionaryState == dictionary_requested)
+        _scanner.begin(_deserializer, _handshakeComposer);
+    else
+        _scanner.begin(_deserializer, *_composer, !_persistentRequest);
+}
+
+void RpcClientImpl::finishHandshake()
+{
+    try
+    {
+        _scanner.finish();
+        log_debug("server supports persistent dictionary");
+        _dictionaryState = dictionary_active;
+    }
+    catch (const RemoteException& e)
+    {
+        log_debug("server does not support persistent dictionary: " << e.what());
+        _dictionaryState = dictionary_unsupported;
+    }
+}
+
+void RpcClientImpl::resetDictionary()
+{
+    _dictionaryState = dictionary_none;
+    _names.clear();
+}
+
 void RpcClientImpl::onConnect(net::TcpSocket& socket)
 {
     try
@@ -361,8 +463,15 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
         if (sb.device()->eof())
             throw IOError("end of input");
 
-        if (_scanner.advance(sb))
+        while (_scanner.advance(sb))
         {
+            if (_dictionaryState == dictionary_requested)
+            {
+                finishHandshake();
+                beginReply();
+                continue;
+            }
+
             _scanner.finish();
             IRemoteProcedure* proc = _proc;
             _proc = 0;
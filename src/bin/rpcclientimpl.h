@@ -39,7 +39,9 @@
 #include <cxxtools/refcounted.h>
 #include <cxxtools/timespan.h>
 #include <cxxtools/sslctx.h>
+#include <cxxtools/composer.h>
 #include <string>
+#include <unordered_map>
 #include "scanner.h"
 
 namespace cxxtools
@@ -101,8 +103,18 @@ class RpcClientImpl : public RefCounted, public Connectable
         void domain(const std::string& p)
         { _domain = p; }
 
+        bool persistentDictionary() const
+        { return _persistentDictionary; }
+
+        void persistentDictionary(bool sw)
+        { _persistentDictionary = sw; }
+
     private:
         void prepareRequest(const String& name, IDecomposer** argv, unsigned argc);
+        void outputName(const std::string& name);
+        void beginReply();
+        void finishHandshake();
+        void resetDictionary();
         void onConnect(net::TcpSocket& socket);
         void onSslConnect(net::TcpSocket& socket);
         void onOutput(StreamBuffer& sb);
@@ -121,8 +133,23 @@ class RpcClientImpl : public RefCounted, public Connectable
         Deserializer _deserializer;
         Formatter _formatter;
 
+        // persistent dictionary
+        bool _persistentDictionary;
+        enum
+        {
+            dictionary_none,        // not negotiated on this connection
+            dictionary_requested,   // handshake sent; reply pending
+            dictionary_active,
+            dictionary_unsupported
+        } _dictionaryState;
+        std::unordered_map<std::string, unsigned> _names;
+        Composer<bool> _handshakeComposer;
+        bool _handshakeResult;
+        bool _persistentRequest;
+
         bool _exceptionPending;
         IRemoteProcedure* _proc;
+        IComposer* _composer;
 
         Timespan _timeout;
         bool _connectTimeoutSet;  // indicates if connectTimeout is explicitely set
@@ -109,6 +109,16 @@ void RpcServer::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+bool RpcServer::reusePort() const
+{
+    return _impl->reusePort();
+}
+
+void RpcServer::reusePort(bool sw)
+{
+    _impl->reusePort(sw);
+}
+
 Delegate<bool, const SslCertificate&>& RpcServer::acceptSslCertificate()
 {
     return _impl->acceptSslCertificate;
@@ -33,6 +33,7 @@
 #include <cxxtools/eventloop.h>
 #include <cxxtools/net/tcpserver.h>
 #include <cxxtools/log.h>
+#include <algorithm>
 
 log_define("cxxtools.bin.rpcserver.impl")
 
@@ -99,7 +100,8 @@ RpcServerImpl::RpcServerImpl(EventLoopBase& eventLoop, Signal<RpcServer::Runmode
       inputSlot(slot(*this, &RpcServerImpl::onInput)),
       _serviceRegistry(serviceRegistry),
       _minThreads(5),
-      _maxThreads(200)
+      _maxThreads(200),
+      _reusePort(false)
 {
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onIdleSocket));
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onNoWaitingThreads));
@@ -114,20 +116,44 @@ RpcServerImpl::RpcServerImpl(EventLoopBase& eventLoop, Signal<RpcServer::Runmode
 void RpcServerImpl::listen(const std::string& ip, unsigned short int port, const SslCtx& sslCtx)
 {
     log_info("listen on ip <" << ip << "> port " << port << " ssl " << sslCtx.enabled());
-    net::TcpServer* listener = new net::TcpServer(ip, port, 64,
-        net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
 
-    try
-    {
-        _listener.push_back(listener);
-        _queue.put(new Socket(*this, *listener, sslCtx));
-    }
-    catch (...)
+    // With reusePort each of the minimum number of workers gets its own
+    // listener, so that they accept in parallel. Port 0 is a unix domain
+    // socket, which can't be shared.
+    unsigned count = _reusePort && port != 0 ? std::max(_minThreads, 1u) : 1;
+    unsigned flags = net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR;
+    if (count > 1)
+        flags |= net::TcpServer::REUSEPORT;
+
+    for (unsigned n = 0; n < count; ++n)
     {
-        delete listener;
-        throw;
-    }
+        net::TcpServer* listener;
+        try
+        {
+            listener = new net::TcpServer(ip, port, 64, flags);
+        }
+        catch (const net::AddressInUse&)
+        {
+            if (n == 0)
+                throw;
 
+            log_warn("only " << n << " listeners on port " << port << " possible");
+            break;
+        }
+
+        try
+        {
+            _listener.push_back(listener);
+            _queue.put(new Socket(*this, *listener, sslCtx));
+        }
+        catch (...)
+        {
+            if (!_listener.empty() && _listener.back() == listener)
+                _listener.pop_back();
+            delete listener;
+            throw;
+        }
+    }
 }
 
 void RpcServerImpl::start()
@@ -86,6 +86,12 @@ namespace bin
             void maxThreads(unsigned m)
             { _maxThreads = m; }
 
+            bool reusePort() const
+            { return _reusePort; }
+
+            void reusePort(bool sw)
+            { _reusePort = sw; }
+
             void terminate();
 
             RpcServer::Runmode runmode() const
@@ -126,6 +132,7 @@ namespace bin
             ServiceRegistry& _serviceRegistry;
             unsigned _minThreads;
             unsigned _maxThreads;
+            bool _reusePort;
 
             std::vector<net::TcpServer*> _listener;
             Queue<Socket*> _queue;
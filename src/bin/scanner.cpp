@@ -40,9 +40,9 @@ namespace cxxtools
 namespace bin
 {
 
-void Scanner::begin(Deserializer& handler, IComposer& composer)
+void Scanner::begin(Deserializer& handler, IComposer& composer, bool resetDictionary)
 {
-    _vp.begin(handler);
+    _vp.begin(handler, resetDictionary);
     _deserializer = &handler;
     _composer = &composer;
     _deserializer->begin();
@@ -53,7 +53,7 @@ namespace cxxtools
                       _errorCode(0)
                 { }
 
-                void begin(Deserializer& handler, IComposer& composer);
+                void begin(Deserializer& handler, IComposer& composer, bool resetDictionary = true);
 
                 bool advance(std::streambuf& in);
 
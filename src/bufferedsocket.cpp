@@ -28,6 +28,8 @@
 
 #include <cxxtools/net/bufferedsocket.h>
 #include <cxxtools/log.h>
+#include <algorithm>
+#include <memory>
 
 log_define("cxxtools.net.bufferedsocket")
 
@@ -72,6 +74,15 @@ BufferedSocket::~BufferedSocket()
 {
     if (_sentry)
         _sentry->detach();
+
+    try
+    {
+        releaseBorrowed(_borrowed.size());
+    }
+    catch (const std::exception& e)
+    {
+        log_warn("releasing borrowed buffer failed: " << e.what());
+    }
 }
 
 size_t BufferedSocket::onEndRead(bool& eof)
@@ -118,12 +129,17 @@ void BufferedSocket::onOutput(IODevice&)
     try
     {
         auto count = endWrite();
-        _outputBuffer.erase(_outputBuffer.begin(), _outputBuffer.begin() + count);
+        consumeOutput(count);
+        if (sentry.deleted())
+            return;
 
         if (_outputBuffer.empty())
         {
             if (_outputBufferNext.empty())
-                outputBufferEmpty(*this);
+            {
+                if (_borrowed.empty())
+                    outputBufferEmpty(*this);
+            }
             else
                 _outputBuffer.swap(_outputBufferNext);
         }
@@ -133,7 +149,7 @@ void BufferedSocket::onOutput(IODevice&)
             _outputBufferNext.clear();
         }
 
-        if (!sentry.deleted() && !writing() && !_outputBuffer.empty())
+        if (!sentry.deleted() && !writing() && (!_outputBuffer.empty() || !_borrowed.empty()))
             beginWrite();
     }
     catch (const std::exception& e)
@@ -159,6 +175,40 @@ BufferedSocket& BufferedSocket::write(const char* buffer, size_t n, bool begin)
     return *this;
 }
 
+BufferedSocket& BufferedSocket::writeBorrowed(const char* buffer, size_t n, bool begin)
+{
+    if (n > 0)
+    {
+        Borrowed b = { buffer, n, _outputBuffer.size() + _outputBufferNext.size(), 0 };
+        _borrowed.push_back(b);
+    }
+
+    if (begin)
+        beginWrite();
+
+    return *this;
+}
+
+BufferedSocket& BufferedSocket::writeBorrowed(const char* buffer, size_t n, const Callable<void>& released, bool begin)
+{
+    if (n == 0)
+    {
+        released.call();
+    }
+    else
+    {
+        std::unique_ptr<Callable<void> > r(released.clone());
+        Borrowed b = { buffer, n, _outputBuffer.size() + _outputBufferNext.size(), r.get() };
+        _borrowed.push_back(b);
+        r.release();
+    }
+
+    if (begin)
+        beginWrite();
+
+    return *this;
+}
+
 BufferedSocket& BufferedSocket::putc(char ch)
 {
     if (writing())
@@ -171,18 +221,107 @@ BufferedSocket& BufferedSocket::putc(char ch)
 
 BufferedSocket& BufferedSocket::beginWrite()
 {
-    if (!writing() && !_outputBuffer.empty())
+    if (writing())
+        return *this;
+
+    if (!_borrowed.empty())
+    {
+        // when not writing, all buffered data is in _outputBuffer
+        _outputVec.clear();
+        size_t p = 0;
+        for (auto& b: _borrowed)
+        {
+            if (b.pos > p)
+            {
+                IOVec v = { _outputBuffer.data() + p, b.pos - p };
+                _outputVec.push_back(v);
+                p = b.pos;
+            }
+
+            IOVec v = { b.data, b.size };
+            _outputVec.push_back(v);
+        }
+
+        if (_outputBuffer.size() > p)
+        {
+            IOVec v = { _outputBuffer.data() + p, _outputBuffer.size() - p };
+            _outputVec.push_back(v);
+        }
+
+        TcpSocket::beginWritev(_outputVec.data(), _outputVec.size());
+    }
+    else if (!_outputBuffer.empty())
         TcpSocket::beginWrite(_outputBuffer.data(), _outputBuffer.size());
 
     return *this;
 }
 
+void BufferedSocket::consumeOutput(size_t count)
+{
+    size_t used = 0;    // bytes written from _outputBuffer
+    size_t done = 0;    // number of borrowed buffers written completely
+
+    while (done < _borrowed.size())
+    {
+        Borrowed& b = _borrowed[done];
+
+        size_t k = std::min(count, b.pos - used);
+        used += k;
+        count -= k;
+        if (used < b.pos)
+            break;
+
+        k = std::min(count, b.size);
+        b.data += k;
+        b.size -= k;
+        count -= k;
+        if (b.size > 0)
+            break;
+
+        ++done;
+    }
+
+    used += count;
+
+    _outputBuffer.erase(_outputBuffer.begin(), _outputBuffer.begin() + used);
+
+    for (size_t i = done; i < _borrowed.size(); ++i)
+        _borrowed[i].pos -= used;
+
+    releaseBorrowed(done);
+}
+
+void BufferedSocket::releaseBorrowed(size_t count)
+{
+    if (count == 0)
+        return;
+
+    std::vector<std::unique_ptr<Callable<void> > > released;
+    for (size_t i = 0; i < count; ++i)
+        if (_borrowed[i].released)
+            released.emplace_back(_borrowed[i].released);
+
+    _borrowed.erase(_borrowed.begin(), _borrowed.begin() + count);
+
+    for (auto& r: released)
+        r->call();
+}
+
 void BufferedSocket::cancel()
 {
     IODevice::cancel();
     _inputBuffer.clear();
     _outputBuffer.clear();
     _outputBufferNext.clear();
+    releaseBorrowed(_borrowed.size());
+}
+
+unsigned BufferedSocket::outputSize() const
+{
+    unsigned n = _outputBuffer.size() + _outputBufferNext.size();
+    for (auto& b: _borrowed)
+        n += b.size;
+    return n;
 }
 
 }
@@ -41,7 +41,25 @@ namespace cxxtools
     {
         while (!_current.empty())
             _current.pop();
-        _si.clear();
+
+        if (_arena)
+        {
+            _si = SerializationInfo(_arena);
+            _arena->clear();
+        }
+        else
+            _si.clear();
+
+        _streaming = false;
+        _elementReady = false;
+        _streamEnd = false;
+    }
+
+    void Deserializer::setArena(Arena* arena)
+    {
+        clear();
+        _si = SerializationInfo(arena);
+        _arena = arena;
     }
 
     void Deserializer::beginMember(const std::string& name, const std::string& type, SerializationInfo::Category category)
@@ -58,6 +76,57 @@ namespace cxxtools
             SerializationError::doThrow("invalid member");
 
         _current.pop();
+
+        if (_streaming && _current.size() == 1 && _si.category() == SerializationInfo::Array)
+            _elementReady = true;
+    }
+
+    void Deserializer::beginStream()
+    {
+        begin();
+        _streaming = true;
+    }
+
+    bool Deserializer::readElement()
+    {
+        SerializationError::doThrow("deserializer does not support streaming");
+        return true;
+    }
+
+    bool Deserializer::nextElement()
+    {
+        if (!_streaming)
+            SerializationError::doThrow("no stream to read elements from");
+
+        if (_elementReady)
+        {
+            releaseElement();
+            _elementReady = false;
+        }
+
+        if (!_streamEnd)
+            _streamEnd = readElement();
+
+        if (_elementReady)
+            return true;
+
+        if (_si.category() != SerializationInfo::Array)
+            SerializationError::doThrow("array expected");
+
+        return false;
+    }
+
+    void Deserializer::releaseElement()
+    {
+        if (_arena)
+        {
+            _si = SerializationInfo(_arena);
+            _arena->clear();
+        }
+        else
+            _si.clear();
+
+        _si.setCategory(SerializationInfo::Array);
     }
 
 } // namespace cxxtools
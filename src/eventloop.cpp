@@ -27,10 +27,11 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "selectorimpl.h"
+#include "eventqueue.h"
 #include "cxxtools/eventloop.h"
 #include "cxxtools/log.h"
-#include <deque>
-#include <mutex>
+#include <atomic>
+#include <thread>
 
 log_define("cxxtools.eventloop")
 
@@ -38,87 +39,77 @@ namespace cxxtools
 {
 namespace
 {
-    struct EvPtr
+    // releases the node after the event is sent, even on exceptions
+    struct NodePtr
     {
-        Event* ev;
-        explicit EvPtr(Event* ev_)
-            : ev(ev_)
-        { }
+        EventPool& pool;
+        EventNode* node;
 
-        ~EvPtr()
-        { if (ev) ev->destroy(); }
+        NodePtr(EventPool& pool_, EventNode* node_)
+            : pool(pool_),
+              node(node_)
+        { }
 
+        ~NodePtr()
+        { pool.release(node); }
     };
 }
 
 class EventLoop::Impl
 {
 public:
-    Impl()
+    explicit Impl(SelectorBase::Backend backend)
         : _exitLoop(false),
-          _selector(new SelectorImpl()),
-          _eventsPerLoop(16)
+          _wakePending(false),
+          _selector(new SelectorImpl(backend)),
+          _eventPool(256),
+          _eventsPerLoop(16),
+          _popFailed(false)
         { }
     ~Impl();
 
     bool eventQueueEmpty() const
-    { return _eventQueue.empty() && _priorityEventQueue.empty() && _activeEventQueue.empty(); }
+    { return _eventQueue.empty() && _priorityEventQueue.empty(); }
 
     unsigned pendingEvents() const
-    { return _eventQueue.size() + _priorityEventQueue.size() + _activeEventQueue.size(); }
+    { return _eventQueue.size() + _priorityEventQueue.size(); }
 
-    Event* front()
+    // returns the next event to process; priority events first
+    EventNode* pop()
     {
-        if (_priorityEventQueue.empty())
-            return _eventQueue.front();
-        else
-            return _priorityEventQueue.front();
-    }
-
-    void pop_front()
-    {
-        if (_priorityEventQueue.empty())
-            _eventQueue.pop_front();
-        else
-            _priorityEventQueue.pop_front();
+        // A priority event, which is not linked in yet, must not be
+        // overtaken by normal events committed after it.
+        if (!_priorityEventQueue.empty())
+            return _priorityEventQueue.pop();
+        return _eventQueue.pop();
     }
 
-    bool _exitLoop;
+    std::atomic<bool> _exitLoop;
+    // set by the first committed event after the loop last went to sleep;
+    // further commits skip writing to the wake pipe
+    std::atomic<bool> _wakePending;
     SelectorImpl* _selector;
-    std::deque<Event*> _eventQueue;
-    std::deque<Event*> _priorityEventQueue;
-    std::deque<Event*> _activeEventQueue;
-    bool _activeEventQueueIsPriority;
-    std::mutex _queueMutex;
+    EventPool _eventPool;
+    EventQueue _eventQueue;
+    EventQueue _priorityEventQueue;
     unsigned _eventsPerLoop;
+    // set by onProcessEvents, when a pop found no event; the queue may
+    // still count an event, which a producer has not linked in yet
+    bool _popFailed;
 };
 
 EventLoop::Impl::~Impl()
 {
     try
     {
-        while ( ! _eventQueue.empty() )
-        {
-            Event* ev = _eventQueue.front();
-            _eventQueue.pop_front();
-            ev->destroy();
-        }
-
-        while ( ! _priorityEventQueue.empty() )
-        {
-            Event* ev = _priorityEventQueue.front();
-            _priorityEventQueue.pop_front();
-            ev->destroy();
-        }
-
-        while ( ! _activeEventQueue.empty() )
+        while (!eventQueueEmpty())
         {
-            Event* ev = _activeEventQueue.front();
-            _activeEventQueue.pop_front();
-            if (ev)
-                ev->destroy();
+            EventNode* node = pop();
+            if (node)
+                _eventPool.release(node);
+            else
+                std::this_thread::yield();
         }
-
     }
     catch(...)
     {}
@@ -127,7 +118,13 @@ EventLoop::Impl::~Impl()
 }
 
 EventLoop::EventLoop()
-: _impl(new Impl())
+: _impl(new Impl(DefaultBackend))
+{
+}
+
+
+EventLoop::EventLoop(Backend backend)
+: _impl(new Impl(backend))
 {
 }
 
@@ -182,20 +179,19 @@ void EventLoop::onRun()
 
     while (true)
     {
-        std::unique_lock<std::mutex> lock(_impl->_queueMutex);
-
-        if (_impl->_exitLoop)
-        {
-            _impl->_exitLoop = false;
+        if (_impl->_exitLoop.exchange(false))
             break;
-        }
 
         bool eventQueueEmpty = _impl->eventQueueEmpty();
-        lock.unlock();
         if (!eventQueueEmpty)
         {
+            _impl->_popFailed = false;
             processEvents(_impl->_eventsPerLoop);
-            eventQueueEmpty = _impl->eventQueueEmpty();
+
+            // An event, which a producer is still pushing, is treated as
+            // not there yet instead of spinning on it; the wait below
+            // blocks until the producer wakes the selector.
+            eventQueueEmpty = _impl->_popFailed || _impl->eventQueueEmpty();
         }
 
         if (eventQueueEmpty)
@@ -219,15 +215,31 @@ void EventLoop::onRun()
 
 bool EventLoop::onWaitUntil(Timespan timeout)
 {
-    if (_impl->_selector->waitUntil(timeout))
+    // Reset the wake flag before checking the queues. Events committed
+    // after that will wake the selector again; events committed before
+    // are seen here and must not wait.
+    _impl->_wakePending.store(false, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (!_impl->eventQueueEmpty())
     {
-        std::unique_lock<std::mutex> lock(_impl->_queueMutex);
+        _impl->_popFailed = false;
+        processEvents(_impl->_eventsPerLoop);
+        if (!_impl->_popFailed)
+        {
+            _impl->_selector->waitUntil(Timespan(0));
+            return true;
+        }
+
+        // The events left are counted, but not linked in yet. We wait
+        // for their producers, which wake the selector after linking,
+        // since the wake flag is reset.
+    }
 
+    if (_impl->_selector->waitUntil(timeout))
+    {
         if (!_impl->eventQueueEmpty())
-        {
-            lock.unlock();
             processEvents(_impl->_eventsPerLoop);
-        }
 
         return true;
     }
@@ -246,10 +258,7 @@ void EventLoop::onExit()
 {
     log_debug("exit loop");
 
-    {
-        std::lock_guard<std::mutex> lock(_impl->_queueMutex);
-        _impl->_exitLoop = true;
-    }
+    _impl->_exitLoop = true;
 
     wake();
 }
@@ -258,23 +267,21 @@ void EventLoop::onQueueEvent(const Event& ev, bool priority)
 {
     log_debug("queue event");
 
-    std::lock_guard<std::mutex> lock( _impl->_queueMutex );
-
-    EvPtr cloned(ev.clone());
+    EventNode* node = _impl->_eventPool.create(ev);
 
     if (priority)
-        _impl->_priorityEventQueue.push_back(cloned.ev);
+        _impl->_priorityEventQueue.push(node);
     else
-        _impl->_eventQueue.push_back(cloned.ev);
-
-    cloned.ev = 0;
+        _impl->_eventQueue.push(node);
 }
 
 
 void EventLoop::onCommitEvent(const Event& ev, bool priority)
 {
     onQueueEvent(ev, priority);
-    _impl->_selector->wake();
+
+    if (!_impl->_wakePending.exchange(true, std::memory_order_seq_cst))
+        _impl->_selector->wake();
 }
 
 
@@ -282,69 +289,28 @@ void EventLoop::onProcessEvents(unsigned max)
 {
     unsigned count = 0;
 
-    bool& exitLoop = _impl->_exitLoop;
-    std::deque<Event*>& eventQueue = _impl->_eventQueue;
-    std::deque<Event*>& priorityEventQueue = _impl->_priorityEventQueue;
-    std::deque<Event*>& activeEventQueue = _impl->_activeEventQueue;
-    bool& activeEventQueueIsPriority = _impl->_activeEventQueueIsPriority;
-    auto& queueMutex = _impl->_queueMutex;
-
-    log_debug("processEvents(max:" << max << ") normal/priority/active(priority): " << eventQueue.size() << '/' << priorityEventQueue.size() << '/' << activeEventQueue.size() << '(' << activeEventQueueIsPriority << ')');
-
-    if (!activeEventQueue.empty() && !activeEventQueueIsPriority)
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        if (!priorityEventQueue.empty())
-        {
-            log_debug("priority events bypass active events");
-
-            if (eventQueue.empty())
-            {
-                eventQueue.swap(activeEventQueue);
-            }
-            else
-            {
-                eventQueue.insert(eventQueue.begin(), activeEventQueue.begin(), activeEventQueue.end()); 
-                activeEventQueue.clear();
-            }
+    std::atomic<bool>& exitLoop = _impl->_exitLoop;
 
-            priorityEventQueue.swap(activeEventQueue);
-            activeEventQueueIsPriority = true;
-        }
-    }
+    log_debug("processEvents(max:" << max << ") normal/priority: " << _impl->_eventQueue.size() << '/' << _impl->_priorityEventQueue.size());
 
     while (!exitLoop)
     {
-        if (activeEventQueue.empty())
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            if (!priorityEventQueue.empty())
-            {
-                log_debug("move " << priorityEventQueue.size() << " priority events to active event queue");
-                activeEventQueueIsPriority = true;
-                activeEventQueue.swap(priorityEventQueue);
-            }
-            else if (!eventQueue.empty())
-            {
-                log_debug("move " << eventQueue.size() << " events to active event queue");
-                activeEventQueueIsPriority = false;
-                activeEventQueue.swap(eventQueue);
-            }
-        }
-
-        if (exitLoop || activeEventQueue.empty())
+        // priority events are checked before each event, so that they
+        // bypass normal events already in the queue
+        EventNode* node = _impl->pop();
+        if (node == 0)
         {
-            log_debug_if(activeEventQueue.empty(), "no events to process");
+            log_debug("no events to process");
+            _impl->_popFailed = true;
             break;
         }
 
-        EvPtr ev(activeEventQueue.front());
-        activeEventQueue.pop_front();
+        NodePtr ptr(_impl->_eventPool, node);
 
         ++count;
 
         log_debug("send event " << count);
-        event.send(*ev.ev);
+        event.send(*node->event);
 
         if (max != 0 && count >= max)
         {
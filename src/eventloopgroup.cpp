@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include "config.h"
+#include "cxxtools/eventloopgroup.h"
+#include "cxxtools/eventloop.h"
+#include "cxxtools/event.h"
+#include "cxxtools/selectable.h"
+#include "cxxtools/function.h"
+#include "cxxtools/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_SCHED_SETAFFINITY
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#endif
+
+log_define("cxxtools.eventloopgroup")
+
+namespace cxxtools
+{
+namespace
+{
+    class TaskEvent : public BasicEvent<TaskEvent>
+    {
+            std::function<void()> _fn;
+
+        public:
+            explicit TaskEvent(std::function<void()>&& fn)
+                : _fn(std::move(fn))
+                { }
+
+            void operator()() const
+            { _fn(); }
+    };
+
+    void runTask(const TaskEvent& task)
+    {
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            log_error("posted function failed: " << e.what());
+        }
+    }
+}
+
+class EventLoopGroup::Impl
+{
+public:
+    struct Member
+    {
+        EventLoop loop;
+        std::thread thread;
+        std::atomic<unsigned> load;
+        int cpu;
+
+        Member()
+            : load(0),
+              cpu(-1)
+            { loop.event.subscribe(slot(&runTask)); }
+    };
+
+    explicit Impl(unsigned n);
+    ~Impl();
+
+    void start();
+    void stop();
+    void run(Member& member);
+
+    void pin();
+    unsigned select();
+
+    Member& member(unsigned n)
+    {
+        if (n >= _members.size())
+            throw std::out_of_range("invalid event loop index");
+        return *_members[n];
+    }
+
+    std::vector<Member*> _members;
+    std::atomic<unsigned> _next;
+    std::atomic<bool> _running;
+    bool _pinToCores;
+    Assignment _assignment;
+};
+
+EventLoopGroup::Impl::Impl(unsigned n)
+    : _next(0),
+      _running(false),
+      _pinToCores(true),
+      _assignment(LeastLoaded)
+{
+    if (n == 0)
+        n = std::max(std::thread::hardware_concurrency(), 1u);
+
+    try
+    {
+        for (unsigned i = 0; i < n; ++i)
+            _members.push_back(new Member());
+    }
+    catch (...)
+    {
+        for (unsigned i = 0; i < _members.size(); ++i)
+            delete _members[i];
+        throw;
+    }
+}
+
+EventLoopGroup::Impl::~Impl()
+{
+    for (unsigned n = 0; n < _members.size(); ++n)
+        delete _members[n];
+}
+
+void EventLoopGroup::Impl::pin()
+{
+#ifdef HAVE_SCHED_SETAFFINITY
+    // the loops are distributed over the cores, the process may run on
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    {
+        log_warn("sched_getaffinity failed: " << strerror(errno));
+        return;
+    }
+
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(cpu, &allowed))
+            cpus.push_back(cpu);
+
+    if (cpus.empty())
+        return;
+
+    for (unsigned n = 0; n < _members.size(); ++n)
+        _members[n]->cpu = cpus[n % cpus.size()];
+#endif
+}
+
+void EventLoopGroup::Impl::run(Member& member)
+{
+#ifdef HAVE_SCHED_SETAFFINITY
+    if (member.cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(member.cpu, &cpus);
+        if (::sched_setaffinity(0, sizeof(cpus), &cpus) != 0)
+            log_warn("failed to pin event loop to cpu " << member.cpu << ": " << strerror(errno));
+        else
+            log_debug("event loop pinned to cpu " << member.cpu);
+    }
+#endif
+
+    member.loop.run();
+}
+
+void EventLoopGroup::Impl::start()
+{
+    if (_running)
+        return;
+
+    log_debug("start " << _members.size() << " event loops");
+
+    if (_pinToCores)
+        pin();
+
+    unsigned n = 0;
+    try
+    {
+        for (; n < _members.size(); ++n)
+            _members[n]->thread = std::thread(&Impl::run, this, std::ref(*_members[n]));
+    }
+    catch (...)
+    {
+        while (n-- > 0)
+        {
+            _members[n]->loop.exit();
+            _members[n]->thread.join();
+        }
+        throw;
+    }
+
+    _running = true;
+}
+
+void EventLoopGroup::Impl::stop()
+{
+    if (!_running)
+        return;
+
+    log_debug("stop " << _members.size() << " event loops");
+
+    // The exit is queued, so that functions posted before are still executed.
+    for (unsigned n = 0; n < _members.size(); ++n)
+    {
+        EventLoop& loop = _members[n]->loop;
+        loop.commitEvent(TaskEvent([&loop] { loop.exit(); }));
+    }
+
+    for (unsigned n = 0; n < _members.size(); ++n)
+        _members[n]->thread.join();
+
+    _running = false;
+}
+
+unsigned EventLoopGroup::Impl::select()
+{
+    unsigned size = _members.size();
+    unsigned start = _next.fetch_add(1, std::memory_order_relaxed) % size;
+    if (_assignment == RoundRobin)
+        return start;
+
+    // start at the next loop in turn, so that loops with equal load are
+    // selected round robin
+    unsigned best = start;
+    unsigned bestLoad = _members[start]->load.load(std::memory_order_relaxed);
+    for (unsigned i = 1; i < size && bestLoad > 0; ++i)
+    {
+        unsigned n = (start + i) % size;
+        unsigned load = _members[n]->load.load(std::memory_order_relaxed);
+        if (load < bestLoad)
+        {
+            best = n;
+            bestLoad = load;
+        }
+    }
+
+    return best;
+}
+
+////////////////////////////////////////////////////////////////////////
+// EventLoopGroup
+//
+EventLoopGroup::EventLoopGroup(unsigned n)
+    : _impl(new Impl(n))
+{
+}
+
+EventLoopGroup::~EventLoopGroup()
+{
+    try
+    {
+        stop();
+    }
+    catch (const std::exception& e)
+    {
+        log_error("failed to stop event loops: " << e.what());
+    }
+
+    delete _impl;
+}
+
+void EventLoopGroup::start()
+{
+    _impl->start();
+}
+
+void EventLoopGroup::stop()
+{
+    _impl->stop();
+}
+
+bool EventLoopGroup::running() const
+{
+    return _impl->_running;
+}
+
+unsigned EventLoopGroup::size() const
+{
+    return _impl->_members.size();
+}
+
+EventLoop& EventLoopGroup::loop(unsigned n)
+{
+    return _impl->member(n).loop;
+}
+
+int EventLoopGroup::indexOf(const EventLoop& loop) const
+{
+    for (unsigned n = 0; n < _impl->_members.size(); ++n)
+        if (&_impl->_members[n]->loop == &loop)
+            return n;
+    return -1;
+}
+
+bool EventLoopGroup::pinToCores() const
+{
+    return _impl->_pinToCores;
+}
+
+void EventLoopGroup::pinToCores(bool sw)
+{
+    _impl->_pinToCores = sw;
+}
+
+EventLoopGroup::Assignment EventLoopGroup::assignment() const
+{
+    return _impl->_assignment;
+}
+
+void EventLoopGroup::assignment(Assignment a)
+{
+    _impl->_assignment = a;
+}
+
+unsigned EventLoopGroup::assign()
+{
+    unsigned n = _impl->select();
+    assign(n);
+    return n;
+}
+
+void EventLoopGroup::assign(unsigned n)
+{
+    _impl->member(n).load.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventLoopGroup::release(unsigned n)
+{
+    _impl->member(n).load.fetch_sub(1, std::memory_order_relaxed);
+}
+
+unsigned EventLoopGroup::load(unsigned n) const
+{
+    return _impl->member(n).load.load(std::memory_order_relaxed);
+}
+
+EventLoop& EventLoopGroup::add(Selectable& s)
+{
+    unsigned n = assign();
+    EventLoop& loop = _impl->_members[n]->loop;
+    post(n, [&loop, &s] { loop.add(s); });
+    return loop;
+}
+
+void EventLoopGroup::remove(Selectable& s)
+{
+    for (unsigned n = 0; n < _impl->_members.size(); ++n)
+    {
+        if (s.selector() == &_impl->_members[n]->loop)
+        {
+            s.setSelector(0);
+            release(n);
+            return;
+        }
+    }
+
+    s.setSelector(0);
+}
+
+void EventLoopGroup::post(unsigned n, std::function<void()> fn)
+{
+    _impl->member(n).loop.commitEvent(TaskEvent(std::move(fn)));
+}
+
+void EventLoopGroup::post(EventLoop& loop, std::function<void()> fn)
+{
+    int n = indexOf(loop);
+    if (n < 0)
+        throw std::invalid_argument("event loop is not part of the group");
+    post(static_cast<unsigned>(n), std::move(fn));
+}
+
+void EventLoopGroup::execute(unsigned n, const std::function<void()>& fn)
+{
+    Impl::Member& member = _impl->member(n);
+    if (!_impl->_running || member.thread.get_id() == std::this_thread::get_id())
+    {
+        fn();
+        return;
+    }
+
+    std::promise<void> done;
+    post(n, [&fn, &done] {
+        try
+        {
+            fn();
+            done.set_value();
+        }
+        catch (...)
+        {
+            done.set_exception(std::current_exception());
+        }
+    });
+
+    done.get_future().get();
+}
+
+} // namespace cxxtools
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "eventqueue.h"
+
+namespace cxxtools
+{
+
+////////////////////////////////////////////////////////////////////////
+// EventPool
+//
+EventPool::EventPool(uint32_t size)
+    : _nodes(new EventNode[size]),
+      _size(size),
+      _freeHead(0)
+{
+    for (uint32_t n = 0; n < size; ++n)
+    {
+        _nodes[n].index = n + 1;
+        _nodes[n].event = 0;
+        _nodes[n].nextFree.store(n + 1 < size ? n + 2 : 0, std::memory_order_relaxed);
+    }
+
+    _freeHead.store(size > 0 ? 1 : 0, std::memory_order_release);
+}
+
+EventNode* EventPool::popFree()
+{
+    uint64_t head = _freeHead.load(std::memory_order_acquire);
+    while (true)
+    {
+        uint32_t index = static_cast<uint32_t>(head);
+        if (index == 0)
+            return 0;
+
+        EventNode* node = &_nodes[index - 1];
+        uint64_t newHead = (((head >> 32) + 1) << 32)
+                         | node->nextFree.load(std::memory_order_relaxed);
+
+        if (_freeHead.compare_exchange_weak(head, newHead,
+                std::memory_order_acq_rel, std::memory_order_acquire))
+            return node;
+    }
+}
+
+void EventPool::pushFree(EventNode* node)
+{
+    uint64_t head = _freeHead.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do
+    {
+        node->nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        newHead = (((head >> 32) + 1) << 32) | node->index;
+    } while (!_freeHead.compare_exchange_weak(head, newHead,
+                std::memory_order_release, std::memory_order_relaxed));
+}
+
+EventNode* EventPool::create(const Event& ev)
+{
+    EventNode* node = popFree();
+    if (node == 0)
+    {
+        node = new EventNode();
+        node->index = 0;
+    }
+
+    try
+    {
+        node->event = ev.cloneTo(node->storage, sizeof(node->storage));
+    }
+    catch (...)
+    {
+        if (node->index == 0)
+            delete node;
+        else
+            pushFree(node);
+        throw;
+    }
+
+    return node;
+}
+
+void EventPool::release(EventNode* node)
+{
+    Event* ev = node->event;
+    node->event = 0;
+
+    if (static_cast<void*>(ev) == static_cast<void*>(node->storage))
+        ev->~Event();
+    else if (ev)
+        ev->destroy();
+
+    if (node->index == 0)
+        delete node;
+    else
+        pushFree(node);
+}
+
+////////////////////////////////////////////////////////////////////////
+// EventQueue
+//
+EventQueue::EventQueue()
+    : _head(&_stub),
+      _tail(&_stub),
+      _size(0)
+{
+    _stub.next.store(0, std::memory_order_relaxed);
+    _stub.index = 0;
+    _stub.event = 0;
+}
+
+void EventQueue::link(EventNode* node)
+{
+    node->next.store(0, std::memory_order_relaxed);
+    EventNode* prev = _head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+void EventQueue::push(EventNode* node)
+{
+    // sequentially consistent, so that the event loop sees the new size
+    // when it checks for pending events before going to sleep
+    _size.fetch_add(1, std::memory_order_seq_cst);
+    link(node);
+}
+
+EventNode* EventQueue::pop()
+{
+    EventNode* tail = _tail;
+    EventNode* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &_stub)
+    {
+        if (next == 0)
+            return 0;
+
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next == 0)
+    {
+        // tail is the last node; it can only be removed, when the stub is
+        // linked behind it
+        if (tail != _head.load(std::memory_order_acquire))
+            return 0;   // a producer has not yet linked its node
+
+        link(&_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next == 0)
+            return 0;
+    }
+
+    _tail = next;
+    _size.fetch_sub(1, std::memory_order_release);
+    return tail;
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_EVENTQUEUE_H
+#define CXXTOOLS_EVENTQUEUE_H
+
+#include <cxxtools/event.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+
+namespace cxxtools
+{
+
+/// Queue node holding a copy of an event.
+struct EventNode
+{
+    static const std::size_t StorageSize = 64;
+
+    std::atomic<EventNode*> next;
+    std::atomic<uint32_t> nextFree;
+    uint32_t index;     // 1 based position in the pool or 0 when allocated on the heap
+    Event* event;
+    alignas(std::max_align_t) char storage[StorageSize];
+};
+
+/**
+ * Pool of event nodes shared by the queues of an event loop.
+ *
+ * Events are copied into the storage of the nodes, so that small events do
+ * not need heap allocations. The free list is a lock free stack. Its head
+ * holds the index of the first free node and a tag, which is incremented
+ * on every change to prevent the ABA problem. When the pool is exhausted,
+ * nodes are allocated on the heap.
+ */
+class EventPool
+{
+    std::unique_ptr<EventNode[]> _nodes;
+    uint32_t _size;
+    std::atomic<uint64_t> _freeHead;
+
+    EventPool(const EventPool&) = delete;
+    EventPool& operator=(const EventPool&) = delete;
+
+    EventNode* popFree();
+    void pushFree(EventNode* node);
+
+public:
+    explicit EventPool(uint32_t size);
+
+    /// Returns a node with a copy of the event; thread safe.
+    EventNode* create(const Event& ev);
+
+    /// Destroys the event and returns the node to the pool; thread safe.
+    void release(EventNode* node);
+};
+
+/**
+ * Lock free multi producer single consumer queue of events.
+ *
+ * Producers link their node with a single atomic exchange. Only the
+ * thread running the event loop may pop. A pop may fail while a producer
+ * is between the exchange and linking its node, so the number of pushed
+ * events is tracked separately to tell, that the queue is not empty. The
+ * event loop waits after a failed pop; the producer wakes it after linking.
+ */
+class EventQueue
+{
+    std::atomic<EventNode*> _head;
+    EventNode* _tail;
+    EventNode _stub;
+    std::atomic<unsigned> _size;
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    void link(EventNode* node);
+
+public:
+    EventQueue();
+
+    /// Appends a node; thread safe.
+    void push(EventNode* node);
+
+    /// Removes the first node; consumer only. Returns 0 if no node is available.
+    EventNode* pop();
+
+    unsigned size() const   { return _size.load(std::memory_order_acquire); }
+    bool empty() const      { return size() == 0; }
+};
+
+}
+
+#endif // CXXTOOLS_EVENTQUEUE_H
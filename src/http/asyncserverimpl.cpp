@@ -0,0 +1,626 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "asyncserverimpl.h"
+#include "socket.h"
+
+#include <cxxtools/eventloop.h>
+#include <cxxtools/eventloopgroup.h>
+#include <cxxtools/event.h>
+#include <cxxtools/log.h>
+#include <cxxtools/net/tcpserver.h>
+#include <cxxtools/timer.h>
+
+#include <algorithm>
+#include <future>
+#include <set>
+
+log_define("cxxtools.http.server.async")
+
+namespace cxxtools
+{
+namespace http
+{
+
+class AsyncServerStartEvent : public BasicEvent<AsyncServerStartEvent>
+{
+        const AsyncServerImpl* _server;
+
+    public:
+        explicit AsyncServerStartEvent(const AsyncServerImpl* server)
+            : _server(server)
+            { }
+
+        const AsyncServerImpl* server() const   { return _server; }
+};
+
+////////////////////////////////////////////////////////////////////////
+// AsyncServerImpl::IoLoop
+//
+class AsyncServerImpl::IoLoop : public Connectable
+{
+    public:
+        IoLoop(AsyncServerImpl& server, EventLoopGroup& group, unsigned n);
+        ~IoLoop();
+
+        // thread safe
+        void addListener(net::TcpServer* server, const SslCtx& sslCtx)
+        { _group.post(_n, [this, server, sslCtx] { onAddListener(server, sslCtx); }); }
+
+        // thread safe; the socket is already assigned to the loop
+        void addSocket(Socket* socket)
+        { _group.post(_n, [this, socket] { addConnection(socket); }); }
+
+        // thread safe
+        void requestProcessed(Socket* socket)
+        { _group.post(_n, [this, socket] { onRequestProcessed(socket); }); }
+
+        /// Stops accepting and dispatching requests; runs in the thread of the loop.
+        void shutdown();
+
+        /// Closes the connections; runs in the thread of the loop.
+        ///
+        /// Idle connections are closed at once. Connections, which are
+        /// still sending a reply, are closed when the reply is sent or
+        /// after the timeout. waitClosed() returns after that.
+        void close(Milliseconds timeout);
+
+        /// Waits until all connections are closed after close().
+        void waitClosed()
+        { _closed.get_future().wait(); }
+
+    private:
+        void onAddListener(net::TcpServer* server, const SslCtx& sslCtx);
+        void onConnectionPending(net::TcpServer& server);
+        void addConnection(Socket* socket);
+
+        void dispatch(Socket* socket);
+        void onRequestProcessed(Socket* socket);
+        void closeConnection(Socket* socket);
+
+        void onRequestReceived(Socket& socket);
+        void onDisconnected(Socket& socket);
+        void onClosed(net::TcpSocket& socket);
+
+        void closeIdle();
+
+        AsyncServerImpl& _server;
+        EventLoopGroup& _group;
+        unsigned _n;
+        EventLoop& _eventLoop;
+        bool _terminating;
+        std::vector<std::pair<net::TcpServer*, SslCtx>> _listeners;
+        std::set<Socket*> _sockets;
+
+        // state while closing
+        bool _closing;
+        Timespan _closeDeadline;
+        Timer _closeTimer;
+        std::promise<void> _closed;
+};
+
+AsyncServerImpl::IoLoop::IoLoop(AsyncServerImpl& server, EventLoopGroup& group, unsigned n)
+    : _server(server),
+      _group(group),
+      _n(n),
+      _eventLoop(group.loop(n)),
+      _terminating(false),
+      _closing(false)
+{
+    connect(_closeTimer.timeout, *this, &IoLoop::closeIdle);
+}
+
+AsyncServerImpl::IoLoop::~IoLoop()
+{
+    log_debug("delete " << _sockets.size() << " sockets");
+    for (std::set<Socket*>::iterator it = _sockets.begin(); it != _sockets.end(); ++it)
+    {
+        delete *it;
+        _group.release(_n);
+    }
+}
+
+void AsyncServerImpl::IoLoop::onAddListener(net::TcpServer* server, const SslCtx& sslCtx)
+{
+    _listeners.push_back(std::make_pair(server, sslCtx));
+    connect(server->connectionPending, *this, &IoLoop::onConnectionPending);
+    _eventLoop.add(*server);
+}
+
+void AsyncServerImpl::IoLoop::onConnectionPending(net::TcpServer& server)
+{
+    unsigned n = 0;
+    while (n < _listeners.size() && _listeners[n].first != &server)
+        ++n;
+
+    if (n >= _listeners.size())
+        return;
+
+    Socket* socket = new Socket(_server, server, _listeners[n].second, true);
+
+    try
+    {
+        socket->acceptConnection();
+    }
+    catch (const std::exception& e)
+    {
+        log_warn("accept failed: " << e.what());
+        delete socket;
+        return;
+    }
+
+    log_info("new connection accepted from " << socket->getPeerAddr());
+
+    _group.assign(_n);
+    addConnection(socket);
+}
+
+void AsyncServerImpl::IoLoop::addConnection(Socket* socket)
+{
+    log_debug("new connection " << static_cast<void*>(socket));
+
+    _sockets.insert(socket);
+    connect(socket->requestReceived, *this, &IoLoop::onRequestReceived);
+    connect(socket->disconnected, *this, &IoLoop::onDisconnected);
+    connect(socket->timeout, *this, &IoLoop::onDisconnected);
+    connect(socket->closed, *this, &IoLoop::onClosed);
+
+    try
+    {
+        socket->beginProcessing(_eventLoop);
+    }
+    catch (const std::exception& e)
+    {
+        log_warn("failed to process connection: " << e.what());
+        closeConnection(socket);
+    }
+}
+
+void AsyncServerImpl::IoLoop::onRequestReceived(Socket& socket)
+{
+    // The request is passed to the worker in a fresh event handler, so
+    // the worker does not touch the socket while we are still in its
+    // input callback.
+    socket.removeSelector();
+    Socket* s = &socket;
+    _group.post(_n, [this, s] { dispatch(s); });
+}
+
+void AsyncServerImpl::IoLoop::dispatch(Socket* socket)
+{
+    // the socket may be closed by closeIdle while the dispatch was queued
+    if (_sockets.count(socket) == 0)
+        return;
+
+    if (_terminating)
+    {
+        log_debug("server terminating; close connection " << static_cast<void*>(socket));
+        socket->close();
+        closeConnection(socket);
+    }
+    else
+    {
+        _server.dispatch(socket, this);
+    }
+}
+
+void AsyncServerImpl::IoLoop::onRequestProcessed(Socket* socket)
+{
+    try
+    {
+        socket->finishRequest(_eventLoop);
+    }
+    catch (const std::exception& e)
+    {
+        log_warn("failed to send reply: " << e.what());
+        socket->close();
+        onDisconnected(*socket);
+    }
+}
+
+void AsyncServerImpl::IoLoop::onDisconnected(Socket& socket)
+{
+    log_debug("connection " << static_cast<void*>(&socket) << " finished");
+    socket.removeSelector();
+
+    // While closing, closeIdle deletes the socket, since it is not
+    // writing any more. A posted close might outlive the io loop.
+    if (_closing)
+        return;
+
+    Socket* s = &socket;
+    _group.post(_n, [this, s] { closeConnection(s); });
+}
+
+void AsyncServerImpl::IoLoop::onClosed(net::TcpSocket& socket)
+{
+    onDisconnected(static_cast<Socket&>(socket));
+}
+
+void AsyncServerImpl::IoLoop::closeConnection(Socket* socket)
+{
+    // a socket may be reported more than once
+    if (_sockets.erase(socket))
+    {
+        log_debug("delete " << static_cast<void*>(socket));
+        delete socket;
+        _group.release(_n);
+
+        if (_closing)
+            closeIdle();
+    }
+}
+
+void AsyncServerImpl::IoLoop::shutdown()
+{
+    _terminating = true;
+    for (unsigned n = 0; n < _listeners.size(); ++n)
+        _listeners[n].first->setSelector(0);
+    _listeners.clear();
+}
+
+void AsyncServerImpl::IoLoop::close(Milliseconds timeout)
+{
+    log_debug("close " << _sockets.size() << " connections");
+    _closing = true;
+    _closeDeadline = Timespan::gettimeofday() + timeout;
+    closeIdle();
+
+    if (_closing)
+    {
+        // We are not notified when a reply is sent completely, so the
+        // connections are checked periodically.
+        _closeTimer.setSelector(_eventLoop);
+        _closeTimer.start(Milliseconds(10));
+    }
+}
+
+void AsyncServerImpl::IoLoop::closeIdle()
+{
+    bool expired = Timespan::gettimeofday() >= _closeDeadline;
+
+    std::set<Socket*>::iterator it = _sockets.begin();
+    while (it != _sockets.end())
+    {
+        Socket* socket = *it;
+        if (expired || !socket->writing())
+        {
+            if (socket->writing())
+                log_warn("reply to " << socket->getPeerAddr() << " not sent completely before shutdown");
+
+            _sockets.erase(it++);
+            delete socket;
+            _group.release(_n);
+        }
+        else
+            ++it;
+    }
+
+    if (_sockets.empty())
+    {
+        log_debug("all connections closed");
+        _closing = false;
+        _closeTimer.setSelector(0);
+        _closed.set_value();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// AsyncServerImpl
+//
+AsyncServerImpl::AsyncServerImpl(EventLoopBase& eventLoop, Signal<Server::Runmode>& runmodeChanged)
+    : ServerImplBase(eventLoop, runmodeChanged),
+      _group(0),
+      _ownGroup(0)
+{
+    _eventLoop.event.subscribe(slot(*this, &AsyncServerImpl::onServerStart));
+
+    connect(_eventLoop.exited, *this, &AsyncServerImpl::terminate);
+
+    _eventLoop.commitEvent(AsyncServerStartEvent(this));
+}
+
+AsyncServerImpl::~AsyncServerImpl()
+{
+    if (runmode() == Server::Running)
+    {
+        try
+        {
+            terminate();
+        }
+        catch (const std::exception& e)
+        {
+            log_fatal("exception in http-server termination occured: " << e.what());
+        }
+    }
+
+    for (std::vector<IoLoop*>::iterator it = _ioLoops.begin(); it != _ioLoops.end(); ++it)
+        delete *it;
+
+    delete _ownGroup;
+
+    for (std::vector<Listener>::iterator it = _listeners.begin(); it != _listeners.end(); ++it)
+        delete it->server;
+}
+
+unsigned AsyncServerImpl::ioLoopCount() const
+{
+    if (_group)
+        return _group->size();
+    if (eventLoopGroup())
+        return eventLoopGroup()->size();
+    return std::max(ioThreads(), 1u);
+}
+
+void AsyncServerImpl::listen(const std::string& ip, unsigned short int port, const SslCtx& sslCtx)
+{
+    log_debug("listen on ip <" << ip << "> port " << port << " ssl " << sslCtx.enabled());
+
+    std::vector<net::TcpServer*> servers = createListeners(ip, port, 1024, ioLoopCount());
+
+    for (unsigned n = 0; n < servers.size(); ++n)
+    {
+        Listener listener;
+        listener.server = servers[n];
+        listener.sslCtx = sslCtx;
+        listener.shared = servers.size() == 1;
+        listener.ioLoop = n;
+
+        try
+        {
+            _listeners.push_back(listener);
+        }
+        catch (...)
+        {
+            for (; n < servers.size(); ++n)
+                delete servers[n];
+            throw;
+        }
+
+        if (listener.shared)
+            connect(listener.server->connectionPending, *this, &AsyncServerImpl::onConnectionPending);
+
+        if (runmode() == Server::Running)
+            attachListener(listener);
+    }
+}
+
+void AsyncServerImpl::attachListener(const Listener& listener)
+{
+    if (listener.shared)
+        _eventLoop.add(*listener.server);
+    else
+        _ioLoops[listener.ioLoop % _ioLoops.size()]->addListener(listener.server, listener.sslCtx);
+}
+
+void AsyncServerImpl::onServerStart(const AsyncServerStartEvent& event)
+{
+    if (event.server() == this)
+        start();
+}
+
+void AsyncServerImpl::start()
+{
+    log_trace("start server");
+    runmode(Server::Starting);
+
+    _group = eventLoopGroup();
+    if (_group == 0)
+    {
+        log_debug("start " << ioLoopCount() << " io loops");
+        _group = _ownGroup = new EventLoopGroup(ioLoopCount());
+    }
+    else
+    {
+        log_debug("use shared group of " << _group->size() << " event loops");
+    }
+
+    if (!_group->running())
+        _group->start();
+
+    while (_ioLoops.size() < _group->size())
+        _ioLoops.push_back(new IoLoop(*this, *_group, _ioLoops.size()));
+
+    {
+        std::lock_guard<std::mutex> lock(_workerMutex);
+        while (_workers.size() < minThreads())
+            startWorker();
+    }
+
+    for (std::vector<Listener>::iterator it = _listeners.begin(); it != _listeners.end(); ++it)
+        attachListener(*it);
+
+    runmode(Server::Running);
+}
+
+void AsyncServerImpl::terminate()
+{
+    log_trace("terminate");
+
+    if (runmode() != Server::Running)
+        return;
+
+    runmode(Server::Terminating);
+
+    try
+    {
+        for (std::vector<Listener>::iterator it = _listeners.begin(); it != _listeners.end(); ++it)
+            if (it->shared)
+                it->server->setSelector(0);
+
+        // The io loops may be shared with other servers and keep running.
+        // Our part of them is shut down in their threads.
+        log_debug("shut down " << _ioLoops.size() << " io loops");
+        for (unsigned n = 0; n < _ioLoops.size(); ++n)
+        {
+            IoLoop* ioLoop = _ioLoops[n];
+            _group->execute(n, [ioLoop] { ioLoop->shutdown(); });
+        }
+
+        // No more requests are dispatched now. The workers finish the
+        // queued requests before they see the terminating jobs.
+        log_debug("terminate " << _workers.size() << " threads");
+        {
+            std::lock_guard<std::mutex> lock(_workerMutex);
+            Job job = { 0, 0 };
+            for (std::vector<std::thread>::size_type n = 0; n < _workers.size(); ++n)
+                _jobs.put(job);
+        }
+
+        for (std::vector<std::thread>::iterator it = _workers.begin(); it != _workers.end(); ++it)
+            it->join();
+        _workers.clear();
+
+        // The replies of the last requests are queued in the io loops
+        // before the close. Replies still being sent get up to the write
+        // timeout to finish before the connections are closed.
+        // When the close runs in our own thread (the group is not running
+        // or we are called from the loop), nobody would run the loop while
+        // we wait, so the connections are closed at once.
+        Milliseconds timeout = writeTimeout();
+        std::thread::id caller = std::this_thread::get_id();
+        for (unsigned n = 0; n < _ioLoops.size(); ++n)
+        {
+            IoLoop* ioLoop = _ioLoops[n];
+            _group->execute(n, [ioLoop, timeout, caller] {
+                ioLoop->close(std::this_thread::get_id() == caller ? Milliseconds(0) : timeout);
+            });
+        }
+
+        for (unsigned n = 0; n < _ioLoops.size(); ++n)
+            _ioLoops[n]->waitClosed();
+
+        // Functions posted to the loops before may still refer to the io
+        // loops, so they are run before the io loops are deleted. When
+        // execute runs in our own thread, the queue is processed here.
+        for (unsigned n = 0; n < _ioLoops.size(); ++n)
+        {
+            EventLoop& loop = _group->loop(n);
+            _group->execute(n, [&loop] { loop.processEvents(); });
+        }
+
+        for (std::vector<IoLoop*>::iterator it = _ioLoops.begin(); it != _ioLoops.end(); ++it)
+            delete *it;
+        _ioLoops.clear();
+
+        delete _ownGroup;
+        _ownGroup = 0;
+        _group = 0;
+
+        runmode(Server::Stopped);
+    }
+    catch (const std::exception& e)
+    {
+        log_error("failed to terminate server: " << e.what());
+        runmode(Server::Failed);
+    }
+}
+
+void AsyncServerImpl::onConnectionPending(net::TcpServer& server)
+{
+    std::vector<Listener>::iterator listener = _listeners.begin();
+    while (listener != _listeners.end() && listener->server != &server)
+        ++listener;
+
+    if (listener == _listeners.end() || _ioLoops.empty())
+        return;
+
+    Socket* socket = new Socket(*this, server, listener->sslCtx, true);
+
+    try
+    {
+        socket->acceptConnection();
+    }
+    catch (const std::exception& e)
+    {
+        log_warn("accept failed: " << e.what());
+        delete socket;
+        return;
+    }
+
+    log_info("new connection accepted from " << socket->getPeerAddr());
+
+    _ioLoops[_group->assign()]->addSocket(socket);
+}
+
+void AsyncServerImpl::dispatch(Socket* socket, IoLoop* ioLoop)
+{
+    if (_jobs.numWaiting() == 0)
+    {
+        std::lock_guard<std::mutex> lock(_workerMutex);
+        if (_workers.size() < maxThreads())
+        {
+            try
+            {
+                startWorker();
+            }
+            catch (const std::exception& e)
+            {
+                log_warn("failed to create thread: " << e.what());
+            }
+        }
+    }
+
+    Job job = { socket, ioLoop };
+    _jobs.put(job);
+}
+
+void AsyncServerImpl::startWorker()
+{
+    _workers.push_back(std::thread(&AsyncServerImpl::runWorker, this));
+    log_debug(_workers.size() << " worker threads running");
+}
+
+void AsyncServerImpl::runWorker()
+{
+    log_info("new thread running");
+
+    while (true)
+    {
+        Job job = _jobs.get();
+        if (job.socket == 0)
+            break;
+
+        try
+        {
+            job.socket->processRequest();
+        }
+        catch (const std::exception& e)
+        {
+            log_warn("error processing request: " << e.what());
+            job.socket->close();
+        }
+
+        job.ioLoop->requestProcessed(job.socket);
+    }
+
+    log_info("thread terminated");
+}
+
+}
+}
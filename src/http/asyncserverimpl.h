@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_HTTP_ASYNCSERVERIMPL_H
+#define CXXTOOLS_HTTP_ASYNCSERVERIMPL_H
+
+#include "serverimplbase.h"
+#include <cxxtools/queue.h>
+#include <cxxtools/sslctx.h>
+#include <cxxtools/connectable.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cxxtools
+{
+
+class EventLoopGroup;
+
+namespace net
+{
+    class TcpServer;
+}
+
+namespace http
+{
+
+class Socket;
+class AsyncServerStartEvent;
+
+/// Server implementation for Server::EventLoops mode.
+///
+/// Connections are handled by a number of io loops, one for each loop of
+/// an EventLoopGroup. The group is either shared with other servers or
+/// created by the server with ioThreads loops. With reusePort each io loop
+/// accepts on its own listener. Otherwise the listeners are served by the
+/// event loop of the server, which assigns accepted connections to the io
+/// loops according to the assignment policy of the group. The io loops read
+/// requests without blocking and pass complete requests to a pool of worker
+/// threads, which run the responders. The reply is then sent back by the io
+/// loop.
+class AsyncServerImpl : public ServerImplBase, public Connectable
+{
+    public:
+        class IoLoop;
+
+        AsyncServerImpl(EventLoopBase& eventLoop, Signal<Server::Runmode>& runmodeChanged);
+        ~AsyncServerImpl();
+
+        // override from ServerImplBase
+        void listen(const std::string& ip, unsigned short int port, const SslCtx& sslCtx) override;
+
+        // override from ServerImplBase
+        void terminate() override;
+
+        /// Passes a complete request to the worker threads.
+        void dispatch(Socket* socket, IoLoop* ioLoop);
+
+    private:
+        struct Job
+        {
+            Socket* socket;
+            IoLoop* ioLoop;
+        };
+
+        struct Listener
+        {
+            net::TcpServer* server;
+            SslCtx sslCtx;
+            bool shared;  // accepted by the event loop of the server
+            unsigned ioLoop;
+        };
+
+        void onServerStart(const AsyncServerStartEvent& event);
+        void start();
+        void attachListener(const Listener& listener);
+        void onConnectionPending(net::TcpServer& server);
+        void runWorker();
+        void startWorker();
+        unsigned ioLoopCount() const;
+
+        std::vector<Listener> _listeners;
+        std::vector<IoLoop*> _ioLoops;
+        EventLoopGroup* _group;
+        EventLoopGroup* _ownGroup;
+
+        Queue<Job> _jobs;
+        std::vector<std::thread> _workers;
+        std::mutex _workerMutex;
+};
+
+}
+}
+
+#endif // CXXTOOLS_HTTP_ASYNCSERVERIMPL_H
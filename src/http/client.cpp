@@ -32,6 +32,7 @@
 #include <cxxtools/net/uri.h>
 #include <cxxtools/sslctx.h>
 #include "clientimpl.h"
+#include <stdexcept>
 
 namespace cxxtools {
 
@@ -134,6 +135,47 @@ const ReplyHeader& Client::execute(const Request& request, Milliseconds timeout,
     }
 }
 
+void Client::sendRequest(const Request& request, Milliseconds timeout, Milliseconds connectTimeout)
+{
+    try
+    {
+        getImpl()->sendPipelined(request, timeout, connectTimeout);
+    }
+    catch (...)
+    {
+        cancel();
+        throw;
+    }
+}
+
+const Reply& Client::readReply(Milliseconds timeout)
+{
+    if (pendingReplies() == 0)
+        throw std::logic_error("no pipelined HTTP request pending");
+
+    try
+    {
+        getImpl()->readPipelined(timeout);
+    }
+    catch (...)
+    {
+        cancel();
+        throw;
+    }
+
+    return _impl->reply();
+}
+
+unsigned Client::pendingReplies() const
+{
+    return _impl ? _impl->pipelined() : 0;
+}
+
+bool Client::isConnected() const
+{
+    return _impl && _impl->isConnected();
+}
+
 const Reply& Client::reply() const
 {
     return _impl->reply();
@@ -62,7 +62,8 @@ ClientImpl::ClientImpl(Client* client)
   _readHeader(true),
   _chunkedEncoding(false),
   _reconnectOnError(false),
-  _exceptionPending(false)
+  _exceptionPending(false),
+  _pipelined(0)
 {
     _stream.attachDevice(_socket);
     cxxtools::connect(_socket.connected, *this, &ClientImpl::onConnect);
@@ -121,17 +122,14 @@ const ReplyHeader& ClientImpl::execute(const Request& request, Timespan timeout,
 {
     log_trace("execute request " << request.url());
 
-    if (_chunkedEncoding)
+    if (_pipelined > 0)
     {
-        while (_chunkedIStream)
-            _chunkedIStream.get();
-    }
-    else
-    {
-        while (_bodyStream)
-            _bodyStream.get();
+        log_debug("discard " << _pipelined << " pipelined replies");
+        cancel();
     }
 
+    discardBody();
+
     if (connectTimeout < Timespan(0))
         connectTimeout = timeout;
 
@@ -187,6 +185,27 @@ const ReplyHeader& ClientImpl::execute(const Request& request, Timespan timeout,
 
     log_debug("reply ready");
 
+    beginBody();
+
+    return _reply.header();
+}
+
+void ClientImpl::discardBody()
+{
+    if (_chunkedEncoding)
+    {
+        while (_chunkedIStream)
+            _chunkedIStream.get();
+    }
+    else
+    {
+        while (_bodyStream)
+            _bodyStream.get();
+    }
+}
+
+void ClientImpl::beginBody()
+{
     if (_stream.fail())
         throw IOError("failed to read HTTP reply");
 
@@ -211,8 +230,56 @@ const ReplyHeader& ClientImpl::execute(const Request& request, Timespan timeout,
         log_debug("content length " << n);
 
     }
+}
 
-    return _reply.header();
+void ClientImpl::sendPipelined(const Request& request, Timespan timeout, Timespan connectTimeout)
+{
+    log_trace("send pipelined request " << request.url());
+
+    if (_pipelined == 0)
+        discardBody();
+
+    if (connectTimeout < Timespan(0))
+        connectTimeout = timeout;
+
+    if (!_socket.isConnected())
+    {
+        _socket.setTimeout(connectTimeout);
+
+        log_debug("connect");
+        _socket.connect(_addrInfo);
+
+        if (_sslCtx.enabled())
+        {
+            log_debug("ssl connect");
+            _socket.sslConnect(_sslCtx);
+        }
+    }
+
+    _socket.setTimeout(timeout);
+
+    sendRequest(request);
+    _stream.flush();
+
+    if (!_stream)
+        throw IOError("error sending HTTP request");
+
+    ++_pipelined;
+}
+
+void ClientImpl::readPipelined(Timespan timeout)
+{
+    --_pipelined;
+
+    _reply.clear();
+    _socket.setTimeout(timeout);
+
+    _parser.reset(true);
+    _readHeader = true;
+    doparse();
+
+    beginBody();
+    readBody();
 }
 
 
@@ -729,6 +796,7 @@ void ClientImpl::processBodyAvailable(StreamBuffer& sb)
 
 void ClientImpl::cancel()
 {
+    _pipelined = 0;
     _socket.close();
     _stream.clear();
     _stream.buffer().discard();
@@ -97,8 +97,11 @@ class ClientImpl : public RefCounted, public Connectable
         bool _chunkedEncoding;
         bool _reconnectOnError;
         bool _exceptionPending;
+        unsigned _pipelined;
 
         void sendRequest(const Request& request);
+        void discardBody();
+        void beginBody();
         void processHeaderAvailable(StreamBuffer& sb);
         void processBodyAvailable(StreamBuffer& sb);
 
@@ -152,6 +155,18 @@ class ClientImpl : public RefCounted, public Connectable
         // This method blocks until the body is received.
         void readBody();
 
+        // Sends a request without waiting for the reply (http pipelining).
+        void sendPipelined(const Request& request, Timespan timeout, Timespan connectTimeout);
+
+        // Reads header and body of the next pipelined reply.
+        void readPipelined(Timespan timeout);
+
+        unsigned pipelined() const
+        { return _pipelined; }
+
+        bool isConnected() const
+        { return _socket.isConnected(); }
+
         std::string body() const
         { return _reply.body(); }
 
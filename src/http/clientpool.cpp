@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/http/clientpool.h>
+#include <cxxtools/log.h>
+
+log_define("cxxtools.http.clientpool")
+
+namespace cxxtools
+{
+namespace http
+{
+
+////////////////////////////////////////////////////////////////////////
+// PooledClient
+//
+PooledClient& PooledClient::operator=(PooledClient&& other)
+{
+    if (this != &other)
+    {
+        release();
+        _pool = other._pool;
+        _server = other._server;
+        _client = other._client;
+        other._client = 0;
+    }
+
+    return *this;
+}
+
+void PooledClient::release()
+{
+    if (_client)
+    {
+        Client* client = _client;
+        _client = 0;
+        _pool->release(_server, client, true);
+    }
+}
+
+void PooledClient::discard()
+{
+    if (_client)
+    {
+        Client* client = _client;
+        _client = 0;
+        _pool->release(_server, client, false);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// ClientPool
+//
+ClientPool::~ClientPool()
+{
+    clear();
+}
+
+PooledClient ClientPool::acquire(const std::string& host, unsigned short port, const SslCtx& sslCtx)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // impl() would create a context for a disabled SslCtx
+    Key key(host, port, sslCtx.enabled() ? sslCtx.impl() : 0);
+    Server& server = _servers[key];
+
+    while (server.idle.empty() && server.active >= _maxConnections)
+    {
+        log_debug("all " << server.active << " connections to " << host << ':' << port << " in use - wait");
+        _released.wait(lock);
+    }
+
+    ++server.active;
+
+    if (!server.idle.empty())
+    {
+        Client* client = server.idle.back();
+        server.idle.pop_back();
+        log_debug("reuse connection to " << host << ':' << port);
+        return PooledClient(this, &server, client);
+    }
+
+    server.sslCtx = sslCtx;
+    lock.unlock();
+
+    log_debug("new client for " << host << ':' << port);
+
+    Client* client;
+    try
+    {
+        client = new Client(host, port, sslCtx);
+    }
+    catch (...)
+    {
+        lock.lock();
+        --server.active;
+        _released.notify_one();
+        throw;
+    }
+
+    return PooledClient(this, &server, client);
+}
+
+void ClientPool::release(Server* server, Client* client, bool reuse)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        --server->active;
+
+        if (reuse && client->isConnected() && client->pendingReplies() == 0
+            && server->idle.size() < _maxIdle)
+        {
+            server->idle.push_back(client);
+            client = 0;
+        }
+
+        _released.notify_all();
+    }
+
+    if (client)
+    {
+        log_debug("close connection to " << client->host() << ':' << client->port());
+        delete client;
+    }
+}
+
+void ClientPool::maxConnections(unsigned n)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxConnections = n;
+    _released.notify_all();
+}
+
+void ClientPool::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (Servers::iterator it = _servers.begin(); it != _servers.end(); ++it)
+    {
+        for (unsigned n = 0; n < it->second.idle.size(); ++n)
+            delete it->second.idle[n];
+        it->second.idle.clear();
+    }
+}
+
+}
+}
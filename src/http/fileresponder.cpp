@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "fileresponder.h"
+#include <cxxtools/http/request.h>
+#include <cxxtools/http/reply.h>
+#include <cxxtools/datetime.h>
+#include <cxxtools/log.h>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+log_define("cxxtools.http.fileresponder")
+
+namespace cxxtools
+{
+namespace http
+{
+
+namespace
+{
+    struct MimeType
+    {
+        const char* ext;
+        const char* type;
+    };
+
+    const MimeType mimeTypes[] = {
+        { "css",  "text/css" },
+        { "gif",  "image/gif" },
+        { "htm",  "text/html" },
+        { "html", "text/html" },
+        { "ico",  "image/x-icon" },
+        { "jpeg", "image/jpeg" },
+        { "jpg",  "image/jpeg" },
+        { "js",   "application/javascript" },
+        { "json", "application/json" },
+        { "pdf",  "application/pdf" },
+        { "png",  "image/png" },
+        { "svg",  "image/svg+xml" },
+        { "txt",  "text/plain" },
+        { "xml",  "application/xml" },
+        { 0, 0 }
+    };
+
+    const char* mimeType(const std::string& fname)
+    {
+        std::string::size_type p = fname.find_last_of("./");
+        if (p != std::string::npos && fname[p] == '.')
+        {
+            const char* ext = fname.c_str() + p + 1;
+            for (const MimeType* m = mimeTypes; m->ext; ++m)
+                if (strcasecmp(ext, m->ext) == 0)
+                    return m->type;
+        }
+
+        return "application/octet-stream";
+    }
+
+    int hexValue(char ch)
+    {
+        if (ch >= '0' && ch <= '9')
+            return ch - '0';
+        if (ch >= 'a' && ch <= 'f')
+            return ch - 'a' + 10;
+        if (ch >= 'A' && ch <= 'F')
+            return ch - 'A' + 10;
+        return -1;
+    }
+
+    // Parses a range header with a single byte range. Returns -1 if the
+    // header is not understood and should be ignored, 0 if the range is
+    // not satisfiable and 1 if a valid range was found.
+    int parseRange(const char* s, off_t size, off_t& first, off_t& last)
+    {
+        if (strncmp(s, "bytes=", 6) != 0 || strchr(s, ',') != 0)
+            return -1;
+
+        s += 6;
+
+        char* end;
+        if (*s == '-')
+        {
+            // suffix range: the last n bytes
+            if (!isdigit(static_cast<unsigned char>(s[1])))
+                return -1;
+
+            off_t n = strtoll(s + 1, &end, 10);
+            if (*end != '\0')
+                return -1;
+
+            if (n == 0 || size == 0)
+                return 0;
+
+            first = n >= size ? 0 : size - n;
+            last = size - 1;
+            return 1;
+        }
+
+        if (!isdigit(static_cast<unsigned char>(*s)))
+            return -1;
+
+        first = strtoll(s, &end, 10);
+        if (*end != '-')
+            return -1;
+
+        s = end + 1;
+        if (*s == '\0')
+        {
+            last = size - 1;
+        }
+        else
+        {
+            if (!isdigit(static_cast<unsigned char>(*s)))
+                return -1;
+            last = strtoll(s, &end, 10);
+            if (*end != '\0' || last < first)
+                return -1;
+            if (last >= size)
+                last = size - 1;
+        }
+
+        return first < size ? 1 : 0;
+    }
+}
+
+std::string FileResponder::fileName(const std::string& url) const
+{
+    const std::string& prefix = _fileService.prefix();
+    if (url.compare(0, prefix.size(), prefix) != 0)
+        return std::string();
+
+    std::string path;
+    for (std::string::size_type n = prefix.size(); n < url.size(); ++n)
+    {
+        char ch = url[n];
+        if (ch == '%' && n + 2 < url.size()
+            && hexValue(url[n + 1]) >= 0 && hexValue(url[n + 2]) >= 0)
+        {
+            ch = static_cast<char>(hexValue(url[n + 1]) * 16 + hexValue(url[n + 2]));
+            n += 2;
+        }
+
+        if (ch == '\0')
+            return std::string();
+
+        path += ch;
+    }
+
+    // do not allow to leave the document root
+    std::string::size_type b = 0;
+    while (b <= path.size())
+    {
+        std::string::size_type e = path.find('/', b);
+        if (e == std::string::npos)
+            e = path.size();
+        if (path.compare(b, e - b, "..") == 0)
+            return std::string();
+        b = e + 1;
+    }
+
+    if (path.empty() || path[0] != '/')
+        path.insert(0, 1, '/');
+
+    return _fileService.documentRoot() + path;
+}
+
+void FileResponder::reply(std::ostream& /*out*/, Request& request, Reply& reply)
+{
+    bool head = request.method() == "HEAD";
+    if (!head && request.method() != "GET")
+    {
+        reply.httpReturn(405, "Method Not Allowed");
+        reply.setHeader("Allow", "GET, HEAD");
+        return;
+    }
+
+    std::string fname = fileName(request.url());
+    if (fname.empty())
+    {
+        log_debug("invalid url \"" << request.url() << '"');
+        reply.httpReturn(404, "Not found");
+        return;
+    }
+
+    int fd = ::open(fname.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        log_debug("failed to open file \"" << fname << "\": " << strerror(errno));
+        reply.httpReturn(404, "Not found");
+        return;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        log_debug("\"" << fname << "\" is not a regular file");
+        ::close(fd);
+        reply.httpReturn(404, "Not found");
+        return;
+    }
+
+    DateTime lastModified = DateTime::fromMSecsSinceEpoch(Seconds(st.st_mtime));
+
+    const char* ims = request.getHeader("If-Modified-Since");
+    DateTime since;
+    if (ims && MessageHeader::parseHtdate(ims, since) && lastModified <= since)
+    {
+        log_debug("file \"" << fname << "\" not modified");
+        ::close(fd);
+        reply.httpReturn(304, "Not Modified");
+        return;
+    }
+
+    char buffer[50];
+    reply.setHeader("Last-Modified", MessageHeader::htdate(lastModified, buffer));
+    reply.setHeader("Accept-Ranges", "bytes");
+    if (!reply.hasHeader("Content-Type"))
+        reply.setHeader("Content-Type", mimeType(fname));
+
+    off_t first = 0;
+    off_t last = st.st_size - 1;
+
+    const char* range = request.getHeader("Range");
+    if (range)
+    {
+        int r = parseRange(range, st.st_size, first, last);
+        if (r == 0)
+        {
+            log_debug("range \"" << range << "\" not satisfiable for size " << st.st_size);
+            ::close(fd);
+            snprintf(buffer, sizeof(buffer), "bytes */%lld", static_cast<long long>(st.st_size));
+            reply.httpReturn(416, "Range Not Satisfiable");
+            reply.setHeader("Content-Range", buffer);
+            return;
+        }
+
+        if (r > 0)
+        {
+            snprintf(buffer, sizeof(buffer), "bytes %lld-%lld/%lld",
+                static_cast<long long>(first), static_cast<long long>(last),
+                static_cast<long long>(st.st_size));
+            reply.httpReturn(206, "Partial Content");
+            reply.setHeader("Content-Range", buffer);
+        }
+        else
+        {
+            first = 0;
+            last = st.st_size - 1;
+        }
+    }
+
+    std::size_t size = static_cast<std::size_t>(last - first + 1);
+
+    if (head)
+    {
+        snprintf(buffer, sizeof(buffer), "%lu", static_cast<unsigned long>(size));
+        reply.setHeader("Content-Length", buffer);
+        ::close(fd);
+        return;
+    }
+
+    log_debug("send file \"" << fname << "\" offset " << first << " size " << size);
+    reply.bodyFile(fd, static_cast<std::size_t>(first), size);
+}
+
+}
+}
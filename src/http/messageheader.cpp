@@ -184,6 +184,11 @@ bool MessageHeader::keepAlive() const
 }
 
 char* MessageHeader::htdateCurrent(char* buffer)
+{
+    return htdate(Clock::getSystemTime(), buffer);
+}
+
+char* MessageHeader::htdate(const DateTime& dt, char* buffer)
 {
     int year = 0;
     unsigned month = 0;
@@ -193,7 +198,6 @@ char* MessageHeader::htdateCurrent(char* buffer)
     unsigned sec = 0;
     unsigned msec = 0;
 
-    DateTime dt = Clock::getSystemTime();
     dt.get(year, month, day, hour, min, sec, msec);
     unsigned dayOfWeek = dt.date().dayOfWeek();
 
@@ -206,6 +210,20 @@ char* MessageHeader::htdateCurrent(char* buffer)
     return buffer;
 }
 
+bool MessageHeader::parseHtdate(const std::string& s, DateTime& dt)
+{
+    try
+    {
+        dt = DateTime(s, "#, %d %O %Y %H:%M:%S GMT");
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        log_debug("invalid http date \"" << s << "\": " << e.what());
+        return false;
+    }
+}
+
 } // namespace http
 
 } // namespace cxxtools
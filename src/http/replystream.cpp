@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "replystream.h"
+#include <cxxtools/streambuffer.h>
+#include <cxxtools/log.h>
+#include <stdexcept>
+#include <stdio.h>
+
+log_define("cxxtools.http.replystream")
+
+namespace cxxtools
+{
+namespace http
+{
+
+ReplyStreamBuf::ReplyStreamBuf(StreamBuffer& sb, unsigned bufsize)
+    : _sb(sb),
+      _buffer(0),
+      _bufsize(bufsize),
+      _chunked(false),
+      _count(0)
+{
+}
+
+void ReplyStreamBuf::begin(bool chunked)
+{
+    _chunked = chunked;
+    _count = 0;
+    setp(0, 0);
+}
+
+void ReplyStreamBuf::writeData(const char* data, std::size_t n)
+{
+    if (n == 0)
+        return;
+
+    log_debug("send " << n << " bytes of reply body");
+
+    if (_chunked)
+    {
+        char size[24];
+        int len = snprintf(size, sizeof(size), "%lx\r\n", static_cast<unsigned long>(n));
+        _sb.sputn(size, len);
+    }
+
+    _sb.writeBorrowed(data, n);
+
+    if (_chunked)
+        _sb.sputn("\r\n", 2);
+
+    // blocks until the peer has read the data, so the borrowed buffer is
+    // released and no more than one buffer is held per connection
+    if (_sb.pubsync() != 0)
+        throw std::runtime_error("failed to send reply body");
+
+    _count += n;
+}
+
+void ReplyStreamBuf::flushBuffer()
+{
+    if (pptr() > pbase())
+    {
+        std::size_t n = pptr() - pbase();
+        setp(_buffer, _buffer + _bufsize);
+        writeData(_buffer, n);
+    }
+}
+
+void ReplyStreamBuf::finish()
+{
+    flushBuffer();
+
+    if (_chunked)
+    {
+        _sb.sputn("0\r\n\r\n", 5);
+        if (_sb.pubsync() != 0)
+            throw std::runtime_error("failed to send reply body");
+    }
+}
+
+int ReplyStreamBuf::sync()
+{
+    flushBuffer();
+    return 0;
+}
+
+ReplyStreamBuf::int_type ReplyStreamBuf::overflow(int_type ch)
+{
+    if (_buffer == 0)
+        _buffer = new char[_bufsize];
+
+    if (pptr() == 0)
+        setp(_buffer, _buffer + _bufsize);
+    else
+        flushBuffer();
+
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize ReplyStreamBuf::xsputn(const char* s, std::streamsize n)
+{
+    if (pptr() != 0 && n <= epptr() - pptr())
+    {
+        traits_type::copy(pptr(), s, n);
+        pbump(n);
+        return n;
+    }
+
+    if (static_cast<std::size_t>(n) < _bufsize)
+        return std::streambuf::xsputn(s, n);
+
+    // large blocks are sent without copying them to the buffer
+    flushBuffer();
+    writeData(s, n);
+    return n;
+}
+
+}
+}
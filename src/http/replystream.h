@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_HTTP_REPLYSTREAM_H
+#define CXXTOOLS_HTTP_REPLYSTREAM_H
+
+#include <streambuf>
+#include <ostream>
+
+namespace cxxtools
+{
+class StreamBuffer;
+
+namespace http
+{
+
+/// Stream buffer, which sends a reply body directly to the connection.
+///
+/// The data is collected in a buffer of fixed size. When it is full it is
+/// passed to the stream buffer of the connection as a borrowed buffer and
+/// flushed, so that the caller blocks until the peer has read it. Larger
+/// writes are passed directly without copying.
+class ReplyStreamBuf : public std::streambuf
+{
+        StreamBuffer& _sb;
+        char* _buffer;
+        unsigned _bufsize;
+        bool _chunked;
+        std::size_t _count;
+
+        void writeData(const char* data, std::size_t n);
+        void flushBuffer();
+
+    public:
+        explicit ReplyStreamBuf(StreamBuffer& sb, unsigned bufsize = 16384);
+        ~ReplyStreamBuf()  { delete[] _buffer; }
+
+        /// Starts a new body. When \a chunked is set, chunked transfer
+        /// encoding is used.
+        void begin(bool chunked);
+
+        /// Sends the remaining data and the terminating chunk.
+        void finish();
+
+        /// Returns the number of bytes of body data written.
+        std::size_t count() const   { return _count + (pptr() - pbase()); }
+
+        virtual int sync();
+        virtual int_type overflow(int_type ch);
+        virtual std::streamsize xsputn(const char* s, std::streamsize n);
+};
+
+class ReplyOStream : public std::ostream
+{
+        ReplyStreamBuf _streambuf;
+
+    public:
+        explicit ReplyOStream(StreamBuffer& sb)
+            : std::ostream(0),
+              _streambuf(sb)
+        {
+            init(&_streambuf);
+        }
+
+        void begin(bool chunked)
+        {
+            _streambuf.begin(chunked);
+            clear();
+            exceptions(std::ios::badbit);
+        }
+
+        void finish()               { _streambuf.finish(); }
+        std::size_t count() const   { return _streambuf.count(); }
+};
+
+}
+}
+
+#endif // CXXTOOLS_HTTP_REPLYSTREAM_H
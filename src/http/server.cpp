@@ -31,6 +31,7 @@
 #include <cxxtools/eventloop.h>
 #include <cxxtools/log.h>
 #include "serverimpl.h"
+#include "asyncserverimpl.h"
 
 log_define("cxxtools.http.server")
 
@@ -38,8 +39,10 @@ namespace cxxtools {
 
 namespace http {
 
-ServerImplBase* Server::newImpl(EventLoopBase& eventLoop)
+ServerImplBase* Server::newImpl(EventLoopBase& eventLoop, ThreadingMode mode)
 {
+    if (mode == EventLoops)
+        return new AsyncServerImpl(eventLoop, runmodeChanged);
     return new ServerImpl(eventLoop, runmodeChanged);
 }
 
@@ -110,6 +113,16 @@ void Server::keepAliveTimeout(Milliseconds ms)
     _impl->keepAliveTimeout(ms);
 }
 
+std::size_t Server::maxRequestBodySize() const
+{
+    return _impl->maxRequestBodySize();
+}
+
+void Server::maxRequestBodySize(std::size_t size)
+{
+    _impl->maxRequestBodySize(size);
+}
+
 unsigned Server::minThreads() const
 {
     return _impl->minThreads();
@@ -130,6 +143,36 @@ void Server::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+unsigned Server::ioThreads() const
+{
+    return _impl->ioThreads();
+}
+
+void Server::ioThreads(unsigned n)
+{
+    _impl->ioThreads(n);
+}
+
+EventLoopGroup* Server::eventLoopGroup() const
+{
+    return _impl->eventLoopGroup();
+}
+
+void Server::eventLoopGroup(EventLoopGroup& group)
+{
+    _impl->eventLoopGroup(&group);
+}
+
+bool Server::reusePort() const
+{
+    return _impl->reusePort();
+}
+
+void Server::reusePort(bool sw)
+{
+    _impl->reusePort(sw);
+}
+
 Delegate<bool, const SslCertificate&>& Server::acceptSslCertificate()
 {
     return _impl->acceptSslCertificate;
@@ -145,21 +145,31 @@ ServerImpl::~ServerImpl()
 void ServerImpl::listen(const std::string& ip, unsigned short int port, const SslCtx& sslCtx)
 {
     log_debug("listen on ip <" << ip << "> port " << port << " ssl " << sslCtx.enabled());
-    net::TcpServer* listener = new net::TcpServer(ip, port, 64,
-        net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR);
-    Socket* socket = 0;
 
-    try
-    {
-        _listener.push_back(listener);
-        socket = new Socket(*this, *listener, sslCtx);
-        _queue.put(socket);
-    }
-    catch (...)
+    // with reusePort each of the minimum number of workers may block in
+    // accept on its own listener
+    std::vector<net::TcpServer*> listeners = createListeners(ip, port, 64, minThreads());
+
+    for (unsigned n = 0; n < listeners.size(); ++n)
     {
-        delete socket;
-        delete listener;
-        throw;
+        net::TcpServer* listener = listeners[n];
+        Socket* socket = 0;
+
+        try
+        {
+            _listener.push_back(listener);
+            socket = new Socket(*this, *listener, sslCtx);
+            _queue.put(socket);
+        }
+        catch (...)
+        {
+            delete socket;
+            if (_listener.back() == listener)
+                _listener.pop_back();
+            for (; n < listeners.size(); ++n)
+                delete listeners[n];
+            throw;
+        }
     }
 }
 
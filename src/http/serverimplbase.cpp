@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "serverimplbase.h"
+#include <cxxtools/net/tcpserver.h>
+#include <cxxtools/log.h>
+
+log_define("cxxtools.http.server.impl")
+
+namespace cxxtools
+{
+namespace http
+{
+
+std::vector<net::TcpServer*> ServerImplBase::createListeners(const std::string& ip,
+    unsigned short int port, int backlog, unsigned count)
+{
+    // port 0 is a unix domain socket, which can't be shared
+    if (!_reusePort || port == 0)
+        count = 1;
+
+    unsigned flags = net::TcpServer::DEFER_ACCEPT|net::TcpServer::REUSEADDR;
+    if (count > 1)
+        flags |= net::TcpServer::REUSEPORT;
+
+    std::vector<net::TcpServer*> listeners;
+    listeners.reserve(count);
+
+    try
+    {
+        while (listeners.size() < count)
+        {
+            try
+            {
+                listeners.push_back(new net::TcpServer(ip, port, backlog, flags));
+            }
+            catch (const net::AddressInUse&)
+            {
+                if (listeners.empty())
+                    throw;
+
+                log_warn("only " << listeners.size() << " listeners on port " << port << " possible");
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        for (unsigned n = 0; n < listeners.size(); ++n)
+            delete listeners[n];
+        throw;
+    }
+
+    log_debug(listeners.size() << " listeners on ip <" << ip << "> port " << port);
+
+    return listeners;
+}
+
+}
+}
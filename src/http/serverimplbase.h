@@ -32,13 +32,23 @@
 #include <cxxtools/http/server.h>
 #include <cxxtools/timespan.h>
 #include "mapper.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace cxxtools
 {
 
 class EventLoopBase;
+class EventLoopGroup;
 class SslCtx;
 
+namespace net
+{
+    class TcpServer;
+}
+
 namespace http
 {
 
@@ -53,8 +63,12 @@ class ServerImplBase
               _readTimeout(Seconds(20)),
               _writeTimeout(Seconds(20)),
               _keepAliveTimeout(Seconds(30)),
+              _maxRequestBodySize(16 * 1024 * 1024),
               _minThreads(5),
               _maxThreads(200),
+              _ioThreads(std::max(std::thread::hardware_concurrency(), 1u)),
+              _eventLoopGroup(0),
+              _reusePort(false),
               _runmodeChanged(runmodeChanged),
               _runmode(Server::Stopped)
         { }
@@ -83,12 +97,24 @@ class ServerImplBase
         void writeTimeout(Milliseconds ms)     { _writeTimeout = ms; }
         void keepAliveTimeout(Milliseconds ms) { _keepAliveTimeout = ms; }
 
+        std::size_t maxRequestBodySize() const    { return _maxRequestBodySize; }
+        void maxRequestBodySize(std::size_t size) { _maxRequestBodySize = size; }
+
         unsigned minThreads() const           { return _minThreads; }
         void minThreads(unsigned m)           { _minThreads = m; }
 
         unsigned maxThreads() const           { return _maxThreads; }
         void maxThreads(unsigned m)           { _maxThreads = m; }
 
+        unsigned ioThreads() const            { return _ioThreads; }
+        void ioThreads(unsigned m)            { _ioThreads = m; }
+
+        EventLoopGroup* eventLoopGroup() const    { return _eventLoopGroup; }
+        void eventLoopGroup(EventLoopGroup* g)    { _eventLoopGroup = g; }
+
+        bool reusePort() const                { return _reusePort; }
+        void reusePort(bool sw)               { _reusePort = sw; }
+
         virtual void terminate()              { }
         Server::Runmode runmode() const
         { return _runmode; }
@@ -96,6 +122,15 @@ class ServerImplBase
         Delegate<bool, const SslCertificate&> acceptSslCertificate;
 
     protected:
+        /// Creates the listening sockets for a listen call.
+        ///
+        /// When reusePort is set, up to `count` sockets are bound to the
+        /// address with SO_REUSEPORT, so that the kernel distributes new
+        /// connections between them. Otherwise or if the system refuses
+        /// additional sockets, a single listener is returned.
+        std::vector<net::TcpServer*> createListeners(const std::string& ip,
+            unsigned short int port, int backlog, unsigned count);
+
         void runmode(Server::Runmode runmode)
         {
             _runmode = runmode;
@@ -108,9 +143,13 @@ class ServerImplBase
         Milliseconds _readTimeout;
         Milliseconds _writeTimeout;
         Milliseconds _keepAliveTimeout;
+        std::size_t _maxRequestBodySize;
 
         unsigned _minThreads;
         unsigned _maxThreads;
+        unsigned _ioThreads;
+        EventLoopGroup* _eventLoopGroup;
+        bool _reusePort;
 
         Signal<Server::Runmode>& _runmodeChanged;
         Server::Runmode _runmode;
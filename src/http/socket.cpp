@@ -27,9 +27,11 @@
  */
 
 #include "socket.h"
-#include "serverimpl.h"
+#include "serverimplbase.h"
 #include <cxxtools/log.h>
+#include <algorithm>
 #include <cassert>
+#include <sstream>
 #include "config.h"
 
 log_define("cxxtools.http.socket")
@@ -40,6 +42,14 @@ namespace cxxtools
 namespace http
 {
 
+namespace
+{
+    // Reply bodies up to this size keep their buffer across keep-alive
+    // requests; larger ones release it, so an idle connection does not
+    // hold on to the memory of a single big reply.
+    const std::string::size_type maxRetainedReplyBody = 65536;
+}
+
 void Socket::ParseEvent::onMethod(const std::string& method)
 {
     _request.method(method);
@@ -55,7 +65,7 @@ void Socket::ParseEvent::onUrlParam(const std::string& q)
     _request.qparams(q);
 }
 
-Socket::Socket(ServerImpl& server, net::TcpServer& tcpServer, const SslCtx& sslCtx)
+Socket::Socket(ServerImplBase& server, net::TcpServer& tcpServer, const SslCtx& sslCtx, bool dispatch)
     : inputSlot(slot(*this, &Socket::onInput)),
       _tcpServer(tcpServer),
       _sslCtx(sslCtx),
@@ -63,9 +73,17 @@ Socket::Socket(ServerImpl& server, net::TcpServer& tcpServer, const SslCtx& sslC
       _parseEvent(_request),
       _parser(_parseEvent, false),
       _responder(0),
-      _accepted(false)
+      _stream(8192, dispatch),
+      _bodyStream(_stream.rdbuf()),
+      _accepted(false),
+      _dispatch(dispatch),
+      _fileOffset(0),
+      _fileRemaining(0),
+      _sendingFile(false),
+      _replyStream(_stream.buffer())
 {
     _stream.attachDevice(*this);
+    _reply.streamer(this);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
     cxxtools::connect(_stream.buffer().outputReady, *this, &Socket::onOutput);
     cxxtools::connect(_timer.timeout, *this, &Socket::onTimeout);
@@ -82,9 +100,17 @@ Socket::Socket(Socket& socket)
       _parseEvent(_request),
       _parser(_parseEvent, false),
       _responder(0),
-      _accepted(false)
+      _stream(8192, socket._dispatch),
+      _bodyStream(_stream.rdbuf()),
+      _accepted(false),
+      _dispatch(socket._dispatch),
+      _fileOffset(0),
+      _fileRemaining(0),
+      _sendingFile(false),
+      _replyStream(_stream.buffer())
 {
     _stream.attachDevice(*this);
+    _reply.streamer(this);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
     cxxtools::connect(_stream.buffer().outputReady, *this, &Socket::onOutput);
     cxxtools::connect(_timer.timeout, *this, &Socket::onTimeout);
@@ -125,6 +151,174 @@ void Socket::postAccept()
     _timer.start(_server.readTimeout());
 }
 
+void Socket::acceptConnection()
+{
+    net::TcpSocket::accept(_tcpServer, net::TcpSocket::DEFER_ACCEPT);
+}
+
+void Socket::beginProcessing(SelectorBase& s)
+{
+    // The ssl handshake needs the selector to wait for the peer, so the
+    // socket is added before anything is read.
+    setSelector(&s);
+    cxxtools::connect(buffer().inputReady, inputSlot);
+    _timer.start(_server.readTimeout());
+
+    if (_sslCtx.enabled())
+    {
+        cxxtools::connect(sslAccepted, *this, &Socket::onSslAccepted);
+        beginSslAccept(_sslCtx);
+    }
+    else
+    {
+        _accepted = true;
+        buffer().beginRead();
+    }
+}
+
+void Socket::onSslAccepted(net::TcpSocket& /*socket*/)
+{
+    try
+    {
+        endSslAccept();
+    }
+    catch (const std::exception& e)
+    {
+        log_debug("ssl accept failed: " << e.what());
+        close();
+        disconnected(*this);
+        return;
+    }
+
+    _accepted = true;
+    buffer().beginRead();
+}
+
+void Socket::readRequest(StreamBuffer& sb)
+{
+    if (!_parser.end())
+    {
+        _parser.advance(sb);
+
+        if (_parser.fail())
+        {
+            Responder* responder = _server.getDefaultResponder(_request);
+            responder->replyError(_reply.bodyStream(), _request, _reply,
+                std::runtime_error("invalid http header"));
+            responder->release();
+
+            sendReply();
+
+            onOutput(sb);
+            return;
+        }
+
+        if (!_parser.end())
+        {
+            sb.beginRead();
+            return;
+        }
+
+        log_info("request " << _request.method() << ' ' << _request.header().query()
+            << " from client " << getPeerAddr());
+
+        std::size_t contentLength = _request.header().contentLength();
+        log_debug("content length of request is " << contentLength);
+
+        // The body is kept in memory until the request is processed, so
+        // its size is limited. The connection is closed after the reply,
+        // since the body is not read.
+        std::size_t maxSize = _server.maxRequestBodySize();
+        if (maxSize > 0 && contentLength > maxSize)
+        {
+            log_warn("request body of " << contentLength << " bytes from client "
+                << getPeerAddr() << " exceeds the limit of " << maxSize << " bytes");
+            _reply.httpReturn(413, "Request Entity Too Large");
+            _reply.setHeader("Content-Type", "text/plain");
+            _reply.setHeader("Connection", "close");
+            _reply.bodyStream() << "request body too large";
+
+            sendReply();
+
+            onOutput(sb);
+            return;
+        }
+
+        _contentLength = contentLength;
+        _body.clear();
+    }
+
+    while (_contentLength > 0 && sb.in_avail() > 0)
+    {
+        std::size_t n = std::min(static_cast<std::size_t>(sb.in_avail()),
+                                 static_cast<std::size_t>(_contentLength));
+        std::size_t size = _body.size();
+        _body.resize(size + n);
+        sb.sgetn(&_body[size], n);
+        _contentLength -= n;
+    }
+
+    if (_contentLength > 0)
+    {
+        sb.beginRead();
+        return;
+    }
+
+    _timer.stop();
+    requestReceived(*this);
+}
+
+void Socket::processRequest()
+{
+    log_trace("http::Socket::processRequest");
+
+    std::istringstream body(_body);
+    _responder = _server.getResponder(_request);
+
+    try
+    {
+        _responder->beginRequest(*this, body, _request);
+        while (body.rdbuf()->in_avail() > 0)
+            _responder->readBody(body);
+        _responder->reply(_reply.bodyStream(), _request, _reply);
+        if (_reply.streaming())
+            finishStream();
+    }
+    catch (const std::exception& e)
+    {
+        if (_reply.streaming())
+        {
+            // the header is already sent, so we can just drop the connection
+            _responder->release();
+            _responder = 0;
+            _body.clear();
+            throw;
+        }
+
+        log_warn("responder reported error: " << e.what());
+        _reply.clear();
+        _responder->replyError(_reply.bodyStream(), _request, _reply, e);
+    }
+
+    _responder->release();
+    _responder = 0;
+    _body.clear();
+}
+
+void Socket::finishRequest(SelectorBase& s)
+{
+    if (!isConnected())
+    {
+        disconnected(*this);
+        return;
+    }
+
+    setSelector(&s);
+    if (!_reply.streaming())
+        sendReply();
+    onOutput(buffer());
+}
+
 void Socket::setSelector(SelectorBase* s)
 {
     s->add(*this);
@@ -152,10 +346,18 @@ void Socket::onInput(StreamBuffer& sb)
     if (sb.in_avail() == 0 || sb.device()->eof())
     {
         close();
+        disconnected(*this);
         return;
     }
 
     _timer.start(_server.readTimeout());
+
+    if (_dispatch)
+    {
+        readRequest(sb);
+        return;
+    }
+
     if ( _responder == 0 )
     {
         _parser.advance(sb);
@@ -179,9 +381,12 @@ void Socket::onInput(StreamBuffer& sb)
             log_info("request " << _request.method() << ' ' << _request.header().query()
                 << " from client " << getPeerAddr());
             _responder = _server.getResponder(_request);
+            _contentLength = _request.header().contentLength();
+            _bodyStream.clear();
+            _bodyStream.icount(_contentLength);
             try
             {
-                _responder->beginRequest(*this, _stream, _request);
+                _responder->beginRequest(*this, _bodyStream, _request);
             }
             catch (const std::exception& e)
             {
@@ -195,7 +400,6 @@ void Socket::onInput(StreamBuffer& sb)
                 return;
             }
 
-            _contentLength = _request.header().contentLength();
             log_debug("content length of request is " << _contentLength);
             if (_contentLength == 0)
             {
@@ -217,7 +421,7 @@ void Socket::onInput(StreamBuffer& sb)
         {
             try
             {
-                std::size_t s = _responder->readBody(_stream);
+                std::size_t s = _responder->readBody(_bodyStream);
                 assert(s > 0);
                 _contentLength -= s;
             }
@@ -252,9 +456,21 @@ bool Socket::doReply()
     try
     {
         _responder->reply(_reply.bodyStream(), _request, _reply);
+        if (_reply.streaming())
+            finishStream();
     }
     catch (const std::exception& e)
     {
+        if (_reply.streaming())
+        {
+            log_warn("failed to send reply: " << e.what());
+            _responder->release();
+            _responder = 0;
+            close();
+            disconnected(*this);
+            return false;
+        }
+
         log_warn("responder reported error: " << e.what());
         _reply.clear();
         _responder->replyError(_reply.bodyStream(), _request, _reply, e);
@@ -263,7 +479,8 @@ bool Socket::doReply()
     _responder->release();
     _responder = 0;
 
-    sendReply();
+    if (!_reply.streaming())
+        sendReply();
 
     return onOutput(_stream.buffer());
 }
@@ -276,13 +493,31 @@ bool Socket::onOutput(StreamBuffer& sb)
 
     try
     {
-        sb.endWrite();
+        if (_sendingFile)
+        {
+            std::size_t n = endWrite();
+            _fileOffset += n;
+            _fileRemaining -= n;
+            _sendingFile = false;
+        }
+        else
+        {
+            sb.endWrite();
+        }
 
-        if ( sb.out_avail() )
+        if ( sb.out_avail() || sb.borrowedAvail() )
         {
             sb.beginWrite();
             _timer.start(_server.writeTimeout());
         }
+        else if (_fileRemaining > 0)
+        {
+            // The header is sent; the file body follows directly from the
+            // file descriptor.
+            _sendingFile = true;
+            beginSendFile(_reply.bodyFileFd(), _fileOffset, _fileRemaining);
+            _timer.start(_server.writeTimeout());
+        }
         else
         {
             bool keepAlive = _request.header().keepAlive()
@@ -294,6 +529,10 @@ bool Socket::onOutput(StreamBuffer& sb)
                 _timer.start(_server.keepAliveTimeout());
                 _request.clear();
                 _reply.clear();
+                if (_replyBody.capacity() > maxRetainedReplyBody)
+                    std::string().swap(_replyBody);
+                else
+                    _replyBody.clear();
                 _parser.reset(false);
                 if (sb.in_avail())
                     onInput(sb);
@@ -304,6 +543,7 @@ bool Socket::onOutput(StreamBuffer& sb)
             {
                 log_debug("don't do keep alive");
                 close();
+                disconnected(*this);
                 return false;
             }
         }
@@ -325,17 +565,12 @@ void Socket::onTimeout()
     timeout(*this);
 }
 
-void Socket::sendReply()
+void Socket::writeHeader()
 {
-    const char* contentLength = "Content-Length";
     const char* server = "Server";
     const char* connection = "Connection";
     const char* date = "Date";
 
-    log_info("request " << _request.method() << ' ' << _request.header().query()
-        << " ready, returncode " << _reply.httpReturnCode() << ' '
-        << _reply.httpReturnText());
-
     _stream << "HTTP/"
         << _reply.header().httpVersionMajor() << '.'
         << _reply.header().httpVersionMinor() << ' '
@@ -348,11 +583,6 @@ void Socket::sendReply()
         _stream << it->first << ": " << it->second << "\r\n";
     }
 
-    if (!_reply.header().hasHeader(contentLength))
-    {
-        _stream << "Content-Length: " << _reply.bodySize() << "\r\n";
-    }
-
     if (!_reply.header().hasHeader(server))
     {
         _stream << "Server: cxxtools-Http-Server " PACKAGE_VERSION "\r\n";
@@ -370,11 +600,91 @@ void Socket::sendReply()
         char buffer[50];
         _stream << "Date: " << MessageHeader::htdateCurrent(buffer) << "\r\n";
     }
+}
+
+void Socket::sendReply()
+{
+    log_info("request " << _request.method() << ' ' << _request.header().query()
+        << " ready, returncode " << _reply.httpReturnCode() << ' '
+        << _reply.httpReturnText());
+
+    writeHeader();
+
+    // The body is passed to the stream buffer as a borrowed buffer, so it
+    // is sent with the header in one vectored write without copying it
+    // into the output buffer.
+    if (_reply.hasBodyFile())
+    {
+        _replyBody.clear();
+        _fileOffset = _reply.bodyFileOffset();
+        _fileRemaining = _reply.bodyFileSize();
+    }
+    else
+    {
+        _replyBody = _reply.body();
+    }
+
+    if (!_reply.header().hasHeader("Content-Length"))
+    {
+        _stream << "Content-Length: "
+                << (_reply.hasBodyFile() ? _reply.bodyFileSize() : _replyBody.size())
+                << "\r\n";
+    }
+
+    _stream << "\r\n";
+
+    _stream.buffer().writeBorrowed(_replyBody.data(), _replyBody.size());
+}
+
+std::ostream& Socket::beginStream(Reply& /*reply*/)
+{
+    log_info("request " << _request.method() << ' ' << _request.header().query()
+        << " streaming, returncode " << _reply.httpReturnCode() << ' '
+        << _reply.httpReturnText());
+
+    bool chunked = false;
+    if (!_reply.header().hasHeader("Content-Length"))
+    {
+        const RequestHeader& h = _request.header();
+        if (h.httpVersionMajor() > 1 || (h.httpVersionMajor() == 1 && h.httpVersionMinor() >= 1))
+        {
+            _reply.setHeader("Transfer-Encoding", "chunked");
+            chunked = true;
+        }
+        else
+        {
+            // the end of the body is signaled by closing the connection
+            _reply.setHeader("Connection", "close");
+        }
+    }
 
+    writeHeader();
     _stream << "\r\n";
 
-    _reply.sendBody(_stream);
+    // The responder runs in its own thread, while the connection is not
+    // watched by a selector, so the body is written with blocking calls.
+    _savedTimeout = getTimeout();
+    setTimeout(_server.writeTimeout());
+
+    if (_stream.buffer().pubsync() != 0)
+        throw std::runtime_error("failed to send reply header");
+
+    _replyStream.begin(chunked);
+    return _replyStream;
+}
+
+void Socket::finishStream()
+{
+    _replyStream.finish();
+    setTimeout(_savedTimeout);
 
+    if (_reply.header().hasHeader("Content-Length")
+        && _reply.header().contentLength() != _replyStream.count())
+    {
+        log_warn("streamed reply has " << _replyStream.count()
+            << " bytes but content length " << _reply.header().contentLength());
+        throw std::runtime_error("size of streamed reply does not match content length");
+    }
 }
 
 bool Socket::onAcceptSslCertificate(const SslCertificate& cert)
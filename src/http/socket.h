@@ -34,20 +34,23 @@
 #include <cxxtools/http/reply.h>
 #include <cxxtools/sslctx.h>
 #include <cxxtools/iostream.h>
+#include <cxxtools/limitstream.h>
 #include <cxxtools/timer.h>
 #include <cxxtools/connectable.h>
 #include <cxxtools/signal.h>
 #include <cxxtools/method.h>
 #include "parser.h"
+#include "replystream.h"
+#include <string>
 
 namespace cxxtools {
 
 namespace http {
 
-class ServerImpl;
+class ServerImplBase;
 class Responder;
 
-class Socket : public net::TcpSocket, public Connectable
+class Socket : public net::TcpSocket, public Connectable, private Reply::Streamer
 {
         class ParseEvent : public HeaderParser::MessageHeaderEvent
         {
@@ -65,7 +68,12 @@ class Socket : public net::TcpSocket, public Connectable
         };
 
     public:
-        Socket(ServerImpl& server, net::TcpServer& tcpServer, const SslCtx& sslCtx);
+        /// Creates a socket for accepting connections on the listener.
+        ///
+        /// When `dispatch` is set, the socket runs in event loop mode: it
+        /// reads complete requests without blocking and signals
+        /// `requestReceived` instead of calling the responder directly.
+        Socket(ServerImplBase& server, net::TcpServer& tcpServer, const SslCtx& sslCtx, bool dispatch = false);
         explicit Socket(Socket& socket);
         ~Socket();
 
@@ -73,6 +81,12 @@ class Socket : public net::TcpSocket, public Connectable
         void postAccept();
         bool hasAccepted() const  { return _accepted; }
 
+        // event loop mode
+        void acceptConnection();
+        void beginProcessing(SelectorBase& s);
+        void processRequest();
+        void finishRequest(SelectorBase& s);
+
         void setSelector(SelectorBase* s);
         void removeSelector();
 
@@ -92,6 +106,8 @@ class Socket : public net::TcpSocket, public Connectable
 
         Signal<Socket&> inputReady;
         Signal<Socket&> timeout;
+        Signal<Socket&> requestReceived;
+        Signal<Socket&> disconnected;
 
         StreamBuffer& buffer()         { return _stream.buffer(); }
 
@@ -101,9 +117,16 @@ class Socket : public net::TcpSocket, public Connectable
         Connection timeoutConnection;
 
     private:
+        void readRequest(StreamBuffer& sb);
+        void onSslAccepted(net::TcpSocket& socket);
+
+        void writeHeader();
+        std::ostream& beginStream(Reply& reply);
+        void finishStream();
+
         net::TcpServer& _tcpServer;
         SslCtx _sslCtx;
-        ServerImpl& _server;
+        ServerImplBase& _server;
 
         ParseEvent _parseEvent;
         HeaderParser _parser;
@@ -114,10 +137,26 @@ class Socket : public net::TcpSocket, public Connectable
         int _contentLength;
         Responder* _responder;
         IOStream _stream;
+        // the body of the current request; it stops at the content length,
+        // so that a pipelined request is not read as part of the body
+        LimitIStream _bodyStream;
 
         int _sslVerifyLevel;
         std::string _sslCa;
         bool _accepted;
+
+        bool _dispatch;
+        std::string _body;
+        std::string _replyBody;
+
+        // state of a file body sent with beginSendFile
+        std::size_t _fileOffset;
+        std::size_t _fileRemaining;
+        bool _sendingFile;
+
+        // reply body sent with Reply::beginStream
+        ReplyOStream _replyStream;
+        Milliseconds _savedTimeout;
 };
 
 } // namespace http
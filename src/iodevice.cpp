@@ -41,6 +41,8 @@ IODevice::IODevice()
 , _wbuf(0)
 , _wbuflen(0)
 , _wavail(0)
+, _wvec(0)
+, _wveclen(0)
 { }
 
 size_t IODevice::onBeginRead(char* buffer, size_t n, bool& eof)
@@ -73,6 +75,16 @@ size_t IODevice::onWrite(const char* buffer, size_t count)
     return ioimpl().write(buffer, count);
 }
 
+size_t IODevice::onBeginWritev(const IOVec* vec, size_t count)
+{
+    return ioimpl().beginWritev(vec, count);
+}
+
+size_t IODevice::onWritev(const IOVec* vec, size_t count)
+{
+    return ioimpl().writev(vec, count);
+}
+
 void IODevice::onClose()
 {
     cancel();
@@ -222,6 +234,8 @@ size_t IODevice::endWrite()
         _wbuf = 0;
         _wbuflen = 0;
         _wavail = 0;
+        _wvec = 0;
+        _wveclen = 0;
         throw;
     }
 
@@ -235,6 +249,8 @@ size_t IODevice::endWrite()
     _wbuf = 0;
     _wbuflen = 0;
     _wavail = 0;
+    _wvec = 0;
+    _wveclen = 0;
 
     return n;
 }
@@ -267,6 +283,61 @@ size_t IODevice::write(const char* buffer, size_t n)
 }
 
 
+size_t IODevice::beginWritev(const IOVec* vec, size_t count)
+{
+    if (!async())
+        throw std::logic_error("Device not in async mode");
+
+    if (!enabled())
+        throw std::logic_error("Device not enabled");
+
+    if (_wbuf)
+        throw IOPending("write operation pending");
+
+    if (count == 0)
+        throw std::logic_error("empty write vector");
+
+    size_t r = this->onBeginWritev(vec, count);
+
+    if (r > 0 || _ravail)
+        this->setState(Selectable::Avail);
+    else
+        this->setState(Selectable::Busy);
+
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i)
+        n += vec[i].size;
+
+    _wbuf = vec[0].data ? vec[0].data : "";
+    _wbuflen = n;
+    _wavail = r;
+    _wvec = vec;
+    _wveclen = count;
+
+    return r;
+}
+
+
+size_t IODevice::writev(const IOVec* vec, size_t count)
+{
+    if (count == 0)
+        return 0;
+
+    if ( async() )
+    {
+        if ( _wbuf )
+        {
+            throw IOPending("write operation pending");
+        }
+
+        this->beginWritev(vec, count);
+        return endWrite();
+    }
+
+    return this->onWritev(vec, count);
+}
+
+
 void IODevice::cancel()
 {
     onCancel();
@@ -280,6 +351,8 @@ void IODevice::cancel()
     _wbuf = 0;
     _wbuflen = 0;
     _wavail = 0;
+    _wvec = 0;
+    _wveclen = 0;
 }
 
 
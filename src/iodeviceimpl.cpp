@@ -35,6 +35,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <sys/poll.h>
+#include <sys/uio.h>
 #include <cxxtools/log.h>
 #include <cxxtools/hexdump.h>
 #include <cxxtools/resetter.h>
@@ -169,6 +170,7 @@ size_t IODeviceImpl::beginRead(char* /*buffer*/, size_t /*n*/, bool& /*eof*/)
     if(_pfd)
     {
         _pfd->events |= POLLIN;
+        pollChanged();
     }
 
     return 0;
@@ -180,6 +182,7 @@ size_t IODeviceImpl::endRead(bool& eof)
     if(_pfd)
     {
         _pfd->events &= ~POLLIN;
+        pollChanged();
     }
 
     checkPendingException();
@@ -259,7 +262,10 @@ size_t IODeviceImpl::beginWrite(const char* buffer, size_t n)
             throw IOError("lost connection to peer");
 
         if (_pfd)
+        {
             _pfd->events |= POLLOUT;
+            pollChanged();
+        }
     }
     catch (const std::exception&)
     {
@@ -275,6 +281,7 @@ size_t IODeviceImpl::endWrite()
     if(_pfd)
     {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
     }
 
     checkPendingException();
@@ -292,6 +299,9 @@ size_t IODeviceImpl::endWrite()
         return n;
     }
 
+    if (_device.wvec())
+        return this->writev( _device.wvec(), _device.wveclen() );
+
     return this->write( _device.wbuf(), _device.wbuflen() );
 }
 
@@ -335,6 +345,103 @@ size_t IODeviceImpl::write( const char* buffer, size_t count )
 }
 
 
+size_t IODeviceImpl::toIovec(const IOVec* vec, size_t count, iovec* iov)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < count && n < maxIovec; ++i)
+    {
+        if (vec[i].size > 0)
+        {
+            iov[n].iov_base = const_cast<char*>(vec[i].data);
+            iov[n].iov_len = vec[i].size;
+            ++n;
+        }
+    }
+
+    return n;
+}
+
+
+size_t IODeviceImpl::beginWritev(const IOVec* vec, size_t count)
+{
+    iovec iov[maxIovec];
+    size_t n = toIovec(vec, count, iov);
+
+    log_debug("::writev(" << _fd << ", iov, " << n << ')');
+
+    try
+    {
+        if (n == 0)
+            return 0;
+
+        ssize_t ret = ::writev(_fd, iov, n);
+        int e = errno;
+
+        log_debug("writev returned " << ret);
+        if (ret > 0)
+            return static_cast<size_t>(ret);
+
+        if (ret == 0 || e == ECONNRESET || e == EPIPE)
+            throw IOError("lost connection to peer");
+
+        if (_pfd)
+        {
+            _pfd->events |= POLLOUT;
+            pollChanged();
+        }
+    }
+    catch (const std::exception&)
+    {
+        _exception = std::current_exception();
+    }
+
+    return 0;
+}
+
+
+size_t IODeviceImpl::writev(const IOVec* vec, size_t count)
+{
+    iovec iov[maxIovec];
+    size_t n = toIovec(vec, count, iov);
+    if (n == 0)
+        return 0;
+
+    ssize_t ret = 0;
+
+    while(true)
+    {
+        log_debug("::writev(" << _fd << ", iov, " << n << ')');
+
+        ret = ::writev(_fd, iov, n);
+        int e = errno;
+        log_debug("writev returned " << ret);
+        if(ret > 0)
+            break;
+
+        if (ret == 0 || e == ECONNRESET || e == EPIPE)
+            throw IOError("lost connection to peer");
+
+        if (e == EINTR)
+            continue;
+
+        if (e != EAGAIN)
+            throw IOError(getErrnoString("writev"));
+
+        pollfd pfd;
+        pfd.fd = this->fd();
+        pfd.revents = 0;
+        pfd.events = POLLOUT;
+
+        if (!this->wait(_timeout, pfd))
+        {
+            throw IOTimeout();
+        }
+    }
+
+    return static_cast<size_t>(ret);
+}
+
+
 void IODeviceImpl::sigwrite(int sig)
 {
     ::write(_fd, (const void*)&sig, sizeof(sig));
@@ -346,6 +453,7 @@ void IODeviceImpl::cancel()
     if(_pfd)
     {
         _pfd->events &= ~(POLLIN|POLLOUT);
+        pollChanged();
     }
 }
 
@@ -38,6 +38,7 @@
 #include <exception>
 
 struct pollfd;
+struct iovec;
 
 namespace cxxtools
 {
@@ -79,6 +80,10 @@ namespace cxxtools
 
             virtual size_t write( const char* buffer, size_t count );
 
+            virtual size_t beginWritev(const IOVec* vec, size_t count);
+
+            virtual size_t writev(const IOVec* vec, size_t count);
+
             void sigwrite(int sig);
 
             virtual void cancel();
@@ -109,6 +114,12 @@ namespace cxxtools
             virtual void outputReady();
 
         protected:
+            // maximum number of buffers passed to a single vectored write
+            static const size_t maxIovec = 64;
+
+            // fills iov from vec skipping empty buffers; returns the number of entries used
+            static size_t toIovec(const IOVec* vec, size_t count, iovec* iov);
+
             IODevice& _device;
             int _fd;
             Timespan _timeout;
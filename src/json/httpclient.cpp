@@ -141,6 +141,11 @@ void HttpClient::clearAuth()
     getImpl()->clearAuth();
 }
 
+void HttpClient::clientPool(http::ClientPool* pool)
+{
+    getImpl()->clientPool(pool);
+}
+
 void HttpClient::setSelector(SelectorBase* selector)
 {
     getImpl()->setSelector(selector);
@@ -28,8 +28,10 @@
 
 #include "httpclientimpl.h"
 #include "cxxtools/remoteprocedure.h"
+#include "cxxtools/remoteexception.h"
 #include "cxxtools/jsonformatter.h"
 #include "cxxtools/http/replyheader.h"
+#include "cxxtools/http/clientpool.h"
 #include "cxxtools/selectable.h"
 #include "cxxtools/ioerror.h"
 #include "cxxtools/clock.h"
@@ -51,6 +53,7 @@ HttpClientImpl::HttpClientImpl()
 : _timeout(Selectable::WaitInfinite),
   _connectTimeoutSet(false),
   _connectTimeout(Selectable::WaitInfinite),
+  _pool(0),
   _proc(0),
   _exceptionPending(false),
   _count(0)
@@ -114,12 +117,43 @@ void HttpClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer**
 
     prepareRequest(method.name(), argv, argc);
 
-    _client.execute(_request, timeout(), connectTimeout());
+    if (_pool == 0)
+    {
+        execute(_client, r);
+        return;
+    }
+
+    http::PooledClient client = _pool->acquire(_client.host(), _client.port(), _sslCtx);
+    if (_username.empty())
+        client->clearAuth();
+    else
+        client->auth(_username, _password);
+
+    try
+    {
+        execute(*client, r);
+    }
+    catch (const RemoteException&)
+    {
+        // the server reported an error, but the connection is fine
+        throw;
+    }
+    catch (const std::exception&)
+    {
+        // the state of the connection is unknown
+        client.discard();
+        throw;
+    }
+}
+
+void HttpClientImpl::execute(http::Client& client, IComposer& r)
+{
+    client.execute(_request, timeout(), connectTimeout());
 
     _scanner.begin(_deserializer, r);
 
     char ch;
-    std::istream& is = _client.in();
+    std::istream& is = client.in();
     while (is.get(ch))
     {
         if (_deserializer.advance(ch) != 0)
@@ -30,6 +30,7 @@
 
 #include <cxxtools/http/client.h>
 #include <cxxtools/http/request.h>
+#include <cxxtools/sslctx.h>
 #include <cxxtools/connectable.h>
 #include <cxxtools/deserializer.h>
 #include <cxxtools/jsondeserializer.h>
@@ -51,6 +52,11 @@ namespace net
     class AddrInfo;
 }
 
+namespace http
+{
+    class ClientPool;
+}
+
 namespace json
 {
     class HttpClientImpl : public RefCounted, public Connectable
@@ -61,12 +67,14 @@ namespace json
             void prepareConnect(const net::AddrInfo& addrinfo, const std::string& url)
             {
                 _client.prepareConnect(addrinfo);
+                _sslCtx = SslCtx();
                 _request.url(url);
             }
 
             void prepareConnect(const net::AddrInfo& addrinfo, const std::string& url, const SslCtx& sslCtx)
             {
                 _client.prepareConnect(addrinfo, sslCtx);
+                _sslCtx = sslCtx;
                 _request.url(url);
             }
 
@@ -83,11 +91,20 @@ namespace json
             void auth(const std::string& username, const std::string& password)
             {
                 _client.auth(username, password);
+                _username = username;
+                _password = password;
             }
 
             void clearAuth()
             {
                 _client.clearAuth();
+                _username.clear();
+                _password.clear();
+            }
+
+            void clientPool(http::ClientPool* pool)
+            {
+                _pool = pool;
             }
 
             void setSelector(SelectorBase* selector)
@@ -121,6 +138,8 @@ namespace json
         private:
             void prepareRequest(const String& name, IDecomposer** argv, unsigned argc);
 
+            void execute(http::Client& client, IComposer& r);
+
             void onReplyHeader(http::Client& client);
 
             std::size_t onReplyBody(http::Client& client);
@@ -134,6 +153,10 @@ namespace json
             bool _connectTimeoutSet;
             Timespan _connectTimeout;
             http::Client _client;
+            SslCtx _sslCtx;
+            std::string _username;
+            std::string _password;
+            http::ClientPool* _pool;
 
             http::Request _request;
 
@@ -49,6 +49,7 @@ Responder::Responder(ServiceRegistry& serviceRegistry)
     : _serviceRegistry(serviceRegistry),
       _failed(false)
 {
+    _deserializer.setArena(&_arena);
 }
 
 Responder::~Responder()
@@ -67,6 +67,7 @@ class Responder
 
     private:
         ServiceRegistry& _serviceRegistry;
+        Arena _arena;   // request tree; must be destroyed after _deserializer
         JsonDeserializer _deserializer;
 
         bool _failed;
@@ -27,6 +27,7 @@
  */
 
 #include <cxxtools/jsondeserializer.h>
+#include <algorithm>
 
 namespace cxxtools
 {
@@ -53,9 +54,38 @@ namespace
 }
 
 JsonDeserializer::JsonDeserializer(std::istream& in, TextCodec<Char, char>* codec)
+    : _in(0),
+      _byteIn(0)
+{
+    read(in, codec);
+}
+
+JsonDeserializer::JsonDeserializer(std::basic_istream<Char>& in)
+    : _in(0),
+      _byteIn(0)
+{
+    read(in);
+}
+
+void JsonDeserializer::read(std::istream& in, TextCodec<Char, char>* codec)
 {
     CodecReleaser r(codec);
 
+    if (dynamic_cast<Utf8Codec*>(codec))
+    {
+        begin();
+
+        std::istream::sentry sentry(in, true);
+        if (sentry)
+            parseUtf8(in);
+
+        if (in.rdstate() & std::ios::badbit)
+            SerializationError::doThrow("json deserialization failed");
+
+        finish();
+        return;
+    }
+
     char ibuf;
     Char obuf;
 
@@ -105,7 +135,7 @@ JsonDeserializer::JsonDeserializer(std::istream& in, TextCodec<Char, char>* code
     finish();
 }
 
-JsonDeserializer::JsonDeserializer(std::basic_istream<Char>& in)
+void JsonDeserializer::read(std::basic_istream<Char>& in)
 {
     begin();
     Char ch;
@@ -125,6 +155,102 @@ JsonDeserializer::JsonDeserializer(std::basic_istream<Char>& in)
     finish();
 }
 
+int JsonDeserializer::parseUtf8(std::istream& in)
+{
+    // The data is copied from the stream buffer in chunks, which are
+    // available without reading. Bytes behind the end of the json data or
+    // the current element are returned to the stream buffer.
+    std::streambuf* sb = in.rdbuf();
+    char buffer[8192];
+
+    while (true)
+    {
+        if (sb->sgetc() == std::streambuf::traits_type::eof())
+        {
+            in.setstate(std::ios::eofbit | std::ios::failbit);
+            return 0;
+        }
+
+        std::streamsize n = std::min(sb->in_avail(), static_cast<std::streamsize>(sizeof(buffer)));
+        n = sb->sgetn(buffer, n > 0 ? n : 1);
+
+        const char* p = buffer;
+        const char* e = buffer + n;
+        int ret = _parser.advance(p, e);
+
+        for (; p != e; ++p)
+            sb->sungetc();
+
+        if (ret != 0 || elementReady())
+            return ret;
+    }
+}
+
+void JsonDeserializer::beginStream(std::istream& in, TextCodec<Char, char>* codec)
+{
+    if (dynamic_cast<Utf8Codec*>(codec))
+    {
+        CodecReleaser r(codec);
+        _textStream.reset();
+        Deserializer::beginStream();
+        _parser.begin(*this);
+        _in = 0;
+        _byteIn = &in;
+        return;
+    }
+
+    _textStream.reset(new TextIStream(in, codec));
+    beginStream(*_textStream);
+}
+
+void JsonDeserializer::beginStream(std::basic_istream<Char>& in)
+{
+    if (_textStream.get() != &in)
+        _textStream.reset();
+
+    Deserializer::beginStream();
+    _parser.begin(*this);
+    _in = &in;
+    _byteIn = 0;
+}
+
+bool JsonDeserializer::readElement()
+{
+    if (_byteIn)
+    {
+        if (parseUtf8(*_byteIn) == 0 && elementReady())
+            return false;
+
+        if (_byteIn->rdstate() & std::ios::badbit)
+            SerializationError::doThrow("json deserialization failed");
+
+        finish();
+        return true;
+    }
+
+    Char ch;
+    while (_in->get(ch))
+    {
+        int ret = advance(ch);
+        if (ret == -1)
+            _in->putback(ch);
+        if (ret != 0)
+        {
+            finish();
+            return true;
+        }
+
+        if (elementReady())
+            return false;
+    }
+
+    if (_in->rdstate() & std::ios::badbit)
+        SerializationError::doThrow("json deserialization failed");
+
+    finish();
+    return true;
+}
+
 void JsonDeserializer::begin()
 {
     Deserializer::begin();
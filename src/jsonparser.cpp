@@ -32,9 +32,14 @@
 #include <cxxtools/utf8codec.h>
 #include <cxxtools/log.h>
 
+#include <algorithm>
 #include <cctype>
 #include <sstream>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 log_define("cxxtools.json.parser")
 
 namespace cxxtools
@@ -44,6 +49,154 @@ inline Char fromUtf16(uint32_t lo, uint32_t hi)
     return Char((((hi & 0x3ff) << 10) | (lo & 0x3ff)) + 0x10000);
 }
 
+namespace
+{
+    // Scanning functions for the utf-8 parser. They return a pointer to the
+    // first byte, which does not belong to the span.
+
+    inline bool isSpace(unsigned char c)
+    {
+        return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+    }
+
+    inline bool isDigit(unsigned char c)
+    {
+        return static_cast<unsigned char>(c - '0') <= 9;
+    }
+
+    inline bool isFloatChar(unsigned char c)
+    {
+        return isDigit(c) || c == '+' || c == '-' || c == '.' || c == 'e' || c == 'E';
+    }
+
+#if defined(__AVX2__)
+    // bytes in the range [lo, lo + n]
+    inline __m256i inRange(__m256i v, char lo, char n)
+    {
+        __m256i d = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(n)), d);
+    }
+#endif
+
+#if defined(__SSE2__)
+    inline __m128i inRange(__m128i v, char lo, char n)
+    {
+        __m128i d = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+        return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(n)), d);
+    }
+#endif
+
+    const char* skipSpace(const char* p, const char* e)
+    {
+        if (p == e || !isSpace(*p))
+            return p;
+
+#if defined(__AVX2__)
+        for (; e - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                            inRange(v, '\t', '\r' - '\t'));
+            unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(space));
+            if (mask)
+                return p + __builtin_ctz(mask);
+        }
+#endif
+#if defined(__SSE2__)
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                         inRange(v, '\t', '\r' - '\t'));
+            unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(space)) & 0xffff;
+            if (mask)
+                return p + __builtin_ctz(mask);
+        }
+#endif
+        while (p != e && isSpace(*p))
+            ++p;
+
+        return p;
+    }
+
+    const char* skipDigits(const char* p, const char* e)
+    {
+#if defined(__SSE2__)
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(inRange(v, '0', 9))) & 0xffff;
+            if (mask)
+                return p + __builtin_ctz(mask);
+        }
+#endif
+        while (p != e && isDigit(*p))
+            ++p;
+
+        return p;
+    }
+
+    // Skips characters in a string, which need no special processing i.e.
+    // stops at quotes, backslashes and non ascii characters.
+    const char* skipPlainString(const char* p, const char* e)
+    {
+#if defined(__AVX2__)
+        for (; e - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+                v);
+            unsigned mask = _mm256_movemask_epi8(special);
+            if (mask)
+                return p + __builtin_ctz(mask);
+        }
+#endif
+#if defined(__SSE2__)
+        for (; e - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+                v);
+            unsigned mask = _mm_movemask_epi8(special);
+            if (mask)
+                return p + __builtin_ctz(mask);
+        }
+#endif
+        while (p != e && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) < 0x80)
+            ++p;
+
+        return p;
+    }
+
+    void appendUtf8(std::string& s, char32_t v)
+    {
+        if (v < 0x80)
+            s += static_cast<char>(v);
+        else if (v < 0x800)
+        {
+            s += static_cast<char>(0xc0 | (v >> 6));
+            s += static_cast<char>(0x80 | (v & 0x3f));
+        }
+        else if (v < 0x10000)
+        {
+            s += static_cast<char>(0xe0 | (v >> 12));
+            s += static_cast<char>(0x80 | ((v >> 6) & 0x3f));
+            s += static_cast<char>(0x80 | (v & 0x3f));
+        }
+        else
+        {
+            s += static_cast<char>(0xf0 | (v >> 18));
+            s += static_cast<char>(0x80 | ((v >> 12) & 0x3f));
+            s += static_cast<char>(0x80 | ((v >> 6) & 0x3f));
+            s += static_cast<char>(0x80 | (v & 0x3f));
+        }
+    }
+}
+
 const char* JsonParserError::what() const throw()
 {
   if (_msg.empty())
@@ -84,23 +237,23 @@ bool JsonParser::JsonStringParser::advance(Char ch)
             else if (ch == '"')
                 return true;
             else
-                _str += ch;
+                append(ch);
             break;
 
         case state_esc:
             _state = state_0;
             if (ch == '"' || ch == '\\' || ch == '/')
-                _str += ch;
+                append(ch);
             else if (ch == 'b')
-                _str += '\b';
+                append('\b');
             else if (ch == 'f')
-                _str += '\f';
+                append('\f');
             else if (ch == 'n')
-                _str += '\n';
+                append('\n');
             else if (ch == 'r')
-                _str += '\r';
+                append('\r');
             else if (ch == 't')
-                _str += '\t';
+                append('\t');
             else if (ch == 'u')
             {
                 _value = 0;
@@ -141,7 +294,7 @@ bool JsonParser::JsonStringParser::advance(Char ch)
                         }
                         else
                         {
-                            _str += Char(static_cast<int32_t>(_value));
+                            append(Char(static_cast<int32_t>(_value)));
                             _state = state_0;
                         }
                         break;
@@ -150,7 +303,7 @@ bool JsonParser::JsonStringParser::advance(Char ch)
                         if ((_value & 0xfc00) != 0xd800)
                             _jsonParser->doThrow("expecting surrogate value \\ud8xx " + std::to_string(_value));
 
-                        _str += fromUtf16(_surrogateValue, _value);
+                        append(fromUtf16(_surrogateValue, _value));
                         _state = state_0;
                         break;
 
@@ -158,7 +311,7 @@ bool JsonParser::JsonStringParser::advance(Char ch)
                         if ((_value & 0xfc00) != 0xdc00)
                             _jsonParser->doThrow("expecting surrogate value \\uddxx " + std::to_string(_value));
 
-                        _str += fromUtf16(_value, _surrogateValue);
+                        append(fromUtf16(_value, _surrogateValue));
                         _state = state_0;
                         break;
                 }
@@ -187,11 +340,52 @@ bool JsonParser::JsonStringParser::advance(Char ch)
     return false;
 }
 
+void JsonParser::JsonStringParser::append(Char ch)
+{
+    if (_utf8)
+    {
+        if (ch.value() >= 0x80)
+            _ascii = false;
+        appendUtf8(_str8, ch.value());
+    }
+    else
+        _str += ch;
+}
+
+bool JsonParser::JsonStringParser::advance(const char*& p, const char* e)
+{
+    _utf8 = true;
+
+    while (p != e)
+    {
+        if (_state == state_0 && _jsonParser->_utf8Count == 0)
+        {
+            const char* b = p;
+            p = skipPlainString(p, e);
+            _str8.append(b, p);
+            if (p == e)
+                break;
+        }
+
+        Char ch;
+        if (!_jsonParser->nextChar(p, e, ch))
+            break;
+
+        if (advance(ch))
+            return true;
+    }
+
+    return false;
+}
+
 JsonParser::JsonParser()
     : _deserializer(0),
       _stringParser(this),
       _next(0),
-      _lineNo(1)
+      _lineNo(1),
+      _utf8Count(0),
+      _utf8Value(0),
+      _utf8Min(0)
 { }
 
 JsonParser::~JsonParser()
@@ -201,400 +395,609 @@ JsonParser::~JsonParser()
 
 int JsonParser::advance(Char ch)
 {
-    int ret;
-
     if (ch == '\n')
       ++_lineNo;
 
     try
     {
+        return step(ch);
+    }
+    catch (JsonParserError& e)
+    {
+        e._lineNo = _lineNo;
+        throw;
+    }
+}
+
+int JsonParser::advance(const char*& p, const char* e)
+{
+    const char* b = p;
+
+    try
+    {
+        int ret = parse(p, e);
+        _lineNo += std::count(b, p, '\n');
+        return ret;
+    }
+    catch (JsonParserError& err)
+    {
+        _lineNo += std::count(b, p, '\n');
+        err._lineNo = _lineNo;
+        throw;
+    }
+}
+
+bool JsonParser::nextChar(const char*& p, const char* e, Char& ch)
+{
+    while (p != e)
+    {
+        unsigned char c = *p;
+
+        if (_utf8Count == 0)
+        {
+            if (c < 0x80)
+            {
+                ++p;
+                ch = Char(c);
+                return true;
+            }
+            else if ((c & 0xe0) == 0xc0)
+            {
+                _utf8Value = c & 0x1f;
+                _utf8Count = 1;
+                _utf8Min = 0x80;
+            }
+            else if ((c & 0xf0) == 0xe0)
+            {
+                _utf8Value = c & 0x0f;
+                _utf8Count = 2;
+                _utf8Min = 0x800;
+            }
+            else if ((c & 0xf8) == 0xf0)
+            {
+                _utf8Value = c & 0x07;
+                _utf8Count = 3;
+                _utf8Min = 0x10000;
+            }
+            else
+                doThrow("invalid utf-8 sequence");
+        }
+        else if ((c & 0xc0) == 0x80)
+        {
+            _utf8Value = (_utf8Value << 6) | (c & 0x3f);
+            if (--_utf8Count == 0)
+            {
+                // overlong encodings, surrogates and values beyond the
+                // unicode range are not valid utf-8
+                if (_utf8Value < _utf8Min
+                    || (_utf8Value >= 0xd800 && _utf8Value <= 0xdfff)
+                    || _utf8Value > 0x10ffff)
+                    doThrow("invalid utf-8 sequence");
+
+                ++p;
+                ch = Char(_utf8Value);
+                return true;
+            }
+        }
+        else
+            doThrow("invalid utf-8 sequence");
+
+        ++p;
+    }
+
+    return false;
+}
+
+int JsonParser::parse(const char*& p, const char* e)
+{
+    while (p != e)
+    {
+        int ret;
+
+        // process spans of characters in bulk; everything else is passed
+        // to the character based state machine
         switch (_state)
         {
             case state_beforestart:
-                if (std::isspace(ch.value()))
+            case state_object:
+            case state_object_after_name:
+            case state_object_e:
+            case state_object_next_member0:
+            case state_object_next_member:
+            case state_array_e:
+            case state_end:
+                p = skipSpace(p, e);
+                if (p == e)
+                    return 0;
+                break;
+
+            case state_array:
+            case state_array_value0:
+                p = skipSpace(p, e);
+                if (p == e)
+                    return 0;
+
+                if (*p == ']' || (*p == '/' && _state == state_array))
                     break;
 
-                _state = state_0;
-                // fallthrough
+                if (_next == 0)
+                    _next = new JsonParser();
 
-            case state_0:
-                if (ch == '{')
-                {
-                    _state = state_object;
-                    _deserializer->setCategory(SerializationInfo::Object);
-                }
-                else if (ch == '[')
-                {
-                    _state = state_array;
-                    _deserializer->setCategory(SerializationInfo::Array);
-                }
-                else if (ch == '"')
-                {
-                    _state = state_string;
-                    _deserializer->setCategory(SerializationInfo::Value);
-                }
-                else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-')
-                {
-                    _token = ch;
-                    _state = state_number;
-                    _deserializer->setCategory(SerializationInfo::Value);
-                }
-                else if (ch == '/')
-                {
-                    _nextState = _state;
-                    _state = state_comment0;
-                }
-                else if (!std::isspace(ch.value()))
-                {
-                    _token = ch;
-                    _state = state_token;
-                }
-                break;
+                log_debug("begin array member");
+                _deserializer->beginMember(std::string(),
+                        std::string(), SerializationInfo::Void);
+                _next->begin(*_deserializer);
+                _state = state_array_value;
+                continue;
 
-            case state_object:
-                if (ch == '"')
-                {
-                    _state = state_object_name;
-                    _stringParser.clear();
-                }
-                else if (ch == '}')
-                {
-                    _state = state_end;
-                    return 1;
-                }
-                else if (ch == '/')
-                {
-                    _nextState = _state;
-                    _state = state_comment0;
-                }
-                else if (std::isalpha(ch.value()))
-                {
-                    _token = ch;
-                    _state = state_object_plainname;
-                }
-                else if (!std::isspace(ch.value()))
-                    throwInvalidCharacter(ch);
-                break;
+            case state_object_value:
+                ret = _next->parse(p, e);
+                if (ret == 0)
+                    return 0;
 
-            case state_object_plainname:
-                if (std::isalnum(ch.value()) || ch == 'l')
-                    _token += ch;
-                else if (std::isspace(ch.value()))
-                {
-                    _stringParser.str(std::move(_token));
-                    _state = state_object_after_name;
-                }
-                else if (ch == ':')
-                {
-                    _stringParser.str(std::move(_token));
-                    if (_next == 0)
-                        _next = new JsonParser();
-                    log_debug("begin object member " << _stringParser.str());
-                    _deserializer->beginMember(Utf8Codec::encode(_stringParser.str()),
-                            std::string(), SerializationInfo::Void);
-                    _next->begin(*_deserializer);
-                    _stringParser.clear();
-                    _state = state_object_value;
-                }
+                log_debug("leave object member");
+                _deserializer->leaveMember();
+                _state = state_object_e;
+                continue;
+
+            case state_array_value:
+                ret = _next->parse(p, e);
+                if (ret == 0)
+                    return 0;
+
+                _state = state_array_e;
+                continue;
+
+            case state_object_name:
+                if (!_stringParser.advance(p, e))
+                    return 0;
+
+                _state = state_object_after_name;
+                continue;
+
+            case state_string:
+                if (!_stringParser.advance(p, e))
+                    return 0;
+
+                // pure ascii strings are kept as std::string, so that they
+                // need no conversion when read into a std::string later
+                if (_stringParser.ascii())
+                    _deserializer->setValue(_stringParser.str8());
                 else
-                    throwInvalidCharacter(ch);
+                    _deserializer->setValue(Utf8Codec::decode(_stringParser.str8()));
+                _deserializer->setTypeName("string");
+                _stringParser.clear();
+                _state = state_end;
+                return 1;
 
+            case state_number:
+            {
+                const char* b = p;
+                p = skipDigits(p, e);
+                _token.append(b, p);
+                if (p == e)
+                    return 0;
                 break;
+            }
 
-            case state_object_name:
-                if (_stringParser.advance(ch))
-                    _state = state_object_after_name;
+            case state_float:
+            {
+                const char* b = p;
+                while (p != e && isFloatChar(*p))
+                    ++p;
+                _token.append(b, p);
+                if (p == e)
+                    return 0;
                 break;
+            }
 
-            case state_object_after_name:
-                if (ch == ':')
-                {
-                    if (_next == 0)
-                        _next = new JsonParser();
-                    log_debug("begin object member " << _stringParser.str());
-                    _deserializer->beginMember(Utf8Codec::encode(_stringParser.str()),
-                            std::string(), SerializationInfo::Void);
-                    _next->begin(*_deserializer);
-                    _stringParser.clear();
-                    _state = state_object_value;
-                }
-                else if (ch == '/')
-                {
-                    _nextState = _state;
-                    _state = state_comment0;
-                }
-                else if (!std::isspace(ch.value()))
-                    throwInvalidCharacter(ch);
+            default:
                 break;
+        }
 
-            case state_object_value:
-                ret = _next->advance(ch);
+        const char* b = p;
+        Char ch;
+        if (!nextChar(p, e, ch))
+            return 0;
 
-                if (ret != 0)
-                {
-                    log_debug("leave object member");
-                    _deserializer->leaveMember();
-                    _state = state_object_e;
-                }
+        ret = step(ch);
+        if (ret != 0)
+        {
+            if (ret == -1)
+                p = b;
+            return ret;
+        }
 
-                if (ret != -1)
-                    break;
+        if (_deserializer->elementReady())
+            return 0;
+    }
 
-            case state_object_e:
-                if (ch == ',')
-                    _state = state_object_next_member0;
-                else if (ch == '}')
-                {
-                    _state = state_end;
-                    return 1;
-                }
-                else if (ch == '/')
-                {
-                    _nextState = _state;
-                    _state = state_comment0;
-                }
-                else if (!std::isspace(ch.value()))
-                    throwInvalidCharacter(ch);
+    return 0;
+}
+
+int JsonParser::step(Char ch)
+{
+    int ret;
+
+    switch (_state)
+    {
+        case state_beforestart:
+            if (std::isspace(ch.value()))
                 break;
 
-            case state_object_next_member0:
-                if (ch == '}')
-                {
-                    _state = state_end;
-                    return 1;
-                }
-                else if (std::isspace(ch.value()))
-                {
-                    return 0;
-                }
+            _state = state_0;
+            // fallthrough
 
-                _state = state_object_next_member;
+        case state_0:
+            if (ch == '{')
+            {
+                _state = state_object;
+                _deserializer->setCategory(SerializationInfo::Object);
+            }
+            else if (ch == '[')
+            {
+                _state = state_array;
+                _deserializer->setCategory(SerializationInfo::Array);
+            }
+            else if (ch == '"')
+            {
+                _state = state_string;
+                _deserializer->setCategory(SerializationInfo::Value);
+            }
+            else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-')
+            {
+                _token = ch.narrow();
+                _state = state_number;
+                _deserializer->setCategory(SerializationInfo::Value);
+            }
+            else if (ch == '/')
+            {
+                _nextState = _state;
+                _state = state_comment0;
+            }
+            else if (!std::isspace(ch.value()))
+            {
+                _token = ch.narrow();
+                _state = state_token;
+            }
+            break;
 
-                // no break
+        case state_object:
+            if (ch == '"')
+            {
+                _state = state_object_name;
+                _stringParser.clear();
+            }
+            else if (ch == '}')
+            {
+                _state = state_end;
+                return 1;
+            }
+            else if (ch == '/')
+            {
+                _nextState = _state;
+                _state = state_comment0;
+            }
+            else if (std::isalpha(ch.value()))
+            {
+                _token = ch.narrow();
+                _state = state_object_plainname;
+            }
+            else if (!std::isspace(ch.value()))
+                throwInvalidCharacter(ch);
+            break;
 
-            case state_object_next_member:
-                if (ch == '"')
-                {
-                    _state = state_object_name;
-                    _stringParser.clear();
-                }
-                else if (ch == '/')
-                {
-                    _nextState = _state;
-                    _state = state_comment0;
-                }
-                else if (std::isalpha(ch.value()))
-                {
-                    _token = ch;
-                    _state = state_object_plainname;
-                }
-                else if (!std::isspace(ch.value()))
-                    throwInvalidCharacter(ch);
-                break;
+        case state_object_plainname:
+            if (std::isalnum(ch.value()) || ch == 'l')
+                _token += ch.narrow();
+            else if (std::isspace(ch.value()))
+            {
+                _stringParser.str8(std::move(_token));
+                _state = state_object_after_name;
+            }
+            else if (ch == ':')
+            {
+                if (_next == 0)
+                    _next = new JsonParser();
+                log_debug("begin object member " << _token);
+                _deserializer->beginMember(_token, std::string(), SerializationInfo::Void);
+                _token.clear();
+                _next->begin(*_deserializer);
+                _state = state_object_value;
+            }
+            else
+                throwInvalidCharacter(ch);
 
-            case state_array:
-                if (ch == ']')
-                {
-                    _state = state_end;
-                    return 1;
-                }
-                else if (ch == '/')
-                {
-                    _nextState = _state;
-                    _state = state_comment0;
-                }
-                else if (!std::isspace(ch.value()))
-                {
-                    if (_next == 0)
-                        _next = new JsonParser();
-
-                    log_debug("begin array member");
-                    _deserializer->beginMember(std::string(),
-                            std::string(), SerializationInfo::Void);
-                    _next->begin(*_deserializer);
-                    _next->advance(ch);
-                    _state = state_array_value;
-                }
+            break;
+
+        case state_object_name:
+            if (_stringParser.advance(ch))
+                _state = state_object_after_name;
+            break;
+
+        case state_object_after_name:
+            if (ch == ':')
+            {
+                if (_next == 0)
+                    _next = new JsonParser();
+                std::string name = _stringParser.str8();
+                log_debug("begin object member " << name);
+                _deserializer->beginMember(name, std::string(), SerializationInfo::Void);
+                _next->begin(*_deserializer);
+                _stringParser.clear();
+                _state = state_object_value;
+            }
+            else if (ch == '/')
+            {
+                _nextState = _state;
+                _state = state_comment0;
+            }
+            else if (!std::isspace(ch.value()))
+                throwInvalidCharacter(ch);
+            break;
+
+        case state_object_value:
+            ret = _next->advance(ch);
+
+            if (ret != 0)
+            {
+                log_debug("leave object member");
+                _deserializer->leaveMember();
+                _state = state_object_e;
+            }
+
+            if (ret != -1)
                 break;
 
-            case state_array_value0:
-                if (ch == ']')
-                {
-                    _state = state_end;
-                    return 1;
-                }
-                else if (std::isspace(ch.value()))
-                {
-                    return 0;
-                }
+        case state_object_e:
+            if (ch == ',')
+                _state = state_object_next_member0;
+            else if (ch == '}')
+            {
+                _state = state_end;
+                return 1;
+            }
+            else if (ch == '/')
+            {
+                _nextState = _state;
+                _state = state_comment0;
+            }
+            else if (!std::isspace(ch.value()))
+                throwInvalidCharacter(ch);
+            break;
+
+        case state_object_next_member0:
+            if (ch == '}')
+            {
+                _state = state_end;
+                return 1;
+            }
+            else if (std::isspace(ch.value()))
+            {
+                return 0;
+            }
+
+            _state = state_object_next_member;
+
+            // no break
+
+        case state_object_next_member:
+            if (ch == '"')
+            {
+                _state = state_object_name;
+                _stringParser.clear();
+            }
+            else if (ch == '/')
+            {
+                _nextState = _state;
+                _state = state_comment0;
+            }
+            else if (std::isalpha(ch.value()))
+            {
+                _token = ch.narrow();
+                _state = state_object_plainname;
+            }
+            else if (!std::isspace(ch.value()))
+                throwInvalidCharacter(ch);
+            break;
+
+        case state_array:
+            if (ch == ']')
+            {
+                _state = state_end;
+                return 1;
+            }
+            else if (ch == '/')
+            {
+                _nextState = _state;
+                _state = state_comment0;
+            }
+            else if (!std::isspace(ch.value()))
+            {
+                if (_next == 0)
+                    _next = new JsonParser();
 
                 log_debug("begin array member");
                 _deserializer->beginMember(std::string(),
                         std::string(), SerializationInfo::Void);
                 _next->begin(*_deserializer);
+                _next->advance(ch);
                 _state = state_array_value;
+            }
+            break;
 
-                // no break
+        case state_array_value0:
+            if (ch == ']')
+            {
+                _state = state_end;
+                return 1;
+            }
+            else if (std::isspace(ch.value()))
+            {
+                return 0;
+            }
 
-            case state_array_value:
-                ret = _next->advance(ch);
-                if (ret != 0)
-                    _state = state_array_e;
-                if (ret != -1)
-                    break;
+            log_debug("begin array member");
+            _deserializer->beginMember(std::string(),
+                    std::string(), SerializationInfo::Void);
+            _next->begin(*_deserializer);
+            _state = state_array_value;
 
-            case state_array_e:
-                if (ch == ']')
-                {
-                    log_debug("leave array member");
-                    _deserializer->leaveMember();
-                    _state = state_end;
-                    return 1;
-                }
-                else if (ch == ',')
-                {
-                    log_debug("leave array member");
-                    _deserializer->leaveMember();
+            // no break
 
-                    _state = state_array_value0;
-                }
-                else if (ch == '/')
-                {
-                    _nextState = _state;
-                    _state = state_comment0;
-                }
-                else if (!std::isspace(ch.value()))
-                    throwInvalidCharacter(ch);
+        case state_array_value:
+            ret = _next->advance(ch);
+            if (ret != 0)
+                _state = state_array_e;
+            if (ret != -1)
                 break;
 
-            case state_string:
-                if (_stringParser.advance(ch))
-                {
-                    log_debug("set string value \"" << _stringParser.str() << '"');
-                    _deserializer->setValue(_stringParser.str());
-                    _deserializer->setTypeName("string");
-                    _stringParser.clear();
-                    _state = state_end;
-                    return 1;
-                }
-                break;
+        case state_array_e:
+            if (ch == ']')
+            {
+                log_debug("leave array member");
+                _deserializer->leaveMember();
+                _state = state_end;
+                return 1;
+            }
+            else if (ch == ',')
+            {
+                log_debug("leave array member");
+                _deserializer->leaveMember();
 
-            case state_number:
-                if (std::isspace(ch.value()))
-                {
-                    log_debug("set int value \"" << _token << '"');
-                    _deserializer->setValue(std::move(_token));
-                    _deserializer->setTypeName("int");
-                    _token.clear();
-                    return 1;
-                }
-                else if (ch == '.' || ch == 'e' || ch == 'E')
-                {
-                    _token += ch;
-                    _state = state_float;
-                }
-                else if (ch >= '0' && ch <= '9')
-                {
-                    _token += ch;
-                }
-                else
-                {
-                    log_debug("set int value \"" << _token << '"');
-                    _deserializer->setValue(std::move(_token));
-                    _deserializer->setTypeName("int");
-                    _token.clear();
-                    return -1;
-                }
-                break;
+                _state = state_array_value0;
+            }
+            else if (ch == '/')
+            {
+                _nextState = _state;
+                _state = state_comment0;
+            }
+            else if (!std::isspace(ch.value()))
+                throwInvalidCharacter(ch);
+            break;
 
-            case state_float:
-                if (std::isspace(ch.value()))
+        case state_string:
+            if (_stringParser.advance(ch))
+            {
+                log_debug("set string value \"" << _stringParser.str() << '"');
+                _deserializer->setValue(_stringParser.str());
+                _deserializer->setTypeName("string");
+                _stringParser.clear();
+                _state = state_end;
+                return 1;
+            }
+            break;
+
+        case state_number:
+            if (std::isspace(ch.value()))
+            {
+                log_debug("set int value \"" << _token << '"');
+                _deserializer->setValue(std::move(_token));
+                _deserializer->setTypeName("int");
+                _token.clear();
+                return 1;
+            }
+            else if (ch == '.' || ch == 'e' || ch == 'E')
+            {
+                _token += ch.narrow();
+                _state = state_float;
+            }
+            else if (ch >= '0' && ch <= '9')
+            {
+                _token += ch.narrow();
+            }
+            else
+            {
+                log_debug("set int value \"" << _token << '"');
+                _deserializer->setValue(std::move(_token));
+                _deserializer->setTypeName("int");
+                _token.clear();
+                return -1;
+            }
+            break;
+
+        case state_float:
+            if (std::isspace(ch.value()))
+            {
+                log_debug("set double value \"" << _token << '"');
+                _deserializer->setValue(std::move(_token));
+                _deserializer->setTypeName("double");
+                _token.clear();
+                return 1;
+            }
+            else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-'
+                    || ch == '.' || ch == 'e' || ch == 'E')
+                _token += ch.narrow();
+            else
+            {
+                log_debug("set double value \"" << _token << '"');
+                _deserializer->setValue(std::move(_token));
+                _deserializer->setTypeName("double");
+                _token.clear();
+                return -1;
+            }
+            break;
+
+        case state_token:
+            if (std::isalpha(ch.value()))
+                _token += static_cast<char>(std::tolower(static_cast<unsigned char>(ch.narrow())));
+            else
+            {
+                if (_token == "true" || _token == "false")
                 {
-                    log_debug("set double value \"" << _token << '"');
+                    log_debug("set bool value \"" << _token << '"');
                     _deserializer->setValue(std::move(_token));
-                    _deserializer->setTypeName("double");
+                    _deserializer->setTypeName("bool");
                     _token.clear();
-                    return 1;
                 }
-                else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-'
-                        || ch == '.' || ch == 'e' || ch == 'E')
-                    _token += ch;
-                else
+                else if (_token == "null")
                 {
-                    log_debug("set double value \"" << _token << '"');
-                    _deserializer->setValue(std::move(_token));
-                    _deserializer->setTypeName("double");
+                    log_debug("set null value \"" << _token << '"');
+                    _deserializer->setTypeName("null");
+                    _deserializer->setNull();
                     _token.clear();
-                    return -1;
                 }
-                break;
 
-            case state_token:
-                if (std::isalpha(ch.value()))
-                    _token += Char(std::tolower(ch));
-                else
-                {
-                    if (_token == "true" || _token == "false")
-                    {
-                        log_debug("set bool value \"" << _token << '"');
-                        _deserializer->setValue(std::move(_token));
-                        _deserializer->setTypeName("bool");
-                        _token.clear();
-                    }
-                    else if (_token == "null")
-                    {
-                        log_debug("set null value \"" << _token << '"');
-                        _deserializer->setTypeName("null");
-                        _deserializer->setNull();
-                        _token.clear();
-                    }
-
-                    return -1;
-                }
+                return -1;
+            }
 
-                break;
+            break;
 
-            case state_comment0:
-                if (ch == '/')
-                    _state = state_commentline;
-                else if (ch == '*')
-                    _state = state_comment;
-                else
-                    throwInvalidCharacter(ch);
-                break;
+        case state_comment0:
+            if (ch == '/')
+                _state = state_commentline;
+            else if (ch == '*')
+                _state = state_comment;
+            else
+                throwInvalidCharacter(ch);
+            break;
 
-            case state_commentline:
-                if (ch == '\n')
-                    _state = _nextState;
-                break;
+        case state_commentline:
+            if (ch == '\n')
+                _state = _nextState;
+            break;
 
-            case state_comment:
-                if (ch == '*')
-                    _state = state_comment_e;
-                break;
+        case state_comment:
+            if (ch == '*')
+                _state = state_comment_e;
+            break;
 
-            case state_comment_e:
-                if (ch == '/')
-                    _state = _nextState;
-                else if (ch != '*')
-                    _state = state_comment;
-                break;
+        case state_comment_e:
+            if (ch == '/')
+                _state = _nextState;
+            else if (ch != '*')
+                _state = state_comment;
+            break;
 
-            case state_end:
-                if (ch == '/')
-                {
-                    _nextState = _state;
-                    _state = state_comment0;
-                }
-                else if (!std::isspace(ch.value()))
-                    doThrow(std::string("unexpected character '") + ch.narrow() + "\' after end in json parser");
-                break;
-        }
-    }
-    catch (JsonParserError& e)
-    {
-        e._lineNo = _lineNo;
-        throw;
+        case state_end:
+            if (ch == '/')
+            {
+                _nextState = _state;
+                _state = state_comment0;
+            }
+            else if (!std::isspace(ch.value()))
+                doThrow(std::string("unexpected character '") + ch.narrow() + "\' after end in json parser");
+            break;
     }
 
     return 0;
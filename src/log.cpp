@@ -40,18 +40,33 @@
 #include <cxxtools/datetime.h>
 
 #include "dateutils.h"
+#include "logbinary.h"
 
 #include <mutex>
 #include <memory>
 #include <atomic>
+#include <condition_variable>
+#include <thread>
 #include <iterator>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <fstream>
 #include <sstream>
+#include <locale>
+#include <type_traits>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
+#if __cplusplus >= 201703L
+#include <charconv>
+#ifdef __cpp_lib_to_chars
+#define CXXTOOLS_LOG_TO_CHARS
+#endif
+#endif
 
 #include <unistd.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <fcntl.h>
@@ -84,60 +99,13 @@ namespace
 {
     std::mutex loggersMutex;
     std::mutex logMutex;
-    std::mutex poolMutex;
+    // Serializes writes to the appender between logging threads and the
+    // writer thread of asynchronous logging; taken after logMutex.
+    std::mutex appenderMutex;
     atomic_t mutexWaitCount(0);
-
-    template <typename T, unsigned MaxPoolSize = 8>
-    class LPool
-    {
-        std::vector<T*> pool;
-        std::mutex mutex;
-
-        LPool(const LPool&);
-        LPool& operator=(const LPool&);
-
-      public:
-        LPool() { }
-
-        ~LPool()
-        {
-            for (unsigned n = 0; n < pool.size(); ++n)
-                delete pool[n];
-        }
-
-        T* getInstance()
-        {
-            if (pool.empty())
-            {
-                 // we don't care about locking here since it is not dangerous to get a false answer
-                 return new T();
-            }
-
-            T* impl;
-
-            {
-                std::lock_guard<std::mutex> lock(poolMutex);
-                if (pool.empty())
-                    return new T();
-
-                impl = pool.back();
-                pool.pop_back();
-            }
-
-            return impl;
-        }
-
-        void releaseInstance(T* inst)
-        {
-            std::lock_guard<std::mutex> lock(poolMutex);
-
-            if (pool.size() < MaxPoolSize)
-                pool.push_back(inst);
-            else
-                delete inst;
-        }
-
-    };
+    // Logging threads, which use the log manager without logMutex;
+    // ~LogManager waits for them before it deletes the manager.
+    atomic_t managerUsers(0);
 
     class ScopedAtomicIncrementer
     {
@@ -165,14 +133,85 @@ namespace
         }
     };
 
+    // incremented in the child after fork, so that the process id is
+    // looked up again
+    atomic_t forkGeneration(1);
+
+    void incrementForkGeneration()
+    {
+        ++forkGeneration;
+    }
+
+    // Process and thread id of the current thread, looked up once per
+    // thread instead of calling getpid() for every message.
+    struct ThreadInfo
+    {
+        unsigned generation;
+        pid_t pid;
+        bool hex;
+        char tag[64];   // "[pid.tid] " or empty
+    };
+
+    ThreadInfo& threadInfo()
+    {
+        static thread_local ThreadInfo info;
+
+        if (info.generation != forkGeneration.load(std::memory_order_relaxed))
+        {
+            static const int atforkRegistered = pthread_atfork(0, 0, incrementForkGeneration);
+            (void)atforkRegistered;
+
+            info.generation = forkGeneration.load(std::memory_order_relaxed);
+            info.pid = getpid();
+            info.tag[0] = '\0';
+        }
+
+        return info;
+    }
+
+    // Returns "[pid.tid] " of the current thread.
+    const char* threadTag(bool hex)
+    {
+        ThreadInfo& info = threadInfo();
+
+        if (info.tag[0] == '\0' || info.hex != hex)
+        {
+            char* p = info.tag;
+            *p++ = '[';
+            p = putInt(p, info.pid);
+            *p++ = '.';
+            if (hex)
+            {
+                static const char hexdigit[] = "0123456789abcdef";
+
+                pthread_t tid = pthread_self();
+                unsigned short sw = (sizeof(pthread_t) << 3) - 4;
+                for (unsigned short n = 0; n < sizeof(pthread_t) * 2; ++n, sw -= 4)
+                    *p++ = hexdigit[(tid >> sw) & 0xf];
+            }
+            else
+            {
+                p = putInt(p, (unsigned long)pthread_self());
+            }
+
+            *p++ = ']';
+            *p++ = ' ';
+            *p = '\0';
+
+            info.hex = hex;
+        }
+
+        return info.tag;
+    }
+
     void logentry(std::string& entry, const char* level, const std::string& category, const LogFormat& logFormat)
     {
         struct timeval t;
         gettimeofday(&t, 0);
 
         // format date only once per second:
-        static char date[20];
-        static time_t psec = 0;
+        static thread_local char date[20];
+        static thread_local time_t psec = 0;
         time_t sec = static_cast<time_t>(t.tv_sec);
         if (sec != psec)
         {
@@ -215,33 +254,55 @@ namespace
         entry += static_cast<char>('0' + t.tv_usec / 100 % 10);
         entry += static_cast<char>('0' + t.tv_usec / 10 % 10);
         entry += ' ';
-        entry += '[';
-        char str[64];
-        char* p = putInt(str, getpid());
-        entry.append(str, p - str);
-        entry += '.';
-        if (logFormat.threadIdHex())
-        {
-            static const char hexdigit[] = "0123456789abcdef";
-
-            pthread_t tid = pthread_self();
-            unsigned short sw = (sizeof(pthread_t) << 3) - 4;
-            for (unsigned short n = 0; n < sizeof(pthread_t) * 2; ++n, sw -= 4)
-                entry += hexdigit[(tid >> sw) & 0xf];
-        }
-        else
-        {
-            p = putInt(str, (unsigned long)pthread_self());
-        }
-
-        entry.append(str, p - str);
-        entry += "] ";
+        entry.append(threadTag(logFormat.threadIdHex()));
         entry += level;
         entry += ' ';
         entry += category;
         entry += " - ";
     }
 
+    // Header of a message in binary mode as passed to the binary file
+    // appender. It is followed by the level, the category, the message
+    // text with placeholders and the raw arguments.
+    struct BinaryEntry
+    {
+        int64_t time;       // microseconds since the epoch
+        uint64_t thread;
+        uint32_t pid;
+        uint32_t textSize;
+        uint16_t categorySize;
+        uint8_t levelSize;
+    };
+
+    // starts a binary entry; the message text is appended after it
+    void binaryEntry(std::string& entry, const char* level, const std::string& category)
+    {
+        struct timeval t;
+        gettimeofday(&t, 0);
+
+        BinaryEntry header;
+        header.time = static_cast<int64_t>(t.tv_sec) * 1000000 + t.tv_usec;
+        header.thread = (uint64_t)pthread_self();
+        header.pid = threadInfo().pid;
+        header.textSize = 0;
+        header.categorySize = static_cast<uint16_t>(std::min<std::size_t>(category.size(), 0xffff));
+        header.levelSize = static_cast<uint8_t>(std::min<std::size_t>(strlen(level), 0xff));
+
+        entry.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        entry.append(level, header.levelSize);
+        entry.append(category.data(), header.categorySize);
+    }
+
+    // completes a binary entry after the message text
+    void binaryEntryEnd(std::string& entry, const std::string& args)
+    {
+        BinaryEntry header;
+        memcpy(&header, entry.data(), sizeof(header));
+        header.textSize = static_cast<uint32_t>(entry.size() - sizeof(header) - header.levelSize - header.categorySize);
+        memcpy(&entry[0], &header, sizeof(header));
+        entry += args;
+    }
+
     class LogAppender : public RefCounted
     {
     public:
@@ -308,6 +369,13 @@ namespace
 
         void closeFile();
         void openFile();
+
+    protected:
+        // opens the file or switches to the next file name of the pattern
+        void checkFile();
+
+        // called after the file is opened
+        virtual void fileOpened() { }
     };
 
     FileAppender::FileAppender(const std::string& fname)
@@ -332,6 +400,9 @@ namespace
             ::fcntl(_fd, F_SETFD, flags);
         }
 #endif
+
+        if (_fd >= 0)
+            fileOpened();
     }
 
     void FileAppender::closeFile()
@@ -343,7 +414,7 @@ namespace
         }
     }
 
-    void FileAppender::putMessage(const std::string& msg)
+    void FileAppender::checkFile()
     {
         if (!_fpattern.empty())
         {
@@ -498,7 +569,11 @@ namespace
 
         if (_fd == -1)
             openFile();
+    }
 
+    void FileAppender::putMessage(const std::string& msg)
+    {
+        checkFile();
         FdAppender::putMessage(msg);
     }
 
@@ -584,6 +659,210 @@ namespace
         _fsize += msg.size() + 1;  // FileAppender adds line feed to the message
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // LogDictionary - assigns ids to texts of binary log files
+    //
+    class LogDictionary
+    {
+        typedef std::unordered_map<std::string, uint32_t> Ids;
+
+        Ids _ids;
+        std::string _key;
+        logbinary::RecordType _type;
+
+    public:
+        // limits the memory used by messages with variable text
+        static const unsigned maxSize = 16384;
+
+        explicit LogDictionary(logbinary::RecordType type)
+          : _type(type)
+        { }
+
+        // Returns the id of the text or 0 when the dictionary is full. New
+        // texts are defined by a record appended to out.
+        uint32_t id(const char* text, std::size_t size, std::string& out);
+
+        void clear()
+        { _ids.clear(); }
+    };
+
+    template <typename T>
+    void appendRaw(std::string& out, T value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    uint32_t LogDictionary::id(const char* text, std::size_t size, std::string& out)
+    {
+        _key.assign(text, size);
+        Ids::const_iterator it = _ids.find(_key);
+        if (it != _ids.end())
+            return it->second;
+
+        if (_ids.size() >= maxSize)
+            return 0;
+
+        uint32_t id = static_cast<uint32_t>(_ids.size() + 1);
+        _ids.insert(Ids::value_type(_key, id));
+
+        out += static_cast<char>(_type);
+        appendRaw(out, static_cast<uint32_t>(sizeof(id) + size));
+        appendRaw(out, id);
+        out.append(text, size);
+
+        return id;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // BinaryFileAppender - writes binary records, see logbinary.h
+    //
+    class BinaryFileAppender : public FileAppender
+    {
+        LogDictionary _levels;
+        LogDictionary _categories;
+        LogDictionary _formats;
+
+        // The ids of level, category and format text, which are adjacent
+        // in the entry, are looked up together, so that a message needs
+        // just one lookup.
+        struct MessageIds
+        {
+            uint32_t level;
+            uint32_t category;
+            uint32_t format;
+        };
+
+        typedef std::unordered_map<std::string, MessageIds> MessageIdsMap;
+        MessageIdsMap _messageIds;
+        std::string _key;
+
+    protected:
+        virtual void fileOpened();
+
+    public:
+        explicit BinaryFileAppender(const std::string& fname)
+          : FileAppender(fname),
+            _levels(logbinary::LevelRecord),
+            _categories(logbinary::CategoryRecord),
+            _formats(logbinary::FormatRecord)
+        { }
+
+        virtual void putMessage(const std::string& msg);
+    };
+
+    void BinaryFileAppender::fileOpened()
+    {
+        _levels.clear();
+        _categories.clear();
+        _formats.clear();
+        _messageIds.clear();
+
+        _msg += static_cast<char>(logbinary::StartRecord);
+        appendRaw(_msg, static_cast<uint32_t>(sizeof(logbinary::magic) + 1 + sizeof(uint32_t)));
+        _msg.append(logbinary::magic, sizeof(logbinary::magic));
+        _msg += static_cast<char>(logbinary::version);
+        appendRaw(_msg, static_cast<uint32_t>(logbinary::byteOrder));
+    }
+
+    void BinaryFileAppender::putMessage(const std::string& msg)
+    {
+        BinaryEntry header;
+        if (msg.size() < sizeof(header))
+            return;
+        memcpy(&header, msg.data(), sizeof(header));
+
+        const char* level = msg.data() + sizeof(header);
+        const char* category = level + header.levelSize;
+        const char* text = category + header.categorySize;
+        const char* args = text + header.textSize;
+        const char* end = msg.data() + msg.size();
+        if (args > end)
+            return;
+
+        checkFile();
+
+        // the sizes are part of the key, since the texts are not separated
+        _key.assign(reinterpret_cast<const char*>(&header.levelSize), sizeof(header.levelSize));
+        _key.append(reinterpret_cast<const char*>(&header.categorySize), sizeof(header.categorySize));
+        _key.append(level, args - level);
+
+        MessageIds ids;
+        MessageIdsMap::const_iterator it = _messageIds.find(_key);
+        if (it != _messageIds.end())
+        {
+            ids = it->second;
+        }
+        else
+        {
+            // definitions are written before the message, which uses them
+            ids.level = _levels.id(level, header.levelSize, _msg);
+            ids.category = _categories.id(category, header.categorySize, _msg);
+            ids.format = _formats.id(text, header.textSize, _msg);
+            if (ids.level != 0 && ids.category != 0 && ids.format != 0)
+                _messageIds.insert(MessageIdsMap::value_type(_key, ids));
+        }
+
+        if (ids.level != 0 && ids.category != 0 && ids.format != 0)
+        {
+            // the usual case: a fixed size part and the arguments
+            struct
+            {
+                char type;
+                char size[4];
+                char ids[12];
+                char time[8];
+                char pid[4];
+                char thread[8];
+            } record;
+
+            uint32_t size = static_cast<uint32_t>(sizeof(record) - 5 + (end - args));
+            record.type = static_cast<char>(logbinary::MessageRecord);
+            memcpy(record.size, &size, sizeof(size));
+            memcpy(record.ids, &ids, sizeof(ids));
+            memcpy(record.time, &header.time, sizeof(header.time));
+            memcpy(record.pid, &header.pid, sizeof(header.pid));
+            memcpy(record.thread, &header.thread, sizeof(header.thread));
+
+            _msg.append(reinterpret_cast<const char*>(&record), sizeof(record));
+            _msg.append(args, end - args);
+            return;
+        }
+
+        _msg += static_cast<char>(logbinary::MessageRecord);
+        std::string::size_type sizePos = _msg.size();
+        appendRaw(_msg, uint32_t(0));
+
+        appendRaw(_msg, ids.level);
+        appendRaw(_msg, ids.category);
+        appendRaw(_msg, ids.format);
+
+        if (ids.level == 0)
+        {
+            appendRaw(_msg, static_cast<uint32_t>(header.levelSize));
+            _msg.append(level, header.levelSize);
+        }
+
+        if (ids.category == 0)
+        {
+            appendRaw(_msg, static_cast<uint32_t>(header.categorySize));
+            _msg.append(category, header.categorySize);
+        }
+
+        if (ids.format == 0)
+        {
+            appendRaw(_msg, header.textSize);
+            _msg.append(text, header.textSize);
+        }
+
+        appendRaw(_msg, header.time);
+        appendRaw(_msg, header.pid);
+        appendRaw(_msg, header.thread);
+        _msg.append(args, end - args);
+
+        uint32_t size = static_cast<uint32_t>(_msg.size() - sizePos - sizeof(uint32_t));
+        memcpy(&_msg[sizePos], &size, sizeof(size));
+    }
+
     //////////////////////////////////////////////////////////////////////
     // UdpAppender
     //
@@ -618,6 +897,310 @@ namespace
         _msg.clear();
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // AsyncWriter - passes messages through a ring buffer to a background
+    // thread, which writes them to the appender
+    //
+    // The ring is a bounded multi producer queue of message slots. Each
+    // slot has a sequence number, which tells whether it is free for
+    // position n (seq == n) or filled (seq == n + 1). Messages are swapped
+    // into and out of the slots, so the strings keep their capacity and
+    // no memory is allocated once the ring is warm.
+    //
+    class AsyncWriter
+    {
+        struct Slot
+        {
+            std::atomic<unsigned long> seq;
+            std::string msg;
+        };
+
+        Slot* _slots;
+        unsigned long _mask;
+        std::atomic<unsigned long> _head;     // next position to fill
+        unsigned long _tail;                  // next position to write; writer thread only
+        std::atomic<unsigned long> _flushTo;  // highest position to flush
+        std::atomic<unsigned long> _flushed;  // all positions below are written
+        std::atomic<unsigned long> _dropped;
+        std::atomic<bool> _block;
+
+        LogAppender* _appender;
+
+        std::mutex _mutex;
+        std::condition_variable _wakeWriter;
+        std::condition_variable _wakeProducers;
+        // The writer dozes, when it caught up. Producers wake it only every
+        // quarter of the ring, so that it writes messages in batches instead
+        // of switching with the producers for each message. The doze times
+        // out after a short time. When there was nothing to do, the writer
+        // sleeps and the next message wakes it.
+        enum { Running, Dozing, Sleeping };
+        std::atomic<int> _writerState;
+        std::atomic<unsigned> _producersWaiting;
+        bool _stop;
+        std::thread _thread;
+
+        bool ready(unsigned long pos) const
+        { return _slots[pos & _mask].seq.load(std::memory_order_seq_cst) == pos + 1; }
+
+        void run();
+        void write(std::string& msg, bool flush);
+        void wakeProducers();
+        bool waitForSpace(unsigned long pos);
+
+    public:
+        AsyncWriter(unsigned size, LogConfiguration::OverflowPolicy overflow, LogAppender* appender);
+        ~AsyncWriter();
+
+        void setOverflowPolicy(LogConfiguration::OverflowPolicy overflow)
+        { _block = overflow == LogConfiguration::OverflowBlock; }
+
+        /// Writes the queued messages to the current appender and
+        /// switches to the new one.
+        void setAppender(LogAppender* appender);
+
+        /// Queues the message; msg is swapped with an empty string.
+        void put(std::string& msg, bool flush);
+
+        void flush();
+
+        unsigned long dropped() const
+        { return _dropped.load(std::memory_order_relaxed); }
+    };
+
+    AsyncWriter::AsyncWriter(unsigned size, LogConfiguration::OverflowPolicy overflow, LogAppender* appender)
+      : _head(0),
+        _tail(0),
+        _flushTo(0),
+        _flushed(0),
+        _dropped(0),
+        _block(overflow == LogConfiguration::OverflowBlock),
+        _appender(appender),
+        _writerState(Running),
+        _producersWaiting(0),
+        _stop(false)
+    {
+        unsigned long n = 2;
+        while (n < size)
+            n <<= 1;
+
+        _slots = new Slot[n];
+        _mask = n - 1;
+        for (unsigned long i = 0; i < n; ++i)
+            _slots[i].seq.store(i, std::memory_order_relaxed);
+
+        _thread = std::thread(&AsyncWriter::run, this);
+    }
+
+    AsyncWriter::~AsyncWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+            _wakeWriter.notify_one();
+        }
+
+        _thread.join();
+        delete[] _slots;
+    }
+
+    void AsyncWriter::setAppender(LogAppender* appender)
+    {
+        flush();
+        std::lock_guard<std::mutex> lock(appenderMutex);
+        _appender = appender;
+    }
+
+    void AsyncWriter::put(std::string& msg, bool flush)
+    {
+        unsigned long pos = _head.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+        {
+            slot = &_slots[pos & _mask];
+            unsigned long seq = slot->seq.load(std::memory_order_acquire);
+            long diff = static_cast<long>(seq - pos);
+            if (diff == 0)
+            {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // the ring is full
+                if (!_block || !waitForSpace(pos))
+                {
+                    _dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                pos = _head.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->msg.swap(msg);
+        slot->seq.store(pos + 1, std::memory_order_seq_cst);
+
+        int writerState = _writerState.load(std::memory_order_seq_cst);
+        if (writerState == Sleeping || (writerState == Dozing && (pos & (_mask >> 2)) == 0))
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _wakeWriter.notify_one();
+        }
+
+        if (flush)
+        {
+            unsigned long flushTo = _flushTo.load(std::memory_order_relaxed);
+            while (flushTo < pos + 1
+                && !_flushTo.compare_exchange_weak(flushTo, pos + 1, std::memory_order_seq_cst))
+                ;
+
+            _producersWaiting.fetch_add(1, std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (_writerState != Running)
+                    _wakeWriter.notify_one();
+                while (_flushed.load() < pos + 1 && !_stop)
+                    _wakeProducers.wait(lock);
+            }
+            _producersWaiting.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void AsyncWriter::flush()
+    {
+        unsigned long pos = _head.load();
+        if (pos == 0)
+            return;
+
+        unsigned long flushTo = _flushTo.load(std::memory_order_relaxed);
+        while (flushTo < pos
+            && !_flushTo.compare_exchange_weak(flushTo, pos, std::memory_order_seq_cst))
+            ;
+
+        _producersWaiting.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_writerState != Running)
+                _wakeWriter.notify_one();
+            while (_flushed.load() < pos && !_stop)
+                _wakeProducers.wait(lock);
+        }
+        _producersWaiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool AsyncWriter::waitForSpace(unsigned long pos)
+    {
+        bool stopped;
+        _producersWaiting.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (static_cast<long>(_slots[pos & _mask].seq.load(std::memory_order_seq_cst) - pos) < 0 && !_stop)
+                _wakeProducers.wait(lock);
+            stopped = _stop;
+        }
+        _producersWaiting.fetch_sub(1, std::memory_order_relaxed);
+        return !stopped;
+    }
+
+    void AsyncWriter::wakeProducers()
+    {
+        if (_producersWaiting.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _wakeProducers.notify_all();
+        }
+    }
+
+    void AsyncWriter::write(std::string& msg, bool flush)
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock(appenderMutex);
+            _appender->putMessage(msg);
+            _appender->finish(flush);
+        }
+        catch (const std::exception&)
+        {
+        }
+    }
+
+    void AsyncWriter::run()
+    {
+        std::string msg;
+        unsigned long reported = 0;
+        bool idle = false;
+
+        while (true)
+        {
+            if (ready(_tail))
+            {
+                Slot& slot = _slots[_tail & _mask];
+                msg.swap(slot.msg);
+                slot.seq.store(_tail + _mask + 1, std::memory_order_seq_cst);
+                ++_tail;
+
+                // flush, when we catch up or a fatal message or flush call waits for it
+                unsigned long flushTo = _flushTo.load(std::memory_order_seq_cst);
+                bool flush = !ready(_tail)
+                          || (flushTo > _flushed.load(std::memory_order_relaxed) && _tail >= flushTo);
+
+                write(msg, flush);
+                msg.clear();
+
+                if (flush)
+                    _flushed.store(_tail, std::memory_order_seq_cst);
+
+                // producers waiting for space are woken, when a quarter of
+                // the ring is free again, so that they do not switch back
+                // and forth with the writer for each message
+                if (flush || (_tail & (_mask >> 2)) == 0)
+                    wakeProducers();
+                continue;
+            }
+
+            unsigned long dropped = _dropped.load(std::memory_order_relaxed);
+            if (dropped != reported)
+            {
+                logentry(msg, "WARN", "cxxtools.log", LogFormat());
+                char str[64];
+                char* p = putInt(str, dropped - reported);
+                msg.append(str, p - str);
+                msg += " log messages dropped";
+                write(msg, true);
+                msg.clear();
+                reported = dropped;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _writerState.store(idle ? Sleeping : Dozing, std::memory_order_seq_cst);
+            if (!ready(_tail))
+            {
+                if (_stop)
+                    break;
+
+                if (idle)
+                {
+                    _wakeWriter.wait(lock);
+                    idle = false;
+                }
+                else
+                {
+                    idle = _wakeWriter.wait_for(lock, std::chrono::milliseconds(10)) == std::cv_status::timeout
+                        && !ready(_tail);
+                }
+            }
+            _writerState.store(Running, std::memory_order_relaxed);
+        }
+
+        // release producers, which are still waiting
+        _wakeProducers.notify_all();
+    }
+
     //////////////////////////////////////////////////////////////////////
     int throwInvalidLogLevel(const std::string& level, const std::string& category)
     {
@@ -815,6 +1398,10 @@ private:
     bool _broadcast;
     bool _tostdout;  // flag for console output: true=stdout, false=stderr
     LogFormat _logFormat;
+    bool _async;
+    unsigned _asyncBufferSize;
+    OverflowPolicy _overflow;
+    bool _binary;
 
     int _rootFlags;
     LogFlags _logFlags;
@@ -828,6 +1415,10 @@ public:
         _logport(0),
         _broadcast(true),
         _tostdout(false),
+        _async(false),
+        _asyncBufferSize(8192),
+        _overflow(OverflowBlock),
+        _binary(false),
         _rootFlags(rootFlags)
     { }
 
@@ -839,6 +1430,10 @@ public:
     bool broadcast() const                    { return _broadcast; }
     bool tostdout() const                     { return _tostdout; }
     const LogFormat& logFormat() const        { return _logFormat; }
+    bool async() const                        { return _async; }
+    unsigned asyncBufferSize() const          { return _asyncBufferSize; }
+    OverflowPolicy overflow() const           { return _overflow; }
+    bool binary() const                       { return _binary; }
 
     int rootFlags() const                     { return _rootFlags; }
     int logFlags(const std::string& category) const;
@@ -897,6 +1492,16 @@ public:
 
     void setLogFormat(const LogFormat& logFormat)
     { _logFormat = logFormat; }
+
+    void setAsync(bool sw, unsigned bufferSize, OverflowPolicy overflow)
+    {
+        _async = sw;
+        _asyncBufferSize = bufferSize;
+        _overflow = overflow;
+    }
+
+    void setBinary(bool sw)
+    { _binary = sw; }
 };
 
 int LogConfiguration::Impl::logFlags(const std::string& category) const
@@ -975,6 +1580,24 @@ void operator>>= (const SerializationInfo& si, LogConfiguration::Impl& impl)
 
     si.getMember("logFormat", impl._logFormat);
 
+    if (!si.getMember("async", impl._async))
+        impl._async = false;
+    si.getMember("asyncBufferSize", impl._asyncBufferSize);
+
+    std::string overflow;
+    if (si.getMember("overflow", overflow))
+    {
+        if (compareIgnoreCase(overflow.c_str(), "block") == 0)
+            impl._overflow = LogConfiguration::OverflowBlock;
+        else if (compareIgnoreCase(overflow.c_str(), "drop") == 0)
+            impl._overflow = LogConfiguration::OverflowDrop;
+        else
+            throw std::runtime_error("unknown overflow policy \"" + overflow + '"');
+    }
+
+    if (!si.getMember("binary", impl._binary))
+        impl._binary = false;
+
     std::string rootFlags;
     if (!si.getMember("rootlogger", rootFlags))
         impl._rootFlags = Logger::LOG_LEVEL_FATAL;
@@ -1059,6 +1682,16 @@ void operator<<= (SerializationInfo& si, const LogConfiguration::Impl& impl)
         si.addMember("tostdout") <<= true;
 
     si.addMember("logFormat") <<= impl._logFormat;
+
+    if (impl._async)
+    {
+        si.addMember("async") <<= true;
+        si.addMember("asyncBufferSize") <<= impl._asyncBufferSize;
+        si.addMember("overflow") <<= (impl._overflow == LogConfiguration::OverflowDrop ? "drop" : "block");
+    }
+
+    if (impl._binary)
+        si.addMember("binary") <<= true;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -1154,6 +1787,16 @@ void LogConfiguration::setLogFormat(const LogFormat& logFormat)
     _impl->setLogFormat(logFormat);
 }
 
+void LogConfiguration::setAsync(bool sw, unsigned bufferSize, OverflowPolicy overflow)
+{
+    _impl->setAsync(sw, bufferSize, overflow);
+}
+
+void LogConfiguration::setBinary(bool sw)
+{
+    _impl->setBinary(sw);
+}
+
 void operator>>= (const SerializationInfo& si, LogConfiguration& logConfiguration)
 {
     si >>= *logConfiguration.impl();
@@ -1171,6 +1814,9 @@ void operator<<= (SerializationInfo& si, const LogConfiguration& logConfiguratio
 class LogManager::Impl
 {
     std::unique_ptr<LogAppender> _appender;
+    std::unique_ptr<AsyncWriter> _asyncWriter;  // destroyed before the appender
+    std::atomic<bool> _async;
+    std::atomic<bool> _binary;
     LogConfiguration _config;
     typedef std::map<std::string, Logger*> Loggers;  // map category => logger
     Loggers _loggers;
@@ -1178,6 +1824,12 @@ class LogManager::Impl
     Impl(const Impl&) = delete;
     Impl& operator=(const Impl&) = delete;
 
+    static LogAppender* newAppender(const LogConfiguration& config);
+
+    // binary records are only written to files
+    static bool isBinary(const LogConfiguration& config)
+    { return config.impl()->binary() && !config.impl()->fname().empty(); }
+
 public:
     explicit Impl(const LogConfiguration& config);
     ~Impl();
@@ -1189,7 +1841,24 @@ public:
     Logger* getLogger(const std::string& category);
     LogAppender& appender()
     { return *_appender; }
-  
+
+    // returns the writer when asynchronous logging is enabled
+    AsyncWriter* asyncWriter()
+    { return _async.load(std::memory_order_relaxed) ? _asyncWriter.get() : 0; }
+
+    // returns true when messages are written as binary records
+    bool binary() const
+    { return _binary.load(std::memory_order_relaxed); }
+
+    void flush()
+    {
+        if (_asyncWriter)
+            _asyncWriter->flush();
+    }
+
+    unsigned long droppedMessages() const
+    { return _asyncWriter ? _asyncWriter->dropped() : 0; }
+
     int rootFlags() const
     { return _config.rootFlags(); }
 
@@ -1197,29 +1866,42 @@ public:
     { return _config.logFlags(category); }
 };
 
-LogManager::Impl::Impl(const LogConfiguration& config)
+LogAppender* LogManager::Impl::newAppender(const LogConfiguration& config)
 {
     if (config.impl()->fname().empty())
     {
         if (config.impl()->logport() != 0)
-        {
-            _appender.reset(new UdpAppender(config.impl()->loghost(), config.impl()->logport(), config.impl()->broadcast()));
-        }
+            return new UdpAppender(config.impl()->loghost(), config.impl()->logport(), config.impl()->broadcast());
         else
-        {
-            _appender.reset(new FdAppender(config.impl()->tostdout() ? STDOUT_FILENO : STDERR_FILENO));
-        }
+            return new FdAppender(config.impl()->tostdout() ? STDOUT_FILENO : STDERR_FILENO);
+    }
+    else if (config.impl()->binary())
+    {
+        return new BinaryFileAppender(config.impl()->fname());
     }
     else if (config.impl()->maxfilesize() == 0)
     {
-        _appender.reset(new FileAppender(config.impl()->fname()));
+        return new FileAppender(config.impl()->fname());
     }
     else
     {
-        _appender.reset(new RollingFileAppender(config.impl()->fname(), config.impl()->maxfilesize(), config.impl()->maxbackupindex(), config.impl()->logFormat()));
+        return new RollingFileAppender(config.impl()->fname(), config.impl()->maxfilesize(), config.impl()->maxbackupindex(), config.impl()->logFormat());
     }
+}
 
+LogManager::Impl::Impl(const LogConfiguration& config)
+  : _async(false),
+    _binary(false)
+{
+    _appender.reset(newAppender(config));
+    _binary = isBinary(config);
     _config = config;
+
+    if (config.impl()->async())
+    {
+        _asyncWriter.reset(new AsyncWriter(config.impl()->asyncBufferSize(), config.impl()->overflow(), _appender.get()));
+        _async = true;
+    }
 }
 
 void LogManager::Impl::configure(const LogConfiguration& config)
@@ -1227,26 +1909,30 @@ void LogManager::Impl::configure(const LogConfiguration& config)
     if (config.rootFlags() == 0)
         return;
 
-    if (config.impl()->fname().empty())
+    // The writer is kept, since logging threads may still use it. It
+    // writes the pending messages to the old appender before switching.
+    // When asynchronous logging is switched off, messages go directly to
+    // the appender from now on. Threads, which still hold the writer, may
+    // queue late messages, so both write under the appender lock.
+    if (!config.impl()->async())
+        _async = false;
+
+    std::unique_ptr<LogAppender> appender(newAppender(config));
+    if (_asyncWriter)
+        _asyncWriter->setAppender(appender.get());
+    _appender = std::move(appender);
+    _binary = isBinary(config);
+
+    if (config.impl()->async())
     {
-        if (config.impl()->logport() != 0)
-        {
-            _appender.reset(new UdpAppender(config.impl()->loghost(), config.impl()->logport(), config.impl()->broadcast()));
-        }
+        if (_asyncWriter)
+            _asyncWriter->setOverflowPolicy(config.impl()->overflow());
         else
-        {
-            _appender.reset(new FdAppender(config.impl()->tostdout() ? STDOUT_FILENO : STDERR_FILENO));
-        }
-    }
-    else if (config.impl()->maxfilesize() == 0)
-    {
-        _appender.reset(new FileAppender(config.impl()->fname()));
-    }
-    else
-    {
-        _appender.reset(new RollingFileAppender(config.impl()->fname(), config.impl()->maxfilesize(), config.impl()->maxbackupindex(), config.impl()->logFormat()));
+            _asyncWriter.reset(new AsyncWriter(config.impl()->asyncBufferSize(), config.impl()->overflow(), _appender.get()));
     }
 
+    _async = config.impl()->async();
+
     _config = config;
 
     for (Loggers::iterator it = _loggers.begin(); it != _loggers.end(); ++it)
@@ -1273,8 +1959,14 @@ LogManager::LogManager()
 LogManager::~LogManager()
 {
     std::lock_guard<std::mutex> lock(logMutex);
-    delete _impl;
     _enabled = false;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (managerUsers.load() > 0)
+        std::this_thread::yield();
+
+    delete _impl;
+    _impl = 0;
 }
 
 LogManager& LogManager::getInstance()
@@ -1369,6 +2061,17 @@ int LogManager::rootFlags() const
     return _impl->rootFlags();
 }
 
+void LogManager::flush()
+{
+    if (_impl)
+        _impl->flush();
+}
+
+unsigned long LogManager::droppedMessages() const
+{
+    return _impl ? _impl->droppedMessages() : 0;
+}
+
 int LogManager::logFlags(const std::string& category) const
 {
     return _impl->logFlags(category);
@@ -1396,6 +2099,256 @@ Logger* LogManager::Impl::getLogger(const std::string& category)
     return ret;
 }
 
+namespace
+{
+    bool binaryLogging()
+    {
+        ScopedAtomicIncrementer user(managerUsers);
+        if (!LogManager::isEnabled())
+            return false;
+
+        LogManager::Impl* manager = LogManager::getInstance().impl();
+        return manager != 0 && manager->binary();
+    }
+
+    // Passes a formatted message to the appender or the writer thread.
+    // The content of msg is consumed. Messages formatted before the log
+    // was switched between text and binary are discarded.
+    void appendMessage(std::string& msg, bool flush, bool binary)
+    {
+        {
+            // the manager is not deleted, while we use it
+            ScopedAtomicIncrementer user(managerUsers);
+            if (!LogManager::isEnabled())
+            {
+                msg.clear();
+                return;
+            }
+
+            LogManager::Impl* manager = LogManager::getInstance().impl();
+
+            if (manager->binary() != binary)
+            {
+                msg.clear();
+                return;
+            }
+
+            AsyncWriter* asyncWriter = manager->asyncWriter();
+            if (asyncWriter)
+            {
+                asyncWriter->put(msg, flush);
+                msg.clear();
+                return;
+            }
+        }
+
+        ScopedAtomicIncrementer inc(mutexWaitCount);
+        std::lock_guard<std::mutex> lock(logMutex);
+        if (!LogManager::isEnabled())
+        {
+            msg.clear();
+            return;
+        }
+
+        std::lock_guard<std::mutex> appenderLock(appenderMutex);
+
+        LogAppender& appender = LogManager::getInstance().impl()->appender();
+        appender.putMessage(msg);
+        bool last = inc.decrement() == 0;
+        appender.finish(last || flush);
+        msg.clear();
+    }
+}
+
+namespace
+{
+    // Stream buffer, which writes directly into the string passed to the
+    // appender. The put area spans the unused capacity of the string, so
+    // that a message is formatted without a copy and, once the string has
+    // grown to the usual message size, without allocation.
+    class LogBuffer : public std::streambuf
+    {
+        std::string _str;
+
+        void grow(std::size_t n)
+        {
+            std::size_t start = pbase() - &_str[0];
+            std::size_t used = pptr() - &_str[0];
+            _str.resize(std::max(_str.size() * 2, used + n));
+            setp(&_str[0] + start, &_str[0] + _str.size());
+            pbump(static_cast<int>(used - start));
+        }
+
+    protected:
+        int_type overflow(int_type ch)
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                if (pptr() == epptr())
+                    grow(1);
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n)
+        {
+            if (epptr() - pptr() < n)
+                grow(n);
+            std::memcpy(pptr(), s, n);
+            pbump(static_cast<int>(n));
+            return n;
+        }
+
+    public:
+        // the log entry header is appended here before open() is called
+        std::string& str()
+        { return _str; }
+
+        // starts the message text after the current content
+        void open()
+        {
+            std::size_t n = _str.size();
+            _str.resize(std::max<std::size_t>(_str.capacity(), n + 256));
+            setp(&_str[0] + n, &_str[0] + _str.size());
+        }
+
+        // ends the message text and returns the complete entry
+        std::string& close()
+        {
+            _str.resize(pptr() - &_str[0]);
+            setp(0, 0);
+            return _str;
+        }
+
+        std::string message() const
+        { return std::string(pbase(), pptr()); }
+
+        void clear()
+        {
+            setp(0, 0);
+            _str.clear();
+        }
+    };
+
+    // Number formatting for log messages. The default num_put goes through
+    // printf for floating point values and through the locale for integers.
+    // Default formatted values are written directly here; everything else
+    // like hex output or a field width is left to the base class.
+    class LogNumPut : public std::num_put<char>
+    {
+        bool _plain;
+
+        static bool plainFormat(const std::ios_base& str)
+        {
+            std::ios_base::fmtflags f = str.flags()
+                & (std::ios_base::basefield | std::ios_base::showpos | std::ios_base::showbase
+                 | std::ios_base::uppercase | std::ios_base::showpoint);
+            return f == std::ios_base::fmtflags() || f == std::ios_base::dec;
+        }
+
+        // In binary mode the arguments are collected in the string
+        // registered with pword and a placeholder is written instead.
+        static std::string* binaryArgs(std::ios_base& str)
+        { return static_cast<std::string*>(str.pword(argsIndex())); }
+
+        static iter_type putArg(iter_type out, std::string& args, logbinary::ArgumentType type, const void* value)
+        {
+            args += static_cast<char>(type);
+            args.append(static_cast<const char*>(value), 8);
+            *out = logbinary::placeholder;
+            return ++out;
+        }
+
+        template <typename T>
+        iter_type putInteger(iter_type out, std::ios_base& str, char fill, T v) const
+        {
+            if (!_plain || str.width() != 0 || !plainFormat(str))
+                return std::num_put<char>::do_put(out, str, fill, v);
+
+            std::string* args = binaryArgs(str);
+            if (args)
+            {
+                if (std::is_signed<T>::value)
+                {
+                    int64_t a = static_cast<int64_t>(v);
+                    return putArg(out, *args, logbinary::SignedArg, &a);
+                }
+                else
+                {
+                    uint64_t a = static_cast<uint64_t>(v);
+                    return putArg(out, *args, logbinary::UnsignedArg, &a);
+                }
+            }
+
+            return putInt(out, v);
+        }
+
+    public:
+        static int argsIndex()
+        {
+            static const int index = std::ios_base::xalloc();
+            return index;
+        }
+
+        explicit LogNumPut(const std::locale& loc)
+        {
+            const std::numpunct<char>& np = std::use_facet<std::numpunct<char> >(loc);
+            _plain = np.grouping().empty() && np.decimal_point() == '.';
+        }
+
+    protected:
+        iter_type do_put(iter_type out, std::ios_base& str, char fill, long v) const
+        { return putInteger(out, str, fill, v); }
+
+        iter_type do_put(iter_type out, std::ios_base& str, char fill, unsigned long v) const
+        { return putInteger(out, str, fill, v); }
+
+        iter_type do_put(iter_type out, std::ios_base& str, char fill, long long v) const
+        { return putInteger(out, str, fill, v); }
+
+        iter_type do_put(iter_type out, std::ios_base& str, char fill, unsigned long long v) const
+        { return putInteger(out, str, fill, v); }
+
+        iter_type do_put(iter_type out, std::ios_base& str, char fill, double v) const
+        {
+            if (_plain && str.width() == 0 && plainFormat(str))
+            {
+                std::string* args = binaryArgs(str);
+                if (args)
+                {
+                    // the decoder formats with the default precision
+                    if (str.precision() == 6 && (str.flags() & std::ios_base::floatfield) == std::ios_base::fmtflags())
+                        return putArg(out, *args, logbinary::DoubleArg, &v);
+                }
+#ifdef CXXTOOLS_LOG_TO_CHARS
+                else if (str.precision() >= 0)
+                {
+                    char buffer[128];
+                    std::to_chars_result r;
+                    std::ios_base::fmtflags floatfield = str.flags() & std::ios_base::floatfield;
+                    if (floatfield == std::ios_base::fixed)
+                        r = std::to_chars(buffer, buffer + sizeof(buffer), v, std::chars_format::fixed, str.precision());
+                    else if (floatfield == std::ios_base::scientific)
+                        r = std::to_chars(buffer, buffer + sizeof(buffer), v, std::chars_format::scientific, str.precision());
+                    else if (floatfield == std::ios_base::fmtflags())
+                        r = std::to_chars(buffer, buffer + sizeof(buffer), v, std::chars_format::general, str.precision());
+                    else  // hexfloat
+                        r.ec = std::errc::not_supported;
+
+                    if (r.ec == std::errc())
+                        return std::copy(buffer, r.ptr, out);
+                }
+#endif
+            }
+
+            return std::num_put<char>::do_put(out, str, fill, v);
+        }
+    };
+}
+
 //////////////////////////////////////////////////////////////////////
 // LogMessage
 //
@@ -1403,54 +2356,102 @@ class LogMessage::Impl
 {
     Logger* _logger;
     const char* _level;
-    std::ostringstream _msg;
+    LogBuffer _buffer;
+    std::ostream _out;
     std::ios_base::fmtflags _fmtflags;
-    std::string _buffer;
+    bool _binary;
+    std::string _args;  // raw arguments in binary mode
 
 public:
     Impl()
-      : _fmtflags(_msg.flags())
-    { }
-
-    void setLogger(Logger* logger)
-    { _logger = logger; }
+      : _logger(0),
+        _level(0),
+        _out(&_buffer),
+        _fmtflags(_out.flags()),
+        _binary(false)
+    {
+        std::locale loc = _out.getloc();
+        _out.imbue(std::locale(loc, new LogNumPut(loc)));
+    }
 
-    void setLevel(const char* level)
-    { _level = level; }
+    // formats the header and opens the buffer for the message text
+    void begin(Logger* logger, const char* level);
 
     void finish();
 
-    std::ostringstream& out()
-    { return _msg; }
+    std::ostream& out()
+    { return _out; }
 
-    std::string str()
-    { return _msg.str(); }
+    std::string str() const
+    { return _buffer.message(); }
 
     void clear()
     {
-        _msg.clear();
-        _msg.str(std::string());
-        _msg.flags(_fmtflags);
+        _buffer.clear();
+        _args.clear();
+        _out.clear();
+        _out.flags(_fmtflags);
+        _out.precision(6);
+        _out.width(0);
+        _out.fill(' ');
     }
 };
 
 namespace
 {
-    LPool<LogMessage::Impl> logMessageImplPool;
+    // LogMessage::Impl objects are reused per thread, so that a log
+    // statement needs neither a lock nor an allocation. Nested log
+    // statements (logging while formatting a message) take more than one.
+    // The cache itself is trivially destructible; the cleaner deletes the
+    // cached objects at thread exit and closes the cache, so that log
+    // statements in later thread local or static destructors still work.
+    const unsigned maxCachedImpls = 4;
+    thread_local LogMessage::Impl* cachedImpls[maxCachedImpls];
+    thread_local unsigned cachedImplCount = 0;
+    thread_local bool implCacheClosed = false;
+
+    struct ImplCacheCleaner
+    {
+        ~ImplCacheCleaner()
+        {
+            while (cachedImplCount > 0)
+                delete cachedImpls[--cachedImplCount];
+            implCacheClosed = true;
+        }
+    };
+
+    thread_local ImplCacheCleaner implCacheCleaner;
+
+    LogMessage::Impl* getImpl()
+    {
+        if (cachedImplCount > 0)
+            return cachedImpls[--cachedImplCount];
+        return new LogMessage::Impl();
+    }
+
+    void releaseImpl(LogMessage::Impl* impl)
+    {
+        if (cachedImplCount < maxCachedImpls && !implCacheClosed)
+        {
+            // odr-use constructs the cleaner on first release in this thread
+            (void)&implCacheCleaner;
+            cachedImpls[cachedImplCount++] = impl;
+        }
+        else
+            delete impl;
+    }
 }
 
 LogMessage::LogMessage(Logger* logger, const char* level)
-  : _impl(logMessageImplPool.getInstance())
+  : _impl(getImpl())
 {
-    _impl->setLogger(logger);
-    _impl->setLevel(level);
+    _impl->begin(logger, level);
 }
 
 LogMessage::LogMessage(Logger* logger, Logger::log_level_type level)
-  : _impl(logMessageImplPool.getInstance())
+  : _impl(getImpl())
 {
-    _impl->setLogger(logger);
-    _impl->setLevel(logLevel2Charp(level));
+    _impl->begin(logger, logLevel2Charp(level));
 }
 
 LogMessage::~LogMessage()
@@ -1458,34 +2459,50 @@ LogMessage::~LogMessage()
     if (_impl)
     {
         _impl->finish();
-        logMessageImplPool.releaseInstance(_impl);
+        releaseImpl(_impl);
     }
 }
 
 void LogMessage::finish()
 {
     _impl->finish();
-    logMessageImplPool.releaseInstance(_impl);
+    releaseImpl(_impl);
     _impl = 0;
 }
 
-void LogMessage::Impl::finish()
+void LogMessage::Impl::begin(Logger* logger, const char* level)
 {
+    _logger = logger;
+    _level = level;
+    _binary = binaryLogging();
+    _out.pword(LogNumPut::argsIndex()) = _binary ? &_args : 0;
+
     try
     {
-        if (!LogManager::isEnabled())
-            return;
+        if (_binary)
+            binaryEntry(_buffer.str(), _level, _logger->getCategory());
+        else
+            logentry(_buffer.str(), _level, _logger->getCategory(), _logger->logFormat());
+    }
+    catch (const std::exception&)
+    {
+        _buffer.clear();
+    }
 
-        ScopedAtomicIncrementer inc(mutexWaitCount);
-        std::lock_guard<std::mutex> lock(logMutex);
+    _buffer.open();
+}
 
-        logentry(_buffer, _level, _logger->getCategory(), _logger->logFormat());
-        _buffer += _msg.str();
+void LogMessage::Impl::finish()
+{
+    try
+    {
+        std::string& entry = _buffer.close();
+        if (_binary)
+            binaryEntryEnd(entry, _args);
 
-        LogAppender& appender = LogManager::getInstance().impl()->appender();
-        appender.putMessage(_buffer);
-        appender.finish(inc.decrement() == 0);
-        _buffer.clear();
+        // fatal messages are written before the program may terminate
+        if (LogManager::isEnabled())
+            appendMessage(entry, strcmp(_level, "FATAL") == 0, _binary);
     }
     catch (const std::exception&)
     {
@@ -1581,17 +2598,19 @@ void LogTracer::Impl::putmessage(const char* state) const
         if (!LogManager::isEnabled())
             return;
 
-        ScopedAtomicIncrementer inc(mutexWaitCount);
-        std::lock_guard<std::mutex> lock(logMutex);
+        bool binary = binaryLogging();
 
         std::string msg;
-        logentry(msg, "TRACE", _logger->getCategory(), _logger->logFormat());
+        if (binary)
+            binaryEntry(msg, "TRACE", _logger->getCategory());
+        else
+            logentry(msg, "TRACE", _logger->getCategory(), _logger->logFormat());
         msg += state;
         msg += _msg.str();
+        if (binary)
+            binaryEntryEnd(msg, std::string());
 
-        LogAppender& appender = LogManager::getInstance().impl()->appender();
-        appender.putMessage(msg);
-        appender.finish(inc.decrement() == 0);
+        appendMessage(msg, false, binary);
     }
     catch (const std::exception&)
     {
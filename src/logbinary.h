@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef CXXTOOLS_LOGBINARY_H
+#define CXXTOOLS_LOGBINARY_H
+
+/*
+ Record layout of binary log files, shared by the binary file appender and
+ the cxxlogdecode tool.
+
+ A file is a sequence of records. Each record starts with a type byte and
+ the size of the body as uint32. Numbers are written in the byte order of
+ the writing machine, which is noted in the start record.
+
+   Start     "cxxlog" version(uint8) byteOrder(uint32)
+             Written each time the file is opened; all ids defined before
+             are invalid after it.
+
+   Level     id(uint32) text
+   Category  id(uint32) text
+   Format    id(uint32) text
+             Defines the text for an id before the first message uses it.
+             In a format text each placeholder byte stands for an argument.
+
+   Message   level(uint32) category(uint32) format(uint32)
+             time(int64, microseconds since the epoch) pid(uint32) thread(uint64)
+             arguments
+             An id of 0 means, that the text is not in the dictionary and
+             follows inline as size(uint32) text, after the 3 ids in the
+             same order. Arguments are a type byte followed by 8 bytes
+             until the end of the body.
+ */
+
+namespace cxxtools
+{
+namespace logbinary
+{
+    static const char magic[6] = { 'c', 'x', 'x', 'l', 'o', 'g' };
+    static const unsigned char version = 1;
+    static const unsigned byteOrder = 0x01020304;
+
+    enum RecordType
+    {
+        StartRecord = 'S',
+        LevelRecord = 'L',
+        CategoryRecord = 'C',
+        FormatRecord = 'F',
+        MessageRecord = 'M'
+    };
+
+    enum ArgumentType
+    {
+        SignedArg = 'i',     // int64
+        UnsignedArg = 'u',   // uint64
+        DoubleArg = 'd'      // double, formatted with default precision
+    };
+
+    static const char placeholder = '\0';
+}
+}
+
+#endif // CXXTOOLS_LOGBINARY_H
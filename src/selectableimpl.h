@@ -37,10 +37,17 @@ namespace cxxtools
 {
 
 class Timespan;
+class SelectorImpl;
 
 class SelectableImpl
 {
+    friend class SelectorImpl;
+
 public:
+    SelectableImpl()
+    : _selector(0)
+    { }
+
     virtual ~SelectableImpl() = default;
 
     virtual void close() = 0;
@@ -52,6 +59,19 @@ public:
     virtual std::size_t initializePoll(pollfd* pfd, std::size_t pollSize) = 0;
 
     virtual bool checkPollEvent() = 0;
+
+protected:
+    /** @brief Tells the selector, that the events in the pollfds changed
+
+        Must be called after modifying the events of the pollfds passed
+        to initializePoll. The epoll backend of the selector does not scan
+        all pollfds on each wait and needs to update its registration.
+     */
+    void pollChanged();
+
+private:
+    // set by the selector when it needs to be notified about changes
+    SelectorImpl* _selector;
 };
 
 } //namespace cxxtools
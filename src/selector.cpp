@@ -39,7 +39,7 @@ SelectorBase::~SelectorBase()
 {
     while( _timers.size() )
     {
-       Timer* timer = _timers.begin()->second;
+       Timer* timer = _timers.back();
        timer->setSelector(0);
     }
 }
@@ -74,25 +74,17 @@ void SelectorBase::remove( Timer& timer )
 void SelectorBase::onAddTimer(Timer& timer)
 {
     if( timer.active() )
-    {
-        TimerMap::value_type elem(timer.finished(), &timer);
-        _timers.insert(elem);
-        //_timers.insert( std::make_pair(timer.finished(), &timer) );
-    }
+        pushTimer(timer);
 }
 
 
 void SelectorBase::onRemoveTimer( Timer& timer )
 {
-    std::multimap<Timespan, Timer*>::iterator it;
-    for(it = _timers.begin(); it != _timers.end(); ++it)
-    {
-        if(it->second == &timer)
-        {
-            _timers.erase(it);
-            return;
-        }
-    }
+    if (&timer == _updating)
+        _updating = 0;
+
+    if (timer._heapIndex != noTimerIndex)
+        eraseTimer(timer._heapIndex);
 }
 
 
@@ -100,9 +92,15 @@ void SelectorBase::onTimerChanged(Timer& timer)
 {
     if( timer.active() )
     {
-        TimerMap::value_type elem(timer.finished(), &timer);
-        _timers.insert(elem);
-        //_timers.insert( std::make_pair(timer.finished(), &timer) );
+        if (timer._heapIndex == noTimerIndex)
+        {
+            pushTimer(timer);
+        }
+        else
+        {
+            siftUpTimer(timer._heapIndex);
+            siftDownTimer(timer._heapIndex);
+        }
     }
     else
     {
@@ -111,18 +109,89 @@ void SelectorBase::onTimerChanged(Timer& timer)
 }
 
 
+void SelectorBase::pushTimer(Timer& timer)
+{
+    timer._heapIndex = _timers.size();
+    _timers.push_back(&timer);
+    siftUpTimer(timer._heapIndex);
+}
+
+
+void SelectorBase::eraseTimer(std::size_t idx)
+{
+    Timer* timer = _timers[idx];
+    timer->_heapIndex = noTimerIndex;
+
+    Timer* last = _timers.back();
+    _timers.pop_back();
+
+    if (last != timer)
+    {
+        _timers[idx] = last;
+        last->_heapIndex = idx;
+        siftUpTimer(idx);
+        siftDownTimer(last->_heapIndex);
+    }
+}
+
+
+void SelectorBase::siftUpTimer(std::size_t idx)
+{
+    Timer* timer = _timers[idx];
+    while (idx > 0)
+    {
+        std::size_t parent = (idx - 1) / 2;
+        if (!(timer->finished() < _timers[parent]->finished()))
+            break;
+
+        _timers[idx] = _timers[parent];
+        _timers[idx]->_heapIndex = idx;
+        idx = parent;
+    }
+
+    _timers[idx] = timer;
+    timer->_heapIndex = idx;
+}
+
+
+void SelectorBase::siftDownTimer(std::size_t idx)
+{
+    Timer* timer = _timers[idx];
+    std::size_t size = _timers.size();
+    while (true)
+    {
+        std::size_t child = 2 * idx + 1;
+        if (child >= size)
+            break;
+
+        if (child + 1 < size && _timers[child + 1]->finished() < _timers[child]->finished())
+            ++child;
+
+        if (!(_timers[child]->finished() < timer->finished()))
+            break;
+
+        _timers[idx] = _timers[child];
+        _timers[idx]->_heapIndex = idx;
+        idx = child;
+    }
+
+    _timers[idx] = timer;
+    timer->_heapIndex = idx;
+}
+
+
 bool SelectorBase::updateTimer(Timespan& lowestTimeout)
 {
     if( _timers.empty() )
         return false;
 
     Timespan now = Timespan::gettimeofday();
-    Timer* timer = _timers.begin()->second;
+    Timer* timer = _timers.front();
     bool timerActive = now >= timer->finished();
 
     while( ! _timers.empty() )
     {
-        timer = _timers.begin()->second;
+        timer = _timers.front();
 
         if ( now < timer->finished() )
         {
@@ -131,16 +200,26 @@ bool SelectorBase::updateTimer(Timespan& lowestTimeout)
             break;
         }
 
-        timer->update(now);
+        // The timer is taken out of the heap while its expiry time changes.
+        // The callbacks may stop, restart or destroy it.
+        eraseTimer(0);
+        _updating = timer;
 
-        if( ! _timers.empty() )
+        try
         {
-            timer = _timers.begin()->second;
-            _timers.erase( _timers.begin() );
-            TimerMap::value_type elem(timer->finished(), timer);
-            _timers.insert(elem);
-            //_timers.insert( std::make_pair(timer->finished(), timer) );
+            timer->update(now);
         }
+        catch (...)
+        {
+            if (_updating && _updating->active() && _updating->_heapIndex == noTimerIndex)
+                pushTimer(*_updating);
+            _updating = 0;
+            throw;
+        }
+
+        if (_updating && _updating->active() && _updating->_heapIndex == noTimerIndex)
+            pushTimer(*_updating);
+        _updating = 0;
     }
 
     return timerActive;
@@ -218,13 +297,14 @@ void SelectorBase::wake()
 
 
 SelectorBase::SelectorBase()
+: _updating(0)
 {}
 
 
-Selector::Selector()
+Selector::Selector(Backend backend)
 : _impl( 0 )
 {
-    _impl = new SelectorImpl();
+    _impl = new SelectorImpl(backend);
 }
 
 
@@ -269,6 +349,12 @@ void Selector::onWake()
 }
 
 
+SelectorBase::Backend Selector::backend() const
+{
+    return _impl->backend();
+}
+
+
 SelectorImpl& Selector::impl()
 {
     return *_impl;
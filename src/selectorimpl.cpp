@@ -33,6 +33,9 @@
 #include "cxxtools/selector.h"
 #include "cxxtools/log.h"
 #include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <unistd.h>
 #include <fcntl.h>
 #include <cassert>
@@ -41,15 +44,83 @@
 #include "config.h"
 #include "poll.h"
 
+#if defined(HAVE_EPOLL_CREATE1) && defined(HAVE_SYS_EPOLL_H)
+#define CXXTOOLS_USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 log_define("cxxtools.selector.impl")
 
 namespace cxxtools
 {
 
+void SelectableImpl::pollChanged()
+{
+    if (_selector)
+        _selector->pollChanged(*this);
+}
+
 const short SelectorImpl::POLL_ERROR_MASK= POLLERR | POLLHUP | POLLNVAL;
 
-SelectorImpl::SelectorImpl()
-: _isDirty(true)
+namespace
+{
+#ifdef CXXTOOLS_USE_EPOLL
+    // event data of the wake pipe; slot indexes are 32 bit
+    const uint64_t wakeEvent = std::numeric_limits<uint64_t>::max();
+
+    uint32_t toEpoll(short events)
+    {
+        uint32_t ret = 0;
+        if (events & POLLIN)
+            ret |= EPOLLIN;
+        if (events & POLLPRI)
+            ret |= EPOLLPRI;
+        if (events & POLLOUT)
+            ret |= EPOLLOUT;
+        return ret;
+    }
+
+    short fromEpoll(uint32_t events)
+    {
+        short ret = 0;
+        if (events & EPOLLIN)
+            ret |= POLLIN;
+        if (events & EPOLLPRI)
+            ret |= POLLPRI;
+        if (events & EPOLLOUT)
+            ret |= POLLOUT;
+        if (events & EPOLLERR)
+            ret |= POLLERR;
+        if (events & EPOLLHUP)
+            ret |= POLLHUP;
+        return ret;
+    }
+
+    int pollTimeoutMs(Timespan until)
+    {
+        if (until < Timespan(0))
+            return -1;
+
+        if (until == Timespan(0))
+            return 0;
+
+        Timespan remaining = until - Timespan::gettimeofday();
+        if (remaining < Timespan(0))
+            return 0;
+
+        if (Milliseconds(remaining) >= std::numeric_limits<int>::max())
+            return std::numeric_limits<int>::max();
+
+        return Milliseconds(remaining).ceil();
+    }
+#endif
+
+}
+
+SelectorImpl::SelectorImpl(SelectorBase::Backend backend)
+: _isDirty(true),
+  _epfd(-1),
+  _havePwait2(true)
 {
     _current = _devices.end();
 
@@ -73,6 +144,17 @@ SelectorImpl::SelectorImpl()
     if(-1 == ret)
         throwSystemError("fcntl");
 
+    if (backend == SelectorBase::DefaultBackend)
+    {
+        const char* env = ::getenv("CXXTOOLS_SELECTOR");
+        if (env && std::strcmp(env, "poll") == 0)
+            backend = SelectorBase::PollBackend;
+        else
+            backend = SelectorBase::EpollBackend;
+    }
+
+    if (backend == SelectorBase::EpollBackend)
+        initEpoll();
 }
 
 
@@ -85,6 +167,14 @@ SelectorImpl::~SelectorImpl()
         (*it)->setSelector(0);
     }
 
+    while( _entries.size() )
+    {
+        _entries.begin()->second->dev->setSelector(0);
+    }
+
+    if (_epfd >= 0)
+        ::close(_epfd);
+
     if( _wakePipe[0] != -1 && _wakePipe[1] != -1 )
     {
         ::close(_wakePipe[0]);
@@ -93,15 +183,91 @@ SelectorImpl::~SelectorImpl()
 }
 
 
+void SelectorImpl::initEpoll()
+{
+#ifdef CXXTOOLS_USE_EPOLL
+    _epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epfd < 0)
+    {
+        log_warn("epoll_create1 failed with errno " << errno << "; using poll");
+        return;
+    }
+
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = wakeEvent;
+    if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, _wakePipe[0], &ev) != 0)
+    {
+        log_warn("epoll_ctl failed with errno " << errno << "; using poll");
+        ::close(_epfd);
+        _epfd = -1;
+    }
+#else
+    log_debug("epoll not available; using poll");
+#endif
+}
+
+
 void SelectorImpl::add(Selectable& dev)
 {
-    _devices.insert(&dev);
-    _isDirty = true;
+    if (_epfd < 0)
+    {
+        _devices.insert(&dev);
+        _isDirty = true;
+        return;
+    }
+
+    // the pollfds are initialized lazily before the next wait like in the
+    // poll backend since the device may not be fully set up yet
+    SelectableImpl* simpl = &dev.simpl();
+    std::unique_ptr<Entry>& entry = _entries[simpl];
+    if (entry)
+        return;
+
+    entry.reset(new Entry());
+    entry->dev = &dev;
+    entry->simpl = simpl;
+    entry->initialized = false;
+    entry->changed = true;
+    entry->ready = false;
+    simpl->_selector = this;
+    _changed.push_back(entry.get());
 }
 
 
 void SelectorImpl::remove(Selectable& dev)
 {
+    _avail.erase(&dev);
+
+    if (_epfd >= 0)
+    {
+        auto it = _entries.find(&dev.simpl());
+        if (it == _entries.end())
+            return;
+
+        // The entry may still be referenced in the lists of changed or ready
+        // entries, so it is just marked as removed and released later.
+        Entry& entry = *it->second;
+        for (unsigned idx: entry.slots)
+        {
+            Slot& slot = _slots[idx];
+#ifdef CXXTOOLS_USE_EPOLL
+            if (slot.fd >= 0 && !slot.always)
+                ::epoll_ctl(_epfd, EPOLL_CTL_DEL, slot.fd, 0);
+#endif
+            slot.entry = 0;
+            slot.fd = -1;
+            _freeSlots.push_back(idx);
+        }
+
+        entry.slots.clear();
+        entry.dev = 0;
+        entry.simpl->_selector = 0;
+        _removed.push_back(std::move(it->second));
+        _entries.erase(it);
+        return;
+    }
+
    std::set<Selectable*>::iterator it = _devices.find( &dev );
    if( it == _devices.end() )
         return;
@@ -136,11 +302,137 @@ void SelectorImpl::changed( Selectable& s )
 }
 
 
+void SelectorImpl::pollChanged( SelectableImpl& simpl )
+{
+    auto it = _entries.find(&simpl);
+    if (it == _entries.end())
+        return;
+
+    Entry* entry = it->second.get();
+    if (!entry->changed)
+    {
+        entry->changed = true;
+        _changed.push_back(entry);
+    }
+}
+
+
+void SelectorImpl::syncEntry(Entry& entry)
+{
+    if (!entry.initialized)
+    {
+        pollfd pfd;
+        pfd.fd = -1;
+        pfd.events = 0;
+        pfd.revents = 0;
+
+        entry.pollfds.assign(entry.simpl->pollSize(), pfd);
+        if (entry.pollfds.empty())
+            return;
+
+        entry.simpl->initializePoll(&entry.pollfds[0], entry.pollfds.size());
+
+        for (unsigned pos = 0; pos < entry.pollfds.size(); ++pos)
+        {
+            Slot slot;
+            slot.entry = &entry;
+            slot.pos = pos;
+            slot.fd = -1;
+            slot.events = 0;
+            slot.always = false;
+
+            if (_freeSlots.empty())
+            {
+                entry.slots.push_back(_slots.size());
+                _slots.push_back(slot);
+            }
+            else
+            {
+                entry.slots.push_back(_freeSlots.back());
+                _slots[_freeSlots.back()] = slot;
+                _freeSlots.pop_back();
+            }
+        }
+
+        entry.initialized = true;
+    }
+
+    for (unsigned pos = 0; pos < entry.pollfds.size(); ++pos)
+        syncSlot(entry.slots[pos], entry.pollfds[pos]);
+}
+
+
+void SelectorImpl::syncSlot(unsigned idx, const pollfd& pfd)
+{
+#ifdef CXXTOOLS_USE_EPOLL
+    Slot& slot = _slots[idx];
+    if (slot.fd == pfd.fd && slot.events == pfd.events)
+        return;
+
+    if (slot.fd >= 0 && slot.fd != pfd.fd)
+    {
+        // the fd is removed automatically from epoll when it was closed
+        if (!slot.always)
+            ::epoll_ctl(_epfd, EPOLL_CTL_DEL, slot.fd, 0);
+        slot.fd = -1;
+        slot.always = false;
+    }
+
+    slot.events = pfd.events;
+    if (pfd.fd < 0 || slot.always)
+    {
+        slot.fd = pfd.fd;
+        return;
+    }
+
+    epoll_event ev;
+    ev.events = toEpoll(pfd.events);
+    ev.data.u64 = static_cast<uint64_t>(pfd.fd) << 32 | idx;
+
+    log_debug("epoll_ctl fd=" << pfd.fd << " events=" << pfd.events);
+
+    int ret;
+    if (slot.fd < 0)
+    {
+        ret = ::epoll_ctl(_epfd, EPOLL_CTL_ADD, pfd.fd, &ev);
+        if (ret != 0 && errno == EEXIST)
+            ret = ::epoll_ctl(_epfd, EPOLL_CTL_MOD, pfd.fd, &ev);
+    }
+    else
+    {
+        ret = ::epoll_ctl(_epfd, EPOLL_CTL_MOD, pfd.fd, &ev);
+        if (ret != 0 && errno == ENOENT)
+            ret = ::epoll_ctl(_epfd, EPOLL_CTL_ADD, pfd.fd, &ev);
+    }
+
+    if (ret != 0)
+    {
+        if (errno != EPERM)
+            throwSystemError("epoll_ctl");
+
+        // regular files are not supported by epoll but poll reports them
+        // always as ready
+        log_debug("fd " << pfd.fd << " not supported by epoll");
+        slot.always = true;
+        _alwaysReady.push_back(idx);
+    }
+
+    slot.fd = pfd.fd;
+#endif
+}
+
+
 bool SelectorImpl::waitUntil(Timespan until)
 {
     if (!_avail.empty())
         until = Timespan(0);
 
+    return _epfd >= 0 ? epollWait(until) : pollWait(until);
+}
+
+
+bool SelectorImpl::pollWait(Timespan until)
+{
     if (_isDirty)
     {
         _pollfds.clear();
@@ -249,27 +541,8 @@ bool SelectorImpl::waitUntil(Timespan until)
                 throw IOError("poll error on event pipe");
             }
 
-            static char buffer[1024];
-            while(true)
-            {
-                int ret = ::read(_wakePipe[0], buffer, sizeof(buffer));
-                if(ret > 0)
-                {
-                    avail = true;
-                    continue;
-                }
-
-                if (ret == -1)
-                {
-                    if(errno == EINTR)
-                        continue;
-
-                    if(errno == EAGAIN)
-                        break;
-                }
-
-                throw IOError("Could not read from pipe");
-            }
+            if (readWakePipe())
+                avail = true;
         }
 
         for( _current = _devices.begin(); _current != _devices.end(); )
@@ -300,6 +573,225 @@ bool SelectorImpl::waitUntil(Timespan until)
 }
 
 
+bool SelectorImpl::epollWait(Timespan until)
+{
+#ifdef CXXTOOLS_USE_EPOLL
+    for (std::vector<Entry*>::size_type n = 0; n < _changed.size(); ++n)
+    {
+        Entry* entry = _changed[n];
+        if (entry->dev)
+        {
+            entry->changed = false;
+            syncEntry(*entry);
+        }
+    }
+
+    _changed.clear();
+    _removed.clear();
+
+    for (unsigned idx: _alwaysReady)
+    {
+        if (_slots[idx].events & (POLLIN|POLLOUT))
+            until = Timespan(0);
+    }
+
+    // Collect the devices with available data before calling any callback,
+    // which may destroy them.
+    for (Selectable* dev: _avail)
+    {
+        auto it = _entries.find(&dev->simpl());
+        if (it != _entries.end() && it->second->initialized)
+        {
+            it->second->ready = true;
+            _ready.push_back(it->second.get());
+        }
+    }
+
+    static const int maxEvents = 256;
+    epoll_event events[maxEvents];
+
+    int ret = -1;
+    while (true)
+    {
+#ifdef HAVE_EPOLL_PWAIT2
+        if (_havePwait2)
+        {
+            struct timespec pollTimeout = { 0, 0 };
+            struct timespec* pollTimeoutP = 0;
+            if (until > Timespan(0))
+            {
+                Timespan remaining = until - Timespan::gettimeofday();
+                if (remaining < Timespan(0))
+                    remaining = Timespan(0);
+
+                pollTimeout.tv_sec = remaining.totalUSecs() / 1000000;
+                pollTimeout.tv_nsec = (remaining.totalUSecs() % 1000000) * 1000;
+                pollTimeoutP = &pollTimeout;
+            }
+            else if (until == Timespan(0))
+                pollTimeoutP = &pollTimeout;
+
+            log_debug("epoll_pwait2 with " << _slots.size() - _freeSlots.size() << " fds, timeout=" << pollTimeout.tv_sec << "s " << pollTimeout.tv_nsec << "ns");
+            ret = ::epoll_pwait2(_epfd, events, maxEvents, pollTimeoutP, 0);
+            log_debug("epoll_pwait2 returns " << ret);
+            if (ret == -1 && errno == ENOSYS)
+            {
+                log_debug("epoll_pwait2 not supported by the kernel");
+                _havePwait2 = false;
+                continue;
+            }
+        }
+        else
+#endif
+        {
+            int pollTimeout = pollTimeoutMs(until);
+            log_debug("epoll_wait with " << _slots.size() - _freeSlots.size() << " fds, timeout=" << pollTimeout << "ms");
+            ret = ::epoll_wait(_epfd, events, maxEvents, pollTimeout);
+            log_debug("epoll_wait returns " << ret);
+        }
+
+        if( ret != -1 )
+            break;
+
+        if( errno != EINTR )
+        {
+            for (Entry* entry: _ready)
+                entry->ready = false;
+            _ready.clear();
+            throw IOError("Could not poll on file descriptors");
+        }
+    }
+
+    bool avail = false;
+    try
+    {
+        for (int n = 0; n < ret; ++n)
+        {
+            if (events[n].data.u64 == wakeEvent)
+            {
+                if (events[n].events & (EPOLLERR|EPOLLHUP))
+                    throw IOError("poll error on event pipe");
+
+                if (readWakePipe())
+                    avail = true;
+
+                continue;
+            }
+
+            Slot& slot = _slots[events[n].data.u64 & 0xffffffff];
+            int fd = static_cast<int>(events[n].data.u64 >> 32);
+            if (slot.entry == 0 || slot.fd != fd)
+                continue;
+
+            Entry* entry = slot.entry;
+            entry->pollfds[slot.pos].revents = fromEpoll(events[n].events);
+            if (!entry->ready)
+            {
+                entry->ready = true;
+                _ready.push_back(entry);
+            }
+        }
+
+        for (unsigned idx: _alwaysReady)
+        {
+            Slot& slot = _slots[idx];
+            if (slot.entry == 0 || !slot.always)
+                continue;
+
+            Entry* entry = slot.entry;
+            entry->pollfds[slot.pos].revents = slot.events & (POLLIN|POLLOUT);
+            if (!entry->ready)
+            {
+                entry->ready = true;
+                _ready.push_back(entry);
+            }
+        }
+
+        for (std::vector<Entry*>::size_type n = 0; n < _ready.size(); ++n)
+        {
+            Entry* entry = _ready[n];
+            if (entry->dev == 0)
+                continue;
+
+            if ( entry->dev->enabled() && entry->simpl->checkPollEvent() )
+            {
+                avail = true;
+            }
+
+            // the device is removed when it was closed in the callback
+            if (entry->dev)
+            {
+                entry->ready = false;
+                for (pollfd& pfd: entry->pollfds)
+                    pfd.revents = 0;
+                syncEntry(*entry);
+            }
+        }
+    }
+    catch (...)
+    {
+        for (Entry* entry: _ready)
+        {
+            entry->ready = false;
+            for (pollfd& pfd: entry->pollfds)
+                pfd.revents = 0;
+        }
+
+        _ready.clear();
+        throw;
+    }
+
+    _ready.clear();
+
+    if (!_alwaysReady.empty())
+    {
+        std::vector<unsigned>::iterator it = _alwaysReady.begin();
+        while (it != _alwaysReady.end())
+        {
+            if (_slots[*it].entry == 0 || !_slots[*it].always)
+                it = _alwaysReady.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    return avail;
+#else
+    return false;
+#endif
+}
+
+
+bool SelectorImpl::readWakePipe()
+{
+    bool avail = false;
+
+    static char buffer[1024];
+    while(true)
+    {
+        int ret = ::read(_wakePipe[0], buffer, sizeof(buffer));
+        if(ret > 0)
+        {
+            avail = true;
+            continue;
+        }
+
+        if (ret == -1)
+        {
+            if(errno == EINTR)
+                continue;
+
+            if(errno == EAGAIN)
+                break;
+        }
+
+        throw IOError("Could not read from pipe");
+    }
+
+    return avail;
+}
+
+
 void SelectorImpl::wake()
 {
     ::write( _wakePipe[1], "W", 1);
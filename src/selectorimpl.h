@@ -30,32 +30,73 @@
 #define CXXTOOLS_SYSTEM_POSIX_SELECTORIMPL_H
 
 #include <cxxtools/selectable.h>
+#include <cxxtools/selector.h>
 #include <cxxtools/timespan.h>
 #include <cxxtools/clock.h>
 #include <sys/poll.h>
 #include <vector>
 #include <set>
+#include <unordered_map>
+#include <memory>
 
 namespace cxxtools {
 
+class SelectableImpl;
+
 class SelectorImpl
 {
     public:
-        SelectorImpl();
+        explicit SelectorImpl(SelectorBase::Backend backend = SelectorBase::DefaultBackend);
 
         ~SelectorImpl();
 
+        SelectorBase::Backend backend() const
+        { return _epfd >= 0 ? SelectorBase::EpollBackend : SelectorBase::PollBackend; }
+
         void add( Selectable& dev );
 
         void remove( Selectable& dev );
 
         void changed( Selectable& dev );
 
+        void pollChanged( SelectableImpl& simpl );
+
         bool waitUntil(Timespan timeout);
 
         void wake();
 
     private:
+        // A device registered in the epoll backend. The pollfds are passed
+        // to the device and must not move while the device is registered.
+        struct Entry
+        {
+            Selectable* dev;
+            SelectableImpl* simpl;
+            std::vector<pollfd> pollfds;
+            std::vector<unsigned> slots;
+            bool initialized;
+            bool changed;
+            bool ready;
+        };
+
+        // A file descriptor registered in epoll. The index of the slot and
+        // the fd are passed as event data, so that stale events are detected.
+        struct Slot
+        {
+            Entry* entry;
+            unsigned pos;
+            int fd;
+            short events;
+            bool always;    // fd not supported by epoll; always ready
+        };
+
+        void initEpoll();
+        void syncEntry(Entry& entry);
+        void syncSlot(unsigned idx, const pollfd& pfd);
+        bool pollWait(Timespan until);
+        bool epollWait(Timespan until);
+        bool readWakePipe();
+
         static const short POLL_ERROR_MASK;
         int _wakePipe[2];
         bool _isDirty;
@@ -63,6 +104,16 @@ class SelectorImpl
         std::set<Selectable*>::iterator _current;
         std::set<Selectable*> _devices;
         std::set<Selectable*> _avail;
+
+        int _epfd;
+        std::unordered_map<SelectableImpl*, std::unique_ptr<Entry>> _entries;
+        std::vector<std::unique_ptr<Entry>> _removed;
+        std::vector<Slot> _slots;
+        std::vector<unsigned> _freeSlots;
+        std::vector<unsigned> _alwaysReady;
+        std::vector<Entry*> _changed;
+        std::vector<Entry*> _ready;
+        bool _havePwait2;
 };
 
 }//namespace xpr
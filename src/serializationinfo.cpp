@@ -34,19 +34,117 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <unordered_set>
+#include <mutex>
 
 log_define("cxxtools.serializationinfo")
 
 namespace cxxtools
 {
 
+namespace
+{
+    // Objects with more members get a name index. Below that a linear
+    // search is faster than hashing the name.
+    const unsigned memberIndexThreshold = 16;
+
+    // Limits of the symbol table for names and type names.
+    const std::size_t maxSymbols = 16384;
+    const std::string::size_type maxSymbolLength = 64;
+
+    typedef std::unordered_set<std::string> Symbols;
+    typedef std::unordered_map<std::string, const std::string*> SymbolCache;
+
+    std::mutex& symbolMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    // The symbol table is never destroyed since static SerializationInfo
+    // objects may refer to it.
+    Symbols& symbols()
+    {
+        static Symbols* symbols = new Symbols();
+        return *symbols;
+    }
+
+    // Symbols already seen by the current thread; accessed without locking.
+    SymbolCache& symbolCache()
+    {
+        static thread_local SymbolCache cache;
+        return cache;
+    }
+
+    const std::string* intern(const std::string& s)
+    {
+        SymbolCache& cache = symbolCache();
+        SymbolCache::const_iterator it = cache.find(s);
+        if (it != cache.end())
+            return it->second;
+
+        if (s.size() > maxSymbolLength)
+            return 0;
+
+        const std::string* sym;
+
+        {
+            std::lock_guard<std::mutex> lock(symbolMutex());
+            Symbols& sy = symbols();
+            Symbols::const_iterator sit = sy.find(s);
+            if (sit != sy.end())
+                sym = &*sit;
+            else if (sy.size() >= maxSymbols)
+                return 0;
+            else
+                sym = &*sy.insert(s).first;
+        }
+
+        cache.emplace(s, sym);
+        return sym;
+    }
+}
+
+const std::string SerializationInfo::Symbol::_empty;
+
+SerializationInfo::Symbol::Symbol(const Symbol& s)
+    : _p(s._p)
+{
+    if (s.owned())
+        _p = reinterpret_cast<std::uintptr_t>(new std::string(*s.ptr())) | 1;
+}
+
+void SerializationInfo::Symbol::assign(const std::string& s)
+{
+    clear();
+
+    if (s.empty())
+        return;
+
+    const std::string* sym = intern(s);
+    if (sym)
+        _p = reinterpret_cast<std::uintptr_t>(sym);
+    else
+        _p = reinterpret_cast<std::uintptr_t>(new std::string(s)) | 1;
+}
+
+const std::string* SerializationInfo::Symbol::lookup(const std::string& s)
+{
+    SymbolCache& cache = symbolCache();
+    SymbolCache::const_iterator it = cache.find(s);
+    return it == cache.end() ? 0 : it->second;
+}
+
 SerializationInfo::SerializationInfo(const SerializationInfo& si)
-: _category(si._category),
-  _name(si._name),
+: _name(si._name),
   _type(si._type),
   _u(si._u),
   _t(si._t),
-  _nodes(0)
+  _category(si._category),
+  _nodes(0),
+  _index(0),
+  _memberOf(0),
+  _arena(0)
 {
     switch (_t)
     {
@@ -61,7 +159,10 @@ SerializationInfo::SerializationInfo(const SerializationInfo& si)
     }
 
     if (si._nodes)
+    {
         _nodes = new Nodes(*si._nodes);
+        _updateIndex();
+    }
 }
 
 
@@ -71,19 +172,26 @@ SerializationInfo& SerializationInfo::operator=(const SerializationInfo& si)
         return *this;
 
     assignData(si);
-    _name = si._name;
+    if (_name.str() != si._name.str())
+    {
+        _name = si._name;
+        _nameChanged();
+    }
 
     return *this;
 }
 
 
 SerializationInfo::SerializationInfo(SerializationInfo&& si) noexcept
-    : _category(si._category),
-      _name(std::move(si._name)),
+    : _name(std::move(si._name)),
       _type(std::move(si._type)),
       _u(si._u),
       _t(si._t),
-      _nodes(si._nodes)
+      _category(si._category),
+      _nodes(si._nodes),
+      _index(si._index),
+      _memberOf(0),
+      _arena(si._arena)
 {
     if (si._t == t_string)
     {
@@ -95,17 +203,26 @@ SerializationInfo::SerializationInfo(SerializationInfo&& si) noexcept
     }
 
     si._nodes = 0;
+    si._index = 0;
 }
 
 
 SerializationInfo& SerializationInfo::operator=(SerializationInfo&& si)
 {
     _category = si._category;
-    _name = std::move(si._name);
+    if (_name.str() != si._name.str())
+    {
+        _name = std::move(si._name);
+        _nameChanged();
+    }
     _type = std::move(si._type);
-    delete _nodes;
+    _deleteNodes();
     _nodes = si._nodes;
     si._nodes = 0;
+    _arena = si._arena;
+    delete _index;
+    _index = si._index;
+    si._index = 0;
 
     if (si._t == t_string)
     {
@@ -143,7 +260,8 @@ SerializationInfo& SerializationInfo::operator=(SerializationInfo&& si)
 SerializationInfo::~SerializationInfo()
 {
     _releaseValue();
-    delete _nodes;
+    _deleteNodes();
+    delete _index;
 }
 
 SerializationInfo& SerializationInfo::addMember(const std::string& name)
@@ -151,8 +269,9 @@ SerializationInfo& SerializationInfo::addMember(const std::string& name)
     log_debug("addMember(\"" << name << "\")");
 
     Nodes& n = nodes();
-    n.push_back(SerializationInfo());
+    n.emplace_back(_arena);
     n.back().setName(name);
+    _updateIndex();
 
     // category Array overrides Object
     // This is needed for xmldeserialization. In the xml file the root node of a array
@@ -170,11 +289,11 @@ const SerializationInfo& SerializationInfo::getMember(const std::string& name) c
 {
     log_debug("getMember(\"" << name << "\")");
 
-    for (const auto& n: nodes())
-        if (n.name() == name)
-            return n;
+    const SerializationInfo* si = _findMember(name);
+    if (si == 0)
+        throw SerializationMemberNotFound(*this, name);
 
-    throw SerializationMemberNotFound(*this, name);
+    return *si;
 }
 
 
@@ -182,12 +301,11 @@ SerializationInfo& SerializationInfo::getMember(const std::string& name)
 {
     log_debug("getMember(\"" << name << "\")");
 
-    if (_nodes)
-        for (auto& n: *_nodes)
-            if (n.name() == name)
-                return n;
+    SerializationInfo* si = const_cast<SerializationInfo*>(_findMember(name));
+    if (si == 0)
+        throw SerializationMemberNotFound(*this, name);
 
-    throw SerializationMemberNotFound(*this, name);
+    return *si;
 }
 
 
@@ -262,15 +380,7 @@ const SerializationInfo* SerializationInfo::findMember(const std::string& name)
 {
     log_debug("findMember(\"" << name << "\")");
 
-    const Nodes& n = nodes();
-
-    for (Nodes::const_iterator it = n.begin(); it != n.end(); ++it)
-    {
-        if( it->name() == name )
-            return &(*it);
-    }
-
-    return 0;
+    return _findMember(name);
 }
 
 size_t SerializationInfo::memberCount(const std::string& name) const
@@ -288,24 +398,113 @@ SerializationInfo* SerializationInfo::findMember(const std::string& name)
 {
     log_debug("findMember(\"" << name << "\")");
 
-    Nodes& n = nodes();
+    return const_cast<SerializationInfo*>(_findMember(name));
+}
+
+const SerializationInfo* SerializationInfo::_findMember(const std::string& name) const
+{
+    if (_index)
+    {
+        std::unordered_map<std::string, unsigned>::const_iterator it = _index->positions.find(name);
+        if (it != _index->positions.end())
+            return &(*_nodes)[it->second];
+
+        // the last member is not indexed
+        const SerializationInfo& last = _nodes->back();
+        return last._name.str() == name ? &last : 0;
+    }
+
+    const Nodes& n = nodes();
 
-    for (Nodes::iterator it = n.begin(); it != n.end(); ++it)
+    // When the name is a known symbol, all members with that name refer to
+    // it and we can compare pointers.
+    const std::string* sym = name.empty() ? 0 : Symbol::lookup(name);
+    if (sym)
+    {
+        for (Nodes::const_iterator it = n.begin(); it != n.end(); ++it)
+        {
+            if (it->_name.is(sym))
+                return &(*it);
+        }
+
+        return 0;
+    }
+
+    for (Nodes::const_iterator it = n.begin(); it != n.end(); ++it)
     {
-        if( it->name() == name )
+        if( it->_name.str() == name )
             return &(*it);
     }
 
     return 0;
 }
 
+void SerializationInfo::_updateIndex()
+{
+    if (_nodes == 0 || _nodes->size() <= memberIndexThreshold)
+        return;
+
+    // The last member is left out since the caller of addMember may still
+    // set its name. It is indexed when the next member is added.
+    Nodes::size_type n = _nodes->size() - 1;
+
+    if (_index)
+    {
+        SerializationInfo& si = (*_nodes)[n - 1];
+        _index->positions.emplace(si._name.str(), n - 1);
+        si._memberOf = _index;
+    }
+    else
+    {
+        log_debug("create member index for " << n << " members");
+        _index = new MemberIndex();
+        _index->nodes = _nodes;
+        _index->positions.reserve(n * 2);
+        for (Nodes::size_type i = 0; i < n; ++i)
+        {
+            SerializationInfo& si = (*_nodes)[i];
+            _index->positions.emplace(si._name.str(), i);
+            si._memberOf = _index;
+        }
+    }
+}
+
+void SerializationInfo::_dropIndex()
+{
+    if (_index == 0)
+        return;
+
+    if (_nodes)
+        for (Nodes::iterator it = _nodes->begin(); it != _nodes->end(); ++it)
+            it->_memberOf = 0;
+
+    delete _index;
+    _index = 0;
+}
+
+void SerializationInfo::_rebuildIndex(MemberIndex& index)
+{
+    // The old name may be used by a later member, so the positions are
+    // collected again.
+    log_debug("rebuild member index after rename");
+    Nodes& n = *index.nodes;
+    index.positions.clear();
+    for (Nodes::size_type i = 0; i + 1 < n.size(); ++i)
+        index.positions.emplace(n[i]._name.str(), i);
+}
+
 void SerializationInfo::clear()
 {
     _category = Void;
-    _name.clear();
+    if (!_name.empty())
+    {
+        _name.clear();
+        _nameChanged();
+    }
     _type.clear();
     if (_nodes)
         _nodes->clear();
+    _dropIndex();
     _releaseValue();
 }
 
@@ -315,8 +514,13 @@ void SerializationInfo::swap(SerializationInfo& si)
         return;
 
     std::swap(_category, si._category);
-    std::swap(_name, si._name);
-    std::swap(_type, si._type);
+    if (_name.str() != si._name.str())
+    {
+        _name.swap(si._name);
+        _nameChanged();
+        si._nameChanged();
+    }
+    _type.swap(si._type);
 
     if (_t == t_string)
     {
@@ -404,6 +608,8 @@ void SerializationInfo::swap(SerializationInfo& si)
     }
 
     std::swap(_nodes, si._nodes);
+    std::swap(_index, si._index);
+    std::swap(_arena, si._arena);
 }
 
 SerializationInfo SerializationInfo::path(const std::string& path) const
@@ -691,7 +897,7 @@ SerializationInfo SerializationInfo::path(const std::string& path) const
 void SerializationInfo::dump(std::ostream& out, const std::string& prefix) const
 {
     if (!_name.empty())
-        out << prefix << "name = \"" << _name << "\"\n";
+        out << prefix << "name = \"" << _name.str() << "\"\n";
 
     if (_t != t_none)
     {
@@ -724,7 +930,7 @@ void SerializationInfo::dump(std::ostream& out, const std::string& prefix) const
     }
 
     if (!_type.empty())
-        out << prefix << "typeName = " << _type << '\n';
+        out << prefix << "typeName = " << _type.str() << '\n';
     out << prefix << "category = " << static_cast<unsigned>(_category) << '\n';
 
     const Nodes& n = nodes();
@@ -1047,7 +1253,7 @@ SerializationInfo::int_type SerializationInfo::_getInt(const char* type, int_typ
                             std::ostringstream msg;
                             msg << "value " << ret << " does not fit into " << type;
                             if (!_name.empty())
-                                msg << " in node " << _name;
+                                msg << " in node " << _name.str();
                             throw std::range_error(msg.str());
                         }
                         ret = _u._u; break;
@@ -1061,7 +1267,7 @@ SerializationInfo::int_type SerializationInfo::_getInt(const char* type, int_typ
         std::ostringstream msg;
         msg << "value " << ret << " does not fit into " << type;
         if (!_name.empty())
-            msg << " in node " << _name;
+            msg << " in node " << _name.str();
         throw std::range_error(msg.str());
     }
 
@@ -1113,7 +1319,7 @@ SerializationInfo::unsigned_type SerializationInfo::_getUInt(const char* type, u
         std::ostringstream msg;
         msg << "value " << ret << " does not fit into " << type;
         if (!_name.empty())
-            msg << " in node " << _name;
+            msg << " in node " << _name.str();
         throw std::range_error(msg.str());
     }
 
@@ -1167,7 +1373,7 @@ float SerializationInfo::_getFloat() const
                 std::ostringstream msg;
                 msg << "value " << _u._d << " does not fit into float";
                 if (!_name.empty())
-                    msg << " in node " << _name;
+                    msg << " in node " << _name.str();
                 throw std::range_error(msg.str());
             }
             else
@@ -1187,7 +1393,7 @@ float SerializationInfo::_getFloat() const
                 std::ostringstream msg;
                 msg << "value " << _u._ld << " does not fit into float";
                 if (!_name.empty())
-                    msg << " in node " << _name;
+                    msg << " in node " << _name.str();
                 throw std::range_error(msg.str());
             }
             else
@@ -1246,7 +1452,7 @@ double SerializationInfo::_getDouble() const
                 std::ostringstream msg;
                 msg << "value " << _u._ld << " does not fit into double";
                 if (!_name.empty())
-                    msg << " in node " << _name;
+                    msg << " in node " << _name.str();
                 throw std::range_error(msg.str());
             }
             else
@@ -1300,11 +1506,31 @@ long double SerializationInfo::_getLongDouble() const
 SerializationInfo::Nodes& SerializationInfo::nodes()
 {
     if (!_nodes)
-        _nodes = new Nodes;
+    {
+        if (_arena)
+            _nodes = new (_arena->allocate(sizeof(Nodes), alignof(Nodes))) Nodes(ArenaAllocator<SerializationInfo>(_arena));
+        else
+            _nodes = new Nodes;
+    }
 
     return *_nodes;
 }
 
+void SerializationInfo::_deleteNodes()
+{
+    if (!_nodes)
+        return;
+
+    // nodes placed in an arena are just destructed; the memory is released
+    // with the arena
+    if (_nodes->get_allocator().arena())
+        _nodes->~Nodes();
+    else
+        delete _nodes;
+
+    _nodes = 0;
+}
+
 const SerializationInfo::Nodes& SerializationInfo::nodes() const
 {
     static const Nodes emptyNodes;
@@ -1320,10 +1546,13 @@ void SerializationInfo::assignData(const SerializationInfo& si)
     _category = si._category;
     _type = si._type;
 
-    delete _nodes;
-    _nodes = 0;
+    _deleteNodes();
+    _dropIndex();
     if (si._nodes)
+    {
         _nodes = new Nodes(*si._nodes);
+        _updateIndex();
+    }
 
     if (si._t == t_string)
         _setString( String(si._String()) );
@@ -113,6 +113,34 @@ SslCtx& SslCtx::setCiphers(const std::string& ciphers)
     return *this;
 }
 
+SslCtx& SslCtx::setSessionCacheSize(unsigned n)
+{
+    impl()->setSessionCacheSize(n);
+    return *this;
+}
+
+SslCtx& SslCtx::setSessionTimeout(Timespan timeout)
+{
+    impl()->setSessionTimeout(timeout);
+    return *this;
+}
+
+SslCtx& SslCtx::setTicketKeyLifetime(Timespan lifetime)
+{
+    impl()->setTicketKeyLifetime(lifetime);
+    return *this;
+}
+
+unsigned long SslCtx::sessionHits() const
+{
+    return _impl ? _impl->sessionHits() : 0;
+}
+
+unsigned long SslCtx::sessionMisses() const
+{
+    return _impl ? _impl->sessionMisses() : 0;
+}
+
 SslCtx SslCtx::secure()
 {
     log_debug("SslCtx SslCtx::secure()");
@@ -30,14 +30,20 @@
 #include <cxxtools/systemerror.h>
 #include <cxxtools/fileinfo.h>
 #include <cxxtools/log.h>
+#include <cxxtools/clock.h>
 
 #include <mutex>
 #include <memory>
 #include <vector>
 
 #include <openssl/ssl.h>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#endif
 
 #include <cstring>
+#include <ctime>
 #include <stdlib.h>
 #include <unistd.h>
 
@@ -62,6 +68,9 @@ static void pthreads_locking_callback(int mode, int n, const char* /* file */, i
 }
 
 SslCtx::Impl::Impl()
+    : _sessionCacheSize(SSL_SESSION_CACHE_MAX_SIZE_DEFAULT),
+      _sessionHits(0),
+      _sessionMisses(0)
 {
     static std::once_flag initOnce;
     std::call_once(initOnce, []()
@@ -87,10 +96,23 @@ SslCtx::Impl::Impl()
 
     log_debug("ctx=" << static_cast<void*>(ctx()));
     SslError::checkSslError();
+
+    // Client sessions are kept in our own cache since openssl does not know,
+    // which session belongs to which peer. Server sessions are kept in the
+    // internal cache of openssl.
+    SSL_CTX_set_app_data(_ctx, this);
+    SSL_CTX_set_session_cache_mode(_ctx, SSL_SESS_CACHE_BOTH);
+    SSL_CTX_sess_set_new_cb(_ctx, newSessionCallback);
+    SSL_CTX_set_info_callback(_ctx, infoCallback);
 }
 
 SslCtx::Impl::~Impl()
 {
+    clearSessions();
+
+    for (auto& key: _ticketKeys)
+        OPENSSL_cleanse(&key, sizeof(key));
+
     log_debug("SSL_CTX_free(" << static_cast<void*>(_ctx) << ')');
     SSL_CTX_free(_ctx);
 }
@@ -249,4 +271,258 @@ void SslCtx::Impl::setCiphers(const std::string& ciphers)
         SslError::checkSslError();
 }
 
+void SslCtx::Impl::setSessionCacheSize(unsigned n)
+{
+    log_debug("setSessionCacheSize(" << n << ')');
+
+    if (n == 0)
+    {
+        SSL_CTX_set_session_cache_mode(_ctx, SSL_SESS_CACHE_OFF);
+    }
+    else
+    {
+        SSL_CTX_set_session_cache_mode(_ctx, SSL_SESS_CACHE_BOTH);
+        SSL_CTX_sess_set_cache_size(_ctx, n);
+    }
+
+    std::lock_guard<std::mutex> lock(_sessionMutex);
+    _sessionCacheSize = n;
+    while (_sessions.size() > n)
+    {
+        SSL_SESSION_free(_sessions.begin()->second);
+        _sessions.erase(_sessions.begin());
+    }
+}
+
+void SslCtx::Impl::setSessionTimeout(Timespan timeout)
+{
+    log_debug("SSL_CTX_set_timeout(" << static_cast<void*>(_ctx) << ", " << timeout.totalSeconds() << ')');
+    SSL_CTX_set_timeout(_ctx, static_cast<long>(timeout.totalSeconds()));
+}
+
+void SslCtx::Impl::setTicketKeyLifetime(Timespan lifetime)
+{
+    log_debug("setTicketKeyLifetime(" << lifetime << ')');
+
+    std::lock_guard<std::mutex> lock(_ticketKeyMutex);
+    _ticketKeyLifetime = lifetime;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(_ctx, lifetime > Timespan(0) ? ticketKeyCallback : nullptr);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(_ctx, lifetime > Timespan(0) ? ticketKeyCallback : nullptr);
+#endif
+}
+
+SSL* SslCtx::Impl::newSsl(const std::string& sessionKey) const
+{
+    log_debug("SSL_new(" << static_cast<void*>(_ctx) << ')');
+    SSL* ssl = SSL_new(_ctx);
+    SslError::checkSslError();
+
+    if (!sessionKey.empty())
+    {
+        SSL_set_ex_data(ssl, sessionKeyIndex(), new std::string(sessionKey));
+
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        auto it = _sessions.find(sessionKey);
+        if (it != _sessions.end())
+        {
+            log_debug("resume ssl session to " << sessionKey);
+            SSL_set_session(ssl, it->second);
+        }
+    }
+
+    return ssl;
+}
+
+void SslCtx::Impl::clearSessions()
+{
+    std::lock_guard<std::mutex> lock(_sessionMutex);
+    for (auto& s: _sessions)
+        SSL_SESSION_free(s.second);
+    _sessions.clear();
+}
+
+void SslCtx::Impl::storeSession(const std::string& key, SSL_SESSION* session)
+{
+    std::lock_guard<std::mutex> lock(_sessionMutex);
+
+    auto it = _sessions.find(key);
+    if (it != _sessions.end())
+    {
+        SSL_SESSION_free(it->second);
+        it->second = session;
+        return;
+    }
+
+    if (_sessions.size() >= _sessionCacheSize)
+    {
+        // make room; expired sessions first, then the first one
+        long now = static_cast<long>(::time(0));
+        for (it = _sessions.begin(); it != _sessions.end(); )
+        {
+            if (SSL_SESSION_get_time(it->second) + SSL_SESSION_get_timeout(it->second) < now)
+            {
+                SSL_SESSION_free(it->second);
+                it = _sessions.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        if (_sessions.size() >= _sessionCacheSize)
+        {
+            SSL_SESSION_free(_sessions.begin()->second);
+            _sessions.erase(_sessions.begin());
+        }
+    }
+
+    _sessions.insert(std::make_pair(key, session));
+}
+
+static void freeSessionKey(void* /* parent */, void* ptr, CRYPTO_EX_DATA* /* ad */, int /* idx */, long /* argl */, void* /* argp */)
+{
+    delete static_cast<std::string*>(ptr);
+}
+
+int SslCtx::Impl::sessionKeyIndex()
+{
+    static int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, freeSessionKey);
+    return index;
+}
+
+int SslCtx::Impl::newSessionCallback(SSL* ssl, SSL_SESSION* session)
+{
+    // with TLSv1.3 this is called when the server sends a session ticket,
+    // which is after the handshake
+    const std::string* key = static_cast<const std::string*>(SSL_get_ex_data(ssl, sessionKeyIndex()));
+    if (SSL_is_server(ssl) || key == nullptr)
+        return 0;
+
+    Impl* impl = static_cast<Impl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    if (impl->_sessionCacheSize == 0)
+        return 0;
+
+    log_debug("store ssl session to " << *key);
+    impl->storeSession(*key, session);
+    return 1;   // we keep the reference
+}
+
+void SslCtx::Impl::infoCallback(const SSL* ssl, int where, int /* ret */)
+{
+    if (where & SSL_CB_HANDSHAKE_DONE)
+    {
+        Impl* impl = static_cast<Impl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+        if (SSL_session_reused(const_cast<SSL*>(ssl)))
+        {
+            log_debug("ssl session resumed");
+            ++impl->_sessionHits;
+        }
+        else
+        {
+            log_debug("full ssl handshake");
+            ++impl->_sessionMisses;
+        }
+    }
+}
+
+const SslCtx::Impl::TicketKey* SslCtx::Impl::currentTicketKey()
+{
+    Timespan now = Clock::getSystemTicks();
+
+    if (_ticketKeys.empty() || now - _ticketKeys.front().created >= _ticketKeyLifetime)
+    {
+        log_debug("create new session ticket key");
+
+        TicketKey key;
+        if (RAND_bytes(key.name, sizeof(key.name)) != 1
+            || RAND_bytes(key.aesKey, sizeof(key.aesKey)) != 1
+            || RAND_bytes(key.hmacKey, sizeof(key.hmacKey)) != 1)
+            return nullptr;
+        key.created = now;
+        _ticketKeys.insert(_ticketKeys.begin(), key);
+        OPENSSL_cleanse(&key, sizeof(key));
+
+        // the previous keys are still accepted for one more lifetime
+        while (_ticketKeys.size() > 1 && now - _ticketKeys.back().created >= _ticketKeyLifetime * 2)
+        {
+            OPENSSL_cleanse(&_ticketKeys.back(), sizeof(TicketKey));
+            _ticketKeys.pop_back();
+        }
+    }
+
+    return &_ticketKeys.front();
+}
+
+const SslCtx::Impl::TicketKey* SslCtx::Impl::findTicketKey(const unsigned char* name, bool& current)
+{
+    for (auto it = _ticketKeys.begin(); it != _ticketKeys.end(); ++it)
+    {
+        if (std::memcmp(it->name, name, sizeof(it->name)) == 0)
+        {
+            current = (it == _ticketKeys.begin());
+            return &*it;
+        }
+    }
+
+    return nullptr;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+static int initHmac(EVP_MAC_CTX* hctx, const unsigned char* key, size_t len)
+{
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, const_cast<unsigned char*>(key), len),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("sha256"), 0),
+        OSSL_PARAM_construct_end()
+    };
+    return EVP_MAC_CTX_set_params(hctx, params);
+}
+
+int SslCtx::Impl::ticketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* ectx, EVP_MAC_CTX* hctx, int enc)
+#else
+static int initHmac(HMAC_CTX* hctx, const unsigned char* key, size_t len)
+{
+    return HMAC_Init_ex(hctx, key, static_cast<int>(len), EVP_sha256(), nullptr);
+}
+
+int SslCtx::Impl::ticketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* ectx, HMAC_CTX* hctx, int enc)
+#endif
+{
+    Impl* impl = static_cast<Impl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    std::lock_guard<std::mutex> lock(impl->_ticketKeyMutex);
+
+    if (enc)
+    {
+        const TicketKey* key = impl->currentTicketKey();
+        if (key == nullptr || RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1)
+            return -1;
+
+        std::memcpy(name, key->name, sizeof(key->name));
+        if (EVP_EncryptInit_ex(ectx, EVP_aes_256_cbc(), nullptr, key->aesKey, iv) != 1
+            || initHmac(hctx, key->hmacKey, sizeof(key->hmacKey)) != 1)
+            return -1;
+
+        return 1;
+    }
+    else
+    {
+        bool current;
+        const TicketKey* key = impl->findTicketKey(name, current);
+        if (key == nullptr)
+        {
+            log_debug("session ticket key not found");
+            return 0;
+        }
+
+        if (EVP_DecryptInit_ex(ectx, EVP_aes_256_cbc(), nullptr, key->aesKey, iv) != 1
+            || initHmac(hctx, key->hmacKey, sizeof(key->hmacKey)) != 1)
+            return -1;
+
+        // A ticket from an older key is accepted but a new one is issued.
+        // TLSv1.3 tickets should not be reused, so we always renew them.
+        return current && SSL_version(ssl) < TLS1_3_VERSION ? 1 : 2;
+    }
+}
+
 }
@@ -31,8 +31,17 @@
 
 #include <cxxtools/sslctx.h>
 #include <cxxtools/refcounted.h>
+#include <cxxtools/timespan.h>
 
 #include <openssl/ssl.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace cxxtools
 {
@@ -40,6 +49,41 @@ class SslCtx::Impl : public cxxtools::AtomicRefCounted
 {
     SSL_CTX* _ctx;
 
+    // client side session cache indexed by "host:port"
+    mutable std::mutex _sessionMutex;
+    mutable std::map<std::string, SSL_SESSION*> _sessions;
+    unsigned _sessionCacheSize;
+
+    // session ticket keys for rotation; the first one encrypts new tickets
+    struct TicketKey
+    {
+        unsigned char name[16];
+        unsigned char aesKey[32];
+        unsigned char hmacKey[32];
+        Timespan created;
+    };
+
+    std::mutex _ticketKeyMutex;
+    std::vector<TicketKey> _ticketKeys;
+    Timespan _ticketKeyLifetime;
+
+    std::atomic<unsigned long> _sessionHits;
+    std::atomic<unsigned long> _sessionMisses;
+
+    void clearSessions();
+    void storeSession(const std::string& key, SSL_SESSION* session);
+    const TicketKey* currentTicketKey();
+    const TicketKey* findTicketKey(const unsigned char* name, bool& current);
+
+    static int sessionKeyIndex();
+    static int newSessionCallback(SSL* ssl, SSL_SESSION* session);
+    static void infoCallback(const SSL* ssl, int where, int ret);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static int ticketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* ectx, EVP_MAC_CTX* hctx, int enc);
+#else
+    static int ticketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* ectx, HMAC_CTX* hctx, int enc);
+#endif
+
 public:
     Impl();
     Impl(const Impl&) = delete;
@@ -52,6 +96,17 @@ public:
     void setVerify(SslCtx::VERIFY_LEVEL level, const std::string& ca);
     void setProtocolVersion(PROTOCOL_VERSION min, PROTOCOL_VERSION max);
     void setCiphers(const std::string& ciphers);
+
+    void setSessionCacheSize(unsigned n);
+    void setSessionTimeout(Timespan timeout);
+    void setTicketKeyLifetime(Timespan lifetime);
+
+    // creates a new ssl connection object; client connections pass a
+    // `sessionKey` to resume a previous session to the same peer
+    SSL* newSsl(const std::string& sessionKey = std::string()) const;
+
+    unsigned long sessionHits() const     { return _sessionHits; }
+    unsigned long sessionMisses() const   { return _sessionMisses; }
 };
 }
 
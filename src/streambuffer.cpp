@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <cstring>
+#include <memory>
 #include <cxxtools/log.h>
 
 log_define("cxxtools.streambuffer")
@@ -68,6 +69,15 @@ StreamBuffer::StreamBuffer(size_t bufferSize, bool extend)
 
 StreamBuffer::~StreamBuffer()
 {
+    try
+    {
+        releaseBorrowed(_oborrowed.size());
+    }
+    catch (const std::exception& e)
+    {
+        log_warn("releasing borrowed buffer failed: " << e.what());
+    }
+
     delete[] _ibuffer;
     delete[] _obuffer;
 }
@@ -209,6 +219,12 @@ size_t StreamBuffer::beginWrite()
         return 0;
     }
 
+    if (!_oborrowed.empty())
+    {
+        fillOutputVec();
+        return _ioDevice->beginWritev(_ovec.data(), _ovec.size());
+    }
+
     if (pptr())
     {
         size_t avail = pptr() - pbase();
@@ -222,6 +238,155 @@ size_t StreamBuffer::beginWrite()
 }
 
 
+void StreamBuffer::writeBorrowed(const char* data, size_t size)
+{
+    if (size == 0)
+        return;
+
+    Borrowed b = { data, size, static_cast<size_t>(out_avail()), 0 };
+    _oborrowed.push_back(b);
+}
+
+
+void StreamBuffer::writeBorrowed(const char* data, size_t size, const Callable<void>& released)
+{
+    if (size == 0)
+    {
+        released.call();
+        return;
+    }
+
+    std::unique_ptr<Callable<void> > r(released.clone());
+    Borrowed b = { data, size, static_cast<size_t>(out_avail()), r.get() };
+    _oborrowed.push_back(b);
+    r.release();
+}
+
+
+size_t StreamBuffer::borrowedAvail() const
+{
+    size_t n = 0;
+    for (std::vector<Borrowed>::const_iterator it = _oborrowed.begin(); it != _oborrowed.end(); ++it)
+        n += it->size;
+    return n;
+}
+
+
+void StreamBuffer::fillOutputVec()
+{
+    size_t avail = pptr() ? pptr() - pbase() : 0;
+
+    _ovec.clear();
+
+    size_t p = 0;
+    for (std::vector<Borrowed>::const_iterator it = _oborrowed.begin(); it != _oborrowed.end(); ++it)
+    {
+        if (it->pos > p)
+        {
+            IOVec v = { _obuffer + p, it->pos - p };
+            _ovec.push_back(v);
+            p = it->pos;
+        }
+
+        IOVec v = { it->data, it->size };
+        _ovec.push_back(v);
+    }
+
+    if (avail > p)
+    {
+        IOVec v = { _obuffer + p, avail - p };
+        _ovec.push_back(v);
+    }
+}
+
+
+size_t StreamBuffer::writeOutput()
+{
+    size_t written;
+    if (_oborrowed.empty())
+    {
+        written = _ioDevice->write(_obuffer, pptr() - pbase());
+    }
+    else
+    {
+        fillOutputVec();
+        written = _ioDevice->writev(_ovec.data(), _ovec.size());
+    }
+
+    consumeOutput(written);
+    return written;
+}
+
+
+void StreamBuffer::consumeOutput(size_t n)
+{
+    size_t avail = pptr() ? pptr() - pbase() : 0;
+    size_t used = 0;    // bytes consumed from the output buffer
+    size_t done = 0;    // number of borrowed buffers written completely
+
+    while (done < _oborrowed.size())
+    {
+        Borrowed& b = _oborrowed[done];
+
+        size_t k = std::min(n, b.pos - used);
+        used += k;
+        n -= k;
+        if (used < b.pos)
+            break;
+
+        k = std::min(n, b.size);
+        b.data += k;
+        b.size -= k;
+        n -= k;
+        if (b.size > 0)
+            break;
+
+        ++done;
+    }
+
+    // the rest is from the output buffer after the last borrowed buffer
+    used += n;
+
+    size_t leftover = avail - used;
+
+    log_debug(used << " bytes written from buffer; " << leftover << " left in buffer; "
+        << done << " borrowed buffers finished");
+
+    if (leftover > 0 && used > 0)
+    {
+        traits_type::move(_obuffer, _obuffer + used, leftover);
+    }
+
+    if (_obuffer)
+    {
+        setp(_obuffer, _obuffer + _obufferSize);
+        pbump( leftover );
+    }
+
+    for (size_t i = done; i < _oborrowed.size(); ++i)
+        _oborrowed[i].pos -= used;
+
+    releaseBorrowed(done);
+}
+
+
+void StreamBuffer::releaseBorrowed(size_t count)
+{
+    if (count == 0)
+        return;
+
+    std::vector<std::unique_ptr<Callable<void> > > released;
+    for (size_t i = 0; i < count; ++i)
+        if (_oborrowed[i].released)
+            released.push_back(std::unique_ptr<Callable<void> >(_oborrowed[i].released));
+
+    _oborrowed.erase(_oborrowed.begin(), _oborrowed.begin() + count);
+
+    for (size_t i = 0; i < released.size(); ++i)
+        released[i]->call();
+}
+
+
 void StreamBuffer::discard()
 {
     if (_ioDevice && (_ioDevice->reading() || _ioDevice->writing()))
@@ -232,6 +397,8 @@ void StreamBuffer::discard()
 
     if (pptr())
         setp(_obuffer, _obuffer + _obufferSize);
+
+    releaseBorrowed(_oborrowed.size());
 }
 
 
@@ -245,26 +412,18 @@ size_t StreamBuffer::endWrite()
 {
     log_trace("endWrite; out_avail=" << out_avail());
 
-    size_t leftover = 0;
     size_t written = 0;
 
-    if (pptr())
+    if (pptr() || !_oborrowed.empty())
     {
-        size_t avail = pptr() - pbase();
         written = _ioDevice->endWrite();
-
-        leftover = avail - written;
-
-        log_debug(written << " bytes written; " << leftover << " left in buffer");
-
-        if (leftover > 0)
-        {
-            traits_type::move(_obuffer, _obuffer + written, leftover);
-        }
+        log_debug(written << " bytes written");
+        consumeOutput(written);
+    }
+    else
+    {
+        setp(_obuffer, _obuffer + _obufferSize);
     }
-
-    setp(_obuffer, _obuffer + _obufferSize);
-    pbump( leftover );
 
     return written;
 }
@@ -338,17 +497,14 @@ StreamBuffer::int_type StreamBuffer::overflow(int_type ch)
     {
         // normal blocking overflow case
         log_debug("blocking overflow");
-        size_t avail = pptr() - _obuffer;
-        size_t written = _ioDevice->write(_obuffer, avail);
-        size_t leftover = avail - written;
-
-        if (leftover > 0)
-        {
-            traits_type::move(_obuffer, _obuffer + written, leftover);
-        }
+        writeOutput();
+    }
 
-        setp(_obuffer, _obuffer + _obufferSize);
-        pbump( leftover );
+    // a write may have consumed borrowed data only
+    while (!traits_type::eq_int_type(ch, traits_type::eof()) && pptr() == epptr())
+    {
+        log_debug("blocking overflow");
+        writeOutput();
     }
 
     // if the overflow char is not EOF put it in buffer
@@ -375,9 +531,9 @@ int StreamBuffer::sync()
     if (! _ioDevice)
         return 0;
 
-    if (pptr())
+    if (pptr() || !_oborrowed.empty())
     {
-        while (pptr() > pbase())
+        while (pptr() > pbase() || !_oborrowed.empty())
         {
             const int_type ch = overflow( traits_type::eof() );
             if (ch == traits_type::eof())
@@ -210,6 +210,20 @@ void TcpServerImpl::listen(const std::string& ipaddr, unsigned short int port, i
                 }
             }
 
+            if ((flags & TcpServer::REUSEPORT) && port != 0)
+            {
+#ifdef HAVE_SO_REUSEPORT
+                log_debug("setsockopt SO_REUSEPORT");
+                if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0)
+                {
+                    log_debug("could not set socket option SO_REUSEPORT " << fd << ": " << getErrnoString());
+                    throwSystemError("setsockopt");
+                }
+#else
+                log_debug("SO_REUSEPORT not supported");
+#endif
+            }
+
 #ifdef HAVE_IPV6
             if (it->ai_family == AF_INET6)
             {
@@ -282,6 +282,50 @@ size_t TcpSocket::onBeginWrite(const char* buffer, size_t n)
     return _impl->beginWrite(buffer, n);
 }
 
+size_t TcpSocket::beginSendFile(int fd, size_t offset, size_t n)
+{
+    if (!_impl->isConnected())
+        throw IOError("socket not connected when trying to write");
+
+    if (!_impl->sendFileSupported())
+    {
+        const char* data;
+        size_t count = _impl->readFile(fd, offset, n, data);
+        return beginWrite(data, count);
+    }
+
+    if (!async())
+        throw std::logic_error("Device not in async mode");
+
+    if (!enabled())
+        throw std::logic_error("Device not enabled");
+
+    if (_wbuf)
+        throw IOPending("write operation pending");
+
+    size_t r = _impl->beginSendFile(fd, offset, n);
+
+    if (r > 0 || _ravail)
+        setState(Selectable::Avail);
+    else
+        setState(Selectable::Busy);
+
+    // there is no buffer; the file is sent by the implementation
+    _wbuf = "";
+    _wbuflen = n;
+    _wavail = r;
+
+    return r;
+}
+
+size_t TcpSocket::onBeginWritev(const IOVec* vec, size_t count)
+{
+    if (!_impl->isConnected())
+        throw IOError("socket not connected when trying to write");
+
+    return _impl->beginWritev(vec, count);
+}
+
 IODeviceImpl& TcpSocket::ioimpl()
 {
     return *_impl;
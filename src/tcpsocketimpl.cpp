@@ -32,6 +32,7 @@
 #include <sys/socket.h>
 #endif
 #include <netinet/tcp.h>
+#include <sys/uio.h>
 
 #if !defined(MSG_MSG_NOSIGNAL)
 #include <signal.h>
@@ -58,6 +59,7 @@
 #include <arpa/inet.h>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 
 #include <openssl/err.h>
 #include <openssl/ssl.h>
@@ -67,6 +69,10 @@
 #include <unistd.h>
 #include <cstring>
 
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+#include <sys/sendfile.h>
+#endif
+
 log_define("cxxtools.net.tcpsocket.impl")
 log_define_instance(ssl, "cxxtools.net.tcpsocket.impl.ssl")
 
@@ -181,6 +187,8 @@ void TcpSocketImpl::checkSslOperation(int ret, const char* fn, pollfd* pfd)
             {
                 pfd->events |= POLLIN;
                 pfd->events &= ~POLLOUT;
+                if (pfd == _pfd)
+                    pollChanged();
             }
             break;
 
@@ -192,6 +200,8 @@ void TcpSocketImpl::checkSslOperation(int ret, const char* fn, pollfd* pfd)
             {
                 pfd->events |= POLLOUT;
                 pfd->events &= ~POLLIN;
+                if (pfd == _pfd)
+                    pollChanged();
             }
             break;
 
@@ -240,26 +250,39 @@ void TcpSocketImpl::waitSslOperation(int ret, cxxtools::Timespan timeout)
     }
 }
 
-void TcpSocketImpl::initSsl(const SslCtx& sslCtx)
+void TcpSocketImpl::initSsl(const SslCtx& sslCtx, const std::string& sessionKey)
 {
     if (_ssl)
         return;
 
-    log_debug_to(ssl, "SSL_new(" << static_cast<void*>(sslCtx.impl()->ctx()) << ')');
-    _ssl = SSL_new(sslCtx.impl()->ctx());
-    SslError::checkSslError();
+    _ssl = sslCtx.impl()->newSsl(sessionKey);
 
     log_debug_to(ssl, "SSL_set_fd(" << _ssl << ", " << _fd << ')');
     SSL_set_fd(_ssl, _fd);
 }
 
+void TcpSocketImpl::freeSsl()
+{
+    // Openssl invalidates the session when the connection is not shut down
+    // properly. We close without ssl shutdown but want to be able to
+    // resume the session later.
+    if (_state == SSLCONNECTED)
+        SSL_set_shutdown(_ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+
+    log_debug("SSL_free");
+    SSL_free(_ssl);
+}
+
 TcpSocketImpl::TcpSocketImpl(TcpSocket& socket)
 : IODeviceImpl(socket),
   _socket(socket),
   _state(IDLE),
   _sentry(0),
   _ssl(0),
-  _peerCertificateLoaded(false)
+  _peerCertificateLoaded(false),
+  _sendFileFd(-1),
+  _sendFileOffset(0),
+  _sendFileSize(0)
 {
 }
 
@@ -269,7 +292,7 @@ TcpSocketImpl::~TcpSocketImpl()
     assert(_pfd == 0);
 
     if (_ssl)
-        SSL_free(_ssl);
+        freeSsl();
 
     if (_sentry)
         _sentry->detach();
@@ -280,15 +303,14 @@ void TcpSocketImpl::close()
 {
     log_debug("close socket " << _fd);
     IODeviceImpl::close();
-    _state = IDLE;
-    _peerCertificate.clear();
-    _peerCertificateLoaded = false;
     if (_ssl)
     {
-        log_debug("SSL_free");
-        SSL_free(_ssl);
+        freeSsl();
         _ssl = 0;
     }
+    _state = IDLE;
+    _peerCertificate.clear();
+    _peerCertificateLoaded = false;
 }
 
 
@@ -440,6 +462,7 @@ void TcpSocketImpl::endConnect()
     if (_pfd && ! _socket.wbuf())
     {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
     }
 
     checkPendingError();
@@ -711,21 +734,35 @@ bool TcpSocketImpl::checkPollEvent(pollfd& pfd)
 
 size_t TcpSocketImpl::callSend(const char* buffer, size_t n)
 {
-    log_debug("::send(" << _fd << ", buffer, " << n << ')');
     log_finer(hexDump(buffer, n));
 
+    iovec iov;
+    iov.iov_base = const_cast<char*>(buffer);
+    iov.iov_len = n;
+    return callSend(&iov, 1);
+}
+
+size_t TcpSocketImpl::callSend(iovec* iov, size_t count)
+{
+    log_debug("::sendmsg(" << _fd << ", iov, " << count << ')');
+
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+
 #if defined(HAVE_MSG_NOSIGNAL)
 
     ssize_t ret;
     do {
-        ret = ::send(_fd, (const void*)buffer, n, MSG_NOSIGNAL);
+        ret = ::sendmsg(_fd, &msg, MSG_NOSIGNAL);
     } while (ret == -1 && errno == EINTR);
 
 #elif defined(HAVE_SO_NOSIGPIPE)
 
     ssize_t ret;
     do {
-        ret = ::send(_fd, (const void*)buffer, n, 0);
+        ret = ::sendmsg(_fd, &msg, 0);
     } while (ret == -1 && errno == EINTR);
 
 #else
@@ -739,7 +776,7 @@ size_t TcpSocketImpl::callSend(const char* buffer, size_t n)
     // execute send
     ssize_t ret;
     do {
-        ret = ::send(_fd, (const void*)buffer, n, 0);
+        ret = ::sendmsg(_fd, &msg, 0);
     } while (ret == -1 && errno == EINTR);
 
     // clear possible SIGPIPE
@@ -760,7 +797,7 @@ size_t TcpSocketImpl::callSend(const char* buffer, size_t n)
 
     int e = errno;
 
-    log_debug("send returned " << ret);
+    log_debug("sendmsg returned " << ret);
     if (ret > 0)
         return static_cast<size_t>(ret);
 
@@ -783,7 +820,10 @@ size_t TcpSocketImpl::beginWrite(const char* buffer, size_t n)
             return ret;
 
         if (_pfd)
+        {
             _pfd->events |= POLLOUT;
+            pollChanged();
+        }
     }
     else if (_state == SSLCONNECTED)
     {
@@ -855,6 +895,213 @@ size_t TcpSocketImpl::write(const char* buffer, size_t n)
     return static_cast<size_t>(ret);
 }
 
+size_t TcpSocketImpl::beginWritev(const IOVec* vec, size_t count)
+{
+    if (_state == CONNECTED)
+    {
+        iovec iov[maxIovec];
+        size_t n = toIovec(vec, count, iov);
+        if (n == 0)
+            return 0;
+
+        size_t ret = callSend(iov, n);
+
+        if (ret > 0)
+            return ret;
+
+        if (_pfd)
+        {
+            _pfd->events |= POLLOUT;
+            pollChanged();
+        }
+
+        return 0;
+    }
+
+    // ssl has no vectored write; write the first buffer
+    for (size_t i = 0; i < count; ++i)
+        if (vec[i].size > 0)
+            return beginWrite(vec[i].data, vec[i].size);
+
+    return 0;
+}
+
+
+size_t TcpSocketImpl::writev(const IOVec* vec, size_t count)
+{
+    if (_state == CONNECTED)
+    {
+        iovec iov[maxIovec];
+        size_t n = toIovec(vec, count, iov);
+        if (n == 0)
+            return 0;
+
+        while (true)
+        {
+            size_t ret = callSend(iov, n);
+            if (ret > 0)
+                return ret;
+
+            if (errno != EAGAIN)
+                throw IOError(getErrnoString("sendmsg"));
+
+            pollfd pfd;
+            pfd.fd = _fd;
+            pfd.revents = 0;
+            pfd.events = POLLOUT;
+
+            if (!wait(_timeout, pfd))
+                throw IOTimeout();
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        if (vec[i].size > 0)
+            return write(vec[i].data, vec[i].size);
+
+    return 0;
+}
+
+bool TcpSocketImpl::sendFileSupported() const
+{
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+    return _state == CONNECTED;
+#else
+    return false;
+#endif
+}
+
+
+size_t TcpSocketImpl::callSendFile(int fd, size_t offset, size_t n)
+{
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+    log_debug("::sendfile(" << _fd << ", " << fd << ", " << offset << ", " << n << ')');
+
+    off_t off = offset;
+    ssize_t ret;
+    do {
+        ret = ::sendfile(_fd, fd, &off, n);
+    } while (ret == -1 && errno == EINTR);
+
+    int e = errno;
+
+    log_debug("sendfile returned " << ret);
+    if (ret > 0)
+        return static_cast<size_t>(ret);
+
+    if (ret == 0)
+        throw IOError("unexpected end of file in sendfile");
+
+    errno = e;
+
+    if (e == ECONNRESET || e == EPIPE)
+        throw IOError("lost connection to peer");
+
+    if (e != EAGAIN)
+        throw IOError(getErrnoString("sendfile"));
+
+    return 0;
+#else
+    throw std::logic_error("sendfile not supported");
+#endif
+}
+
+
+size_t TcpSocketImpl::beginSendFile(int fd, size_t offset, size_t n)
+{
+    _sendFileFd = fd;
+    _sendFileOffset = offset;
+    _sendFileSize = n;
+
+    try
+    {
+        size_t ret = callSendFile(fd, offset, n);
+        if (ret > 0)
+            return ret;
+
+        if (_pfd)
+        {
+            _pfd->events |= POLLOUT;
+            pollChanged();
+        }
+    }
+    catch (const std::exception&)
+    {
+        _exception = std::current_exception();
+    }
+
+    return 0;
+}
+
+
+size_t TcpSocketImpl::readFile(int fd, size_t offset, size_t n, const char*& data)
+{
+    static const size_t fileBufferSize = 65536;
+
+    if (_fileBuffer.size() < fileBufferSize)
+        _fileBuffer.resize(fileBufferSize);
+
+    size_t count = std::min(n, _fileBuffer.size());
+
+    ssize_t ret;
+    do {
+        ret = ::pread(fd, _fileBuffer.data(), count, offset);
+    } while (ret == -1 && errno == EINTR);
+
+    log_debug("pread(" << fd << ", " << count << ", " << offset << ") returned " << ret);
+
+    if (ret < 0)
+        throw IOError(getErrnoString("pread"));
+
+    if (ret == 0)
+        throw IOError("unexpected end of file");
+
+    data = _fileBuffer.data();
+    return static_cast<size_t>(ret);
+}
+
+
+size_t TcpSocketImpl::endWrite()
+{
+    if (_sendFileFd < 0)
+        return IODeviceImpl::endWrite();
+
+    int fd = _sendFileFd;
+    _sendFileFd = -1;
+
+    // data already sent or error pending
+    if (_device.wavail() > 0 || _exception || _errorPending)
+        return IODeviceImpl::endWrite();
+
+    if (_pfd)
+    {
+        _pfd->events &= ~POLLOUT;
+        pollChanged();
+    }
+
+    while (true)
+    {
+        size_t ret = callSendFile(fd, _sendFileOffset, _sendFileSize);
+        if (ret > 0)
+            return ret;
+
+        pollfd pfd;
+        pfd.fd = _fd;
+        pfd.revents = 0;
+        pfd.events = POLLOUT;
+
+        if (!wait(_timeout, pfd))
+            throw IOTimeout();
+    }
+}
+
+
+void TcpSocketImpl::cancel()
+{
+    IODeviceImpl::cancel();
+    _sendFileFd = -1;
+}
+
 void TcpSocketImpl::inputReady()
 {
     log_trace("inputReady; state=" << static_cast<int>(_state));
@@ -985,7 +1232,10 @@ bool TcpSocketImpl::beginSslConnect(const SslCtx& ctx)
     }
 
     _state = SSLCONNECTING;
-    initSsl(ctx);
+
+    std::ostringstream sessionKey;
+    sessionKey << _addrInfo.host() << ':' << _addrInfo.port();
+    initSsl(ctx, sessionKey.str());
 
     return continueSslConnect();
 }
@@ -1018,7 +1268,10 @@ void TcpSocketImpl::endSslConnect()
     log_trace("ending ssl connect");
 
     if (_pfd && !_socket.wbuf())
+    {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
+    }
 
     if (_state == THROWING)
         throw;
@@ -1108,7 +1361,10 @@ void TcpSocketImpl::endSslAccept()
     log_trace_to(ssl, "ending ssl accept");
 
     if (_pfd && !_socket.wbuf())
+    {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
+    }
 
     if (_state == THROWING)
         throw;
@@ -1184,7 +1440,10 @@ void TcpSocketImpl::endSslShutdown()
     log_trace_to(ssl, "ending ssl shutdown");
 
     if (_pfd && !_socket.wbuf())
+    {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
+    }
 
     if (_state == CONNECTED)
         return;
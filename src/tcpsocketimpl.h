@@ -106,9 +106,17 @@ class TcpSocketImpl : public IODeviceImpl
         mutable bool _peerCertificateLoaded;
         mutable SslCertificate _peerCertificate;
 
+        // file sent by a pending beginSendFile
+        int _sendFileFd;
+        size_t _sendFileOffset;
+        size_t _sendFileSize;
+        std::vector<char> _fileBuffer;
+
         // methods
         int checkConnect();
         size_t callSend(const char* buffer, size_t n);
+        size_t callSend(iovec* iov, size_t count);
+        size_t callSendFile(int fd, size_t offset, size_t n);
         void checkPendingError();
         std::string tryConnect();
         std::string connectFailedMessages();
@@ -116,7 +124,8 @@ class TcpSocketImpl : public IODeviceImpl
         void checkSslOperation(int ret, const char* fn, pollfd* pfd);
         void waitSslOperation(int ret, cxxtools::Timespan timeout);
 
-        void initSsl(const SslCtx& sslCtx);
+        void initSsl(const SslCtx& sslCtx, const std::string& sessionKey = std::string());
+        void freeSsl();
 
     public:
         explicit TcpSocketImpl(TcpSocket& socket);
@@ -155,6 +164,26 @@ class TcpSocketImpl : public IODeviceImpl
         // override write to use send(2) instead of write(2)
         virtual size_t write(const char* buffer, size_t count);
 
+        // override vectored writes to use sendmsg(2) instead of writev(2)
+        virtual size_t beginWritev(const IOVec* vec, size_t count);
+
+        virtual size_t writev(const IOVec* vec, size_t count);
+
+        // returns true if files can be sent with sendfile(2)
+        bool sendFileSupported() const;
+
+        // starts sending a file with sendfile(2)
+        size_t beginSendFile(int fd, size_t offset, size_t n);
+
+        // reads the next part of a file for sending it without sendfile(2)
+        size_t readFile(int fd, size_t offset, size_t n, const char*& data);
+
+        // override to finish a pending beginSendFile
+        virtual size_t endWrite();
+
+        // override to reset a pending beginSendFile
+        virtual void cancel();
+
         // override for ssl
         virtual size_t read(char* buffer, size_t count, bool& eof);
 
@@ -68,6 +68,7 @@ Timer::Timer(SelectorBase* selector)
 , _selector(0)
 , _active(false)
 , _finished(0)
+, _heapIndex(SelectorBase::noTimerIndex)
 {
     if (selector)
         setSelector(selector);
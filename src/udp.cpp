@@ -26,15 +26,18 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include "config.h"
 #include <cxxtools/net/addrinfo.h>
 #include "addrinfoimpl.h"
 #include <cxxtools/net/udp.h>
 #include <cxxtools/log.h>
 #include <cxxtools/systemerror.h>
 #include <cxxtools/net/tcpserver.h>
+#include "tcpsocketimpl.h"
 #include <netdb.h>
 #include <sys/poll.h>
 #include <vector>
+#include <stdexcept>
 #include <errno.h>
 #include <string.h>
 
@@ -45,6 +48,216 @@ namespace cxxtools
 
 namespace net
 {
+  //////////////////////////////////////////////////////////////////////
+  // UdpBatch
+  //
+  UdpBatch::UdpBatch(unsigned capacity, size_type maxSize)
+    : _capacity(capacity),
+      _maxSize(maxSize),
+      _size(0),
+      _data(capacity * maxSize),
+      _length(capacity),
+      _truncated(capacity),
+      _peer(capacity),
+      _peerLen(capacity),
+      _iov(capacity),
+      _msgs(0)
+  {
+    for (unsigned n = 0; n < capacity; ++n)
+      _iov[n].iov_base = &_data[n * maxSize];
+
+#if defined(HAVE_RECVMMSG) || defined(HAVE_SENDMMSG)
+    _msgs = new mmsghdr[capacity];
+    memset(_msgs, 0, capacity * sizeof(mmsghdr));
+    for (unsigned n = 0; n < capacity; ++n)
+    {
+      _msgs[n].msg_hdr.msg_iov = &_iov[n];
+      _msgs[n].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+  }
+
+  UdpBatch::~UdpBatch()
+  {
+#if defined(HAVE_RECVMMSG) || defined(HAVE_SENDMMSG)
+    delete[] _msgs;
+#endif
+  }
+
+  void UdpBatch::add(const void* message, size_type length)
+  {
+    memcpy(add(length), message, length);
+  }
+
+  char* UdpBatch::add(size_type length)
+  {
+    if (full())
+      throw std::length_error("udp batch is full");
+    if (length > _maxSize)
+      throw std::length_error("message exceeds maximum datagram size of udp batch");
+
+    _length[_size] = length;
+    _truncated[_size] = 0;
+    _peerLen[_size] = 0;
+    return data(_size++);
+  }
+
+  std::string UdpBatch::peerAddr(unsigned n) const
+  {
+    if (_peerLen[n] == 0)
+      return std::string();
+
+    return formatIp(*reinterpret_cast<const Sockaddr*>(&_peer[n]));
+  }
+
+  namespace
+  {
+    // sends the datagrams of the batch; uses the peer of each datagram
+    // when `peeraddr` is set and the datagram was received from a peer
+    unsigned sendBatch(const Socket& socket, const UdpBatch& batch,
+      iovec* iov, mmsghdr* msgs, const struct sockaddr_storage* peer,
+      const socklen_t* peerLen, const struct sockaddr_storage* peeraddr,
+      socklen_t peeraddrLen, int flags)
+    {
+      const unsigned count = batch.size();
+
+      for (unsigned n = 0; n < count; ++n)
+        iov[n].iov_len = batch.length(n);
+
+#ifdef HAVE_SENDMMSG
+      for (unsigned n = 0; n < count; ++n)
+      {
+        msghdr& hdr = msgs[n].msg_hdr;
+        if (peeraddr == 0)
+        {
+          hdr.msg_name = 0;
+          hdr.msg_namelen = 0;
+        }
+        else if (peerLen[n] > 0)
+        {
+          hdr.msg_name = const_cast<struct sockaddr_storage*>(&peer[n]);
+          hdr.msg_namelen = peerLen[n];
+        }
+        else
+        {
+          hdr.msg_name = const_cast<struct sockaddr_storage*>(peeraddr);
+          hdr.msg_namelen = peeraddrLen;
+        }
+      }
+
+      unsigned sent = 0;
+      while (sent < count)
+      {
+        log_debug("sendmmsg " << (count - sent) << " messages");
+        int ret = ::sendmmsg(socket.getFd(), msgs + sent, count - sent, flags);
+        if (ret < 0)
+          throw SystemError("sendmmsg");
+        sent += static_cast<unsigned>(ret);
+      }
+
+      return sent;
+#else
+      for (unsigned n = 0; n < count; ++n)
+      {
+        ssize_t ret;
+        if (peeraddr == 0)
+          ret = ::send(socket.getFd(), iov[n].iov_base, iov[n].iov_len, flags);
+        else if (peerLen[n] > 0)
+          ret = ::sendto(socket.getFd(), iov[n].iov_base, iov[n].iov_len, flags,
+            reinterpret_cast<const struct sockaddr*>(&peer[n]), peerLen[n]);
+        else
+          ret = ::sendto(socket.getFd(), iov[n].iov_base, iov[n].iov_len, flags,
+            reinterpret_cast<const struct sockaddr*>(peeraddr), peeraddrLen);
+
+        if (ret < 0)
+          throw SystemError("sendto");
+      }
+
+      return count;
+#endif
+    }
+
+    // receives datagrams into the batch; waits for the first one
+    unsigned recvBatch(const Socket& socket, UdpBatch& batch,
+      iovec* iov, mmsghdr* msgs, struct sockaddr_storage* peer,
+      socklen_t* peerLen, UdpBatch::size_type* length, char* truncated, int flags)
+    {
+      const unsigned capacity = batch.capacity();
+
+      for (unsigned n = 0; n < capacity; ++n)
+        iov[n].iov_len = batch.maxSize();
+
+#ifdef HAVE_RECVMMSG
+      for (unsigned n = 0; n < capacity; ++n)
+      {
+        msgs[n].msg_hdr.msg_name = &peer[n];
+        msgs[n].msg_hdr.msg_namelen = sizeof(peer[n]);
+      }
+
+      log_debug("recvmmsg " << capacity << " messages");
+      int ret = ::recvmmsg(socket.getFd(), msgs, capacity, flags | MSG_WAITFORONE, 0);
+
+      if (ret < 0 && errno == EAGAIN)
+      {
+        if (socket.getTimeout() == 0)
+          throw IOTimeout();
+
+        socket.poll(POLLIN);
+
+        ret = ::recvmmsg(socket.getFd(), msgs, capacity, flags | MSG_WAITFORONE, 0);
+      }
+
+      if (ret < 0)
+        throw SystemError("recvmmsg");
+
+      for (int n = 0; n < ret; ++n)
+      {
+        length[n] = msgs[n].msg_len;
+        truncated[n] = (msgs[n].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        peerLen[n] = msgs[n].msg_hdr.msg_namelen;
+      }
+
+      return static_cast<unsigned>(ret);
+#else
+      unsigned count = 0;
+      while (count < capacity)
+      {
+        // recvmsg tells us, when the datagram did not fit
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &peer[count];
+        msg.msg_namelen = sizeof(peer[count]);
+        msg.msg_iov = &iov[count];
+        msg.msg_iovlen = 1;
+
+        ssize_t ret = ::recvmsg(socket.getFd(), &msg,
+          count == 0 ? flags : (flags | MSG_DONTWAIT));
+
+        if (ret < 0 && errno == EAGAIN)
+        {
+          if (count > 0)
+            break;
+
+          if (socket.getTimeout() == 0)
+            throw IOTimeout();
+
+          socket.poll(POLLIN);
+          continue;
+        }
+
+        if (ret < 0)
+          throw SystemError("recvmsg");
+
+        peerLen[count] = msg.msg_namelen;
+        truncated[count] = (msg.msg_flags & MSG_TRUNC) != 0;
+        length[count++] = static_cast<UdpBatch::size_type>(ret);
+      }
+
+      return count;
+#endif
+    }
+  }
+
   //////////////////////////////////////////////////////////////////////
   // UdpSender
   //
@@ -132,15 +345,30 @@ namespace net
     return std::string(&buffer[0], len);
   }
 
+  unsigned UdpSender::send(const UdpBatch& batch, int flags) const
+  {
+    return sendBatch(*this, batch, &batch._iov[0], batch._msgs,
+      0, 0, 0, 0, flags);
+  }
+
+  unsigned UdpSender::recv(UdpBatch& batch, int flags) const
+  {
+    batch._size = recvBatch(*this, batch, &batch._iov[0], batch._msgs,
+      &batch._peer[0], &batch._peerLen[0], &batch._length[0], &batch._truncated[0], flags);
+    return batch._size;
+  }
+
   //////////////////////////////////////////////////////////////////////
   // UdpReceiver
   //
   UdpReceiver::UdpReceiver()
+    : peeraddrLen(0)
   {
     memset(&peeraddr, 0, sizeof(peeraddr));
   }
 
   UdpReceiver::UdpReceiver(const std::string& ipaddr, unsigned short int port)
+    : peeraddrLen(0)
   {
     memset(&peeraddr, 0, sizeof(peeraddr));
     bind(ipaddr, port);
@@ -221,6 +449,28 @@ namespace net
     return send(message.data(), message.size(), flags);
   }
 
+  unsigned UdpReceiver::recv(UdpBatch& batch, int flags)
+  {
+    batch._size = recvBatch(*this, batch, &batch._iov[0], batch._msgs,
+      &batch._peer[0], &batch._peerLen[0], &batch._length[0], &batch._truncated[0], flags);
+
+    // single sends answer the last peer like after recv of one datagram
+    if (batch._size > 0)
+    {
+      unsigned last = batch._size - 1;
+      memmove(&peeraddr, &batch._peer[last], batch._peerLen[last]);
+      peeraddrLen = batch._peerLen[last];
+    }
+
+    return batch._size;
+  }
+
+  unsigned UdpReceiver::send(const UdpBatch& batch, int flags) const
+  {
+    return sendBatch(*this, batch, &batch._iov[0], batch._msgs,
+      &batch._peer[0], &batch._peerLen[0], &peeraddr, peeraddrLen, flags);
+  }
+
 } // namespace net
 
 } // namespace cxxtools
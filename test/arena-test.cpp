@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/arena.h"
+#include "cxxtools/serializationinfo.h"
+#include "cxxtools/jsondeserializer.h"
+#include "cxxtools/bin/serializer.h"
+#include "cxxtools/bin/deserializer.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <sstream>
+#include <vector>
+
+class ArenaTest : public cxxtools::unit::TestSuite
+{
+    public:
+        ArenaTest()
+        : cxxtools::unit::TestSuite("arena")
+        {
+            registerMethod("testAllocate", *this, &ArenaTest::testAllocate);
+            registerMethod("testClear", *this, &ArenaTest::testClear);
+            registerMethod("testSerializationInfo", *this, &ArenaTest::testSerializationInfo);
+            registerMethod("testJsonDeserializer", *this, &ArenaTest::testJsonDeserializer);
+            registerMethod("testBinDeserializer", *this, &ArenaTest::testBinDeserializer);
+        }
+
+        void testAllocate()
+        {
+            cxxtools::Arena arena(256);
+
+            char* p1 = static_cast<char*>(arena.allocate(10, 1));
+            char* p2 = static_cast<char*>(arena.allocate(10, 1));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(p2 - p1, 10);
+
+            void* p3 = arena.allocate(8, 8);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reinterpret_cast<std::uintptr_t>(p3) % 8, 0u);
+
+            // larger than the block size
+            void* p4 = arena.allocate(1000);
+            CXXTOOLS_UNIT_ASSERT(p4 != 0);
+            CXXTOOLS_UNIT_ASSERT(arena.capacity() >= 1256u);
+        }
+
+        void testClear()
+        {
+            cxxtools::Arena arena(256);
+
+            void* p1 = arena.allocate(100);
+            arena.allocate(200);
+            std::size_t capacity = arena.capacity();
+
+            arena.clear();
+
+            void* p2 = arena.allocate(100);
+            arena.allocate(200);
+            CXXTOOLS_UNIT_ASSERT(p1 == p2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(arena.capacity(), capacity);
+
+            arena.release();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(arena.capacity(), 0u);
+        }
+
+        void testSerializationInfo()
+        {
+            cxxtools::Arena arena;
+
+            {
+                cxxtools::SerializationInfo si(&arena);
+                for (int n = 0; n < 100; ++n)
+                {
+                    cxxtools::SerializationInfo& m = si.addMember("m");
+                    m.addMember("a") <<= n;
+                    m.addMember("b") <<= "some long string value, which does not fit into the string object";
+                }
+
+                CXXTOOLS_UNIT_ASSERT(arena.capacity() > 0);
+                CXXTOOLS_UNIT_ASSERT(si.getMember(0u).arena() == &arena);
+
+                // copies use the heap
+                cxxtools::SerializationInfo si2(si);
+                CXXTOOLS_UNIT_ASSERT(si2.arena() == 0);
+                arena.allocate(1);
+                int v;
+                si2.getMember(42u).getMember("a") >>= v;
+                CXXTOOLS_UNIT_ASSERT_EQUALS(v, 42);
+            }
+
+            arena.clear();
+        }
+
+        void testJsonDeserializer()
+        {
+            cxxtools::Arena arena;
+            cxxtools::JsonDeserializer deserializer;
+            deserializer.setArena(&arena);
+
+            for (int n = 0; n < 3; ++n)
+            {
+                std::istringstream in("[ {\"a\": 1, \"b\": [2, 3]}, {\"a\": 4, \"b\": [5]} ]");
+                deserializer.read(in);
+
+                CXXTOOLS_UNIT_ASSERT_EQUALS(deserializer.si().memberCount(), 2u);
+
+                int a;
+                std::vector<int> b;
+                deserializer.si().getMember(1u).getMember("a") >>= a;
+                deserializer.si().getMember(0u).getMember("b") >>= b;
+                CXXTOOLS_UNIT_ASSERT_EQUALS(a, 4);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(b.size(), 2u);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(b[1], 3);
+            }
+        }
+
+        void testBinDeserializer()
+        {
+            std::vector<std::string> data;
+            data.push_back("foo");
+            data.push_back("a string, which is too long for small string optimization");
+
+            std::stringstream s;
+            cxxtools::bin::Serializer::serialize(s, data);
+
+            cxxtools::Arena arena;
+            cxxtools::bin::Deserializer deserializer;
+            deserializer.setArena(&arena);
+            deserializer.read(s);
+
+            std::vector<std::string> result;
+            deserializer.deserialize(result);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result[1], data[1]);
+        }
+};
+
+cxxtools::unit::RegisterTest<ArenaTest> register_ArenaTest;
@@ -89,6 +89,9 @@ class BinRpcTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &BinRpcTest::PrepareConnect);
             registerMethod("Connect", *this, &BinRpcTest::Connect);
             registerMethod("Multiple", *this, &BinRpcTest::Multiple);
+            registerMethod("PersistentDictionary", *this, &BinRpcTest::PersistentDictionary);
+            registerMethod("PersistentDictionaryDomain", *this, &BinRpcTest::PersistentDictionaryDomain);
+            registerMethod("ReusePort", *this, &BinRpcTest::ReusePort);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -804,6 +807,91 @@ class BinRpcTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // PersistentDictionary
+        //
+        void PersistentDictionary()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyColor);
+            _server->registerMethod("echoString", *this, &BinRpcTest::echoString);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            client.persistentDictionary(true);
+            cxxtools::RemoteProcedure< Color, Color, Color > multiply(client, "multiply");
+            cxxtools::RemoteProcedure<std::string, std::string> echo(client, "echoString");
+
+            Color a;
+            a.red = 2;
+            a.green = 3;
+            a.blue = 4;
+
+            for (int n = 1; n <= 5; ++n)
+            {
+                Color b;
+                b.red = n;
+                b.green = n + 1;
+                b.blue = n + 2;
+
+                multiply.begin(a, b);
+                Color r = multiply.end(2000);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.red, 2 * n);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.green, 3 * (n + 1));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.blue, 4 * (n + 2));
+
+                echo.begin("hello");
+                CXXTOOLS_UNIT_ASSERT_EQUALS(echo.end(2000), "hello");
+            }
+
+            // a new connection starts with a new dictionary
+            client.close();
+
+            multiply.begin(a, a);
+            Color r = multiply.end(2000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.red, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.green, 9);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.blue, 16);
+        }
+
+        void PersistentDictionaryDomain()
+        {
+            cxxtools::ServiceRegistry registry;
+            registry.registerMethod("multiply", *this, &BinRpcTest::multiplyInt);
+            _server->addService("myDomain", registry);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            client.domain("myDomain");
+            client.persistentDictionary(true);
+            cxxtools::RemoteProcedure<int, int, int> multiply(client, "multiply");
+
+            for (int n = 1; n <= 3; ++n)
+            {
+                multiply.begin(n, 3);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(multiply.end(2000), n * 3);
+            }
+        }
+
+
+        ////////////////////////////////////////////////////////////
+        // ReusePort
+        //
+        void ReusePort()
+        {
+            // add shared listeners on a second port to the fixture server
+            unsigned short port = _port + 1;
+            _server->minThreads(3);
+            _server->reusePort(true);
+            _server->listen(_listen, port);
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyInt);
+
+            for (int n = 1; n <= 5; ++n)
+            {
+                cxxtools::bin::RpcClient client(_loop, _listen, port);
+                cxxtools::RemoteProcedure<int, int, int> multiply(client, "multiply");
+                multiply.begin(n, 3);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(multiply.end(2000), n * 3);
+            }
+        }
+
 };
 
 cxxtools::unit::RegisterTest<BinRpcTest> register_BinRpcTest;
@@ -74,6 +74,19 @@ namespace
         si.setTypeName("TestObject");
     }
 
+    void formatValue(cxxtools::Formatter& formatter, const std::string& name, const TestObject& obj)
+    {
+        formatter.beginObject(name, "TestObject");
+        cxxtools::formatMember(formatter, "intValue", obj.intValue);
+        cxxtools::formatMember(formatter, "stringValue", obj.stringValue);
+        cxxtools::formatMember(formatter, "doubleValue", obj.doubleValue);
+        cxxtools::formatMember(formatter, "boolValue", obj.boolValue);
+        formatter.beginMember("nullValue");
+        formatter.addNull("nullValue", std::string());
+        formatter.finishMember();
+        formatter.finishObject();
+    }
+
     bool operator== (const TestObject& obj1, const TestObject& obj2)
     {
         return obj1.intValue == obj2.intValue
@@ -151,6 +164,9 @@ class BinSerializerTest : public cxxtools::unit::TestSuite
             registerMethod("testObject", *this, &BinSerializerTest::testObject);
             registerMethod("testComplexObject", *this, &BinSerializerTest::testComplexObject);
             registerMethod("testObjectVector", *this, &BinSerializerTest::testObjectVector);
+            registerMethod("testFormatValue", *this, &BinSerializerTest::testFormatValue);
+            registerMethod("testStream", *this, &BinSerializerTest::testStream);
+            registerMethod("testManyNames", *this, &BinSerializerTest::testManyNames);
             registerMethod("testBinaryData", *this, &BinSerializerTest::testBinaryData);
             registerMethod("testReuse", *this, &BinSerializerTest::testReuse);
             registerMethod("testNamedVector", *this, &BinSerializerTest::testNamedVector);
@@ -431,6 +447,106 @@ class BinSerializerTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT(obj == obj2);
         }
 
+        void testFormatValue()
+        {
+            std::vector<TestObject> obj;
+            obj.resize(2);
+            obj[0].intValue = 17;
+            obj[0].stringValue = "foobar";
+            obj[0].doubleValue = 3.125;
+            obj[0].boolValue = true;
+            obj[1].intValue = 18;
+            obj[1].stringValue = "hi there";
+            obj[1].doubleValue = -17.25;
+            obj[1].boolValue = false;
+
+            cxxtools::SerializationInfo si;
+            si <<= obj;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toBin(obj), toBin(si));
+
+            std::vector<TestObject2> obj2;
+            obj2.resize(1);
+            obj2[0].intValue = 19;
+            obj2[0].setValue.insert(4);
+            obj2[0].mapValue[5] = "five";
+
+            si.clear();
+            si <<= obj2;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toBin(obj2), toBin(si));
+
+            std::string data = toBin(obj);
+            std::vector<TestObject> result = fromBin<std::vector<TestObject>>(data);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result[0].stringValue, "foobar");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result[1].intValue, 18);
+            CXXTOOLS_UNIT_ASSERT(result[1].nullValue);
+        }
+
+        void testStream()
+        {
+            std::vector<TestObject> obj(3);
+            for (unsigned n = 0; n < obj.size(); ++n)
+            {
+                obj[n].intValue = n;
+                obj[n].stringValue = "obj" + std::to_string(n);
+                obj[n].doubleValue = n + 0.5;
+                obj[n].boolValue = n & 1;
+                obj[n].nullValue = true;
+            }
+
+            std::stringstream data;
+            data << cxxtools::bin::Bin(obj);
+
+            cxxtools::bin::Deserializer deserializer;
+            deserializer.beginStream(data);
+
+            TestObject result;
+            for (unsigned n = 0; n < obj.size(); ++n)
+            {
+                CXXTOOLS_UNIT_ASSERT(deserializer.next(result));
+                CXXTOOLS_UNIT_ASSERT(result == obj[n]);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(deserializer.si().memberCount(), 1u);
+            }
+
+            CXXTOOLS_UNIT_ASSERT(!deserializer.next(result));
+
+            std::stringstream truncated(data.str().substr(0, data.str().size() - 10));
+            deserializer.beginStream(truncated);
+            CXXTOOLS_UNIT_ASSERT(deserializer.next(result));
+            CXXTOOLS_UNIT_ASSERT(deserializer.next(result));
+            CXXTOOLS_UNIT_ASSERT_THROW(deserializer.next(result), cxxtools::SerializationError);
+        }
+
+        void testManyNames()
+        {
+            // more names than fit into the dictionary
+            cxxtools::SerializationInfo si;
+            for (unsigned n = 0; n < 2; ++n)
+            {
+                cxxtools::SerializationInfo& obj = si.addMember();
+                for (unsigned m = 0; m < 70000; ++m)
+                    obj.addMember("m" + std::to_string(m)) <<= m;
+            }
+
+            si.setCategory(cxxtools::SerializationInfo::Array);
+
+            std::string data = toBin(si);
+            cxxtools::SerializationInfo result = fromBin<cxxtools::SerializationInfo>(data);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(result.memberCount(), 2u);
+            for (unsigned n = 0; n < 2; ++n)
+            {
+                const cxxtools::SerializationInfo& obj = result.getMember(n);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(obj.memberCount(), 70000u);
+                for (unsigned m = 0; m < 70000; m += 999)
+                {
+                    unsigned v = 0;
+                    obj.getMember("m" + std::to_string(m)) >>= v;
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(v, m);
+                }
+            }
+        }
+
         void testBinaryData()
         {
             std::stringstream data;
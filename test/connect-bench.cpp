@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Load generator measuring how many connections per second the http server
+ * accepts, with a single listener and with one SO_REUSEPORT listener per
+ * accepting thread.
+ *
+ * Each client thread connects, sends a GET request with "Connection: close",
+ * reads the reply until the server closes the connection and starts over.
+ */
+
+#include <cxxtools/http/server.h>
+#include <cxxtools/http/responder.h>
+#include <cxxtools/http/service.h>
+#include <cxxtools/http/request.h>
+#include <cxxtools/http/reply.h>
+#include <cxxtools/net/tcpsocket.h>
+#include <cxxtools/eventloop.h>
+#include <cxxtools/iostream.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    class HelloResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit HelloResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream& out, cxxtools::http::Request&, cxxtools::http::Reply& reply)
+            {
+                reply.setHeader("Content-Type", "text/plain");
+                out << "hello";
+            }
+    };
+
+    struct Config
+    {
+        std::string ip;
+        unsigned short port;
+        unsigned clients;
+        unsigned acceptors;
+        cxxtools::Milliseconds duration;
+    };
+
+    void runClient(const Config& config, std::atomic<bool>& stop,
+        std::atomic<unsigned>& connections, std::atomic<unsigned>& errors)
+    {
+        while (!stop)
+        {
+            try
+            {
+                cxxtools::net::TcpSocket socket(config.ip, config.port);
+                cxxtools::IOStream stream(socket);
+                stream << "GET / HTTP/1.1\r\n"
+                          "Host: " << config.ip << "\r\n"
+                          "Connection: close\r\n\r\n" << std::flush;
+
+                char ch;
+                while (stream.get(ch))
+                    ;
+
+                ++connections;
+            }
+            catch (const std::exception&)
+            {
+                ++errors;
+            }
+        }
+    }
+
+    // returns connections per second
+    double measure(const Config& config, cxxtools::http::Server::ThreadingMode mode, bool reusePort)
+    {
+        cxxtools::EventLoop loop;
+        cxxtools::http::CachedService<HelloResponder> service;
+
+        cxxtools::http::Server server(loop, mode);
+        server.minThreads(config.acceptors);
+        server.ioThreads(config.acceptors);
+        server.reusePort(reusePort);
+        server.listen(config.ip, config.port);
+        server.addService("/", service);
+
+        std::thread serverThread(&cxxtools::EventLoop::run, &loop);
+
+        std::atomic<bool> stop(false);
+        std::atomic<unsigned> connections(0);
+        std::atomic<unsigned> errors(0);
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        std::vector<std::thread> clients;
+        for (unsigned n = 0; n < config.clients; ++n)
+            clients.push_back(std::thread(runClient, std::cref(config),
+                std::ref(stop), std::ref(connections), std::ref(errors)));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long>(config.duration.totalMSecs())));
+        stop = true;
+
+        for (unsigned n = 0; n < clients.size(); ++n)
+            clients[n].join();
+
+        cxxtools::Timespan t = clock.stop();
+
+        loop.exit();
+        serverThread.join();
+
+        if (errors > 0)
+            std::cerr << errors << " connections failed" << std::endl;
+
+        return connections / t.totalSeconds();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        Config config;
+        config.ip = cxxtools::Arg<std::string>(argc, argv, 'i', "127.0.0.1").getValue();
+        config.port = cxxtools::Arg<unsigned short>(argc, argv, 'p', 8002);
+        config.clients = cxxtools::Arg<unsigned>(argc, argv, 'c', 16);
+        config.acceptors = cxxtools::Arg<unsigned>(argc, argv, 'a', 4);
+        config.duration = cxxtools::Seconds(cxxtools::Arg<double>(argc, argv, 's', 2));
+
+        std::cout << "benchmark http server connections per second\n\n"
+                     "options:\n"
+                     "   -i <ip>           ip address to listen on (default: 127.0.0.1)\n"
+                     "   -p <port>         port to listen on (default: 8002)\n"
+                     "   -c <number>       number of client threads (default: 16)\n"
+                     "   -a <number>       number of accepting threads and listeners with reuse port (default: 4)\n"
+                     "   -s <seconds>      duration of each measurement (default: 2)\n" << std::endl;
+
+        std::cout << std::setw(16) << "mode"
+                  << std::setw(20) << "single [conn/s]"
+                  << std::setw(20) << "reuseport [conn/s]" << std::endl;
+
+        double w1 = measure(config, cxxtools::http::Server::WorkerThreads, false);
+        double w2 = measure(config, cxxtools::http::Server::WorkerThreads, true);
+        std::cout << std::setw(16) << "worker threads"
+                  << std::setw(20) << std::fixed << std::setprecision(0) << w1
+                  << std::setw(20) << w2 << std::endl;
+
+        double e1 = measure(config, cxxtools::http::Server::EventLoops, false);
+        double e2 = measure(config, cxxtools::http::Server::EventLoops, true);
+        std::cout << std::setw(16) << "event loops"
+                  << std::setw(20) << e1
+                  << std::setw(20) << e2 << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the cost of passing events between threads through the event
+ * queue of cxxtools::EventLoop.
+ *
+ * In the ping pong test two event loops run in their own threads and send
+ * an event back and forth. In the producer test multiple threads commit
+ * events to a single event loop as fast as possible.
+ */
+
+#include <cxxtools/eventloop.h>
+#include <cxxtools/event.h>
+#include <cxxtools/connectable.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    class PingEvent : public cxxtools::BasicEvent<PingEvent>
+    {
+        public:
+            explicit PingEvent(unsigned n_)
+                : n(n_)
+                { }
+
+            unsigned n;
+    };
+
+    class PongEvent : public cxxtools::BasicEvent<PongEvent>
+    {
+        public:
+            explicit PongEvent(unsigned n_)
+                : n(n_)
+                { }
+
+            unsigned n;
+    };
+
+    class CountEvent : public cxxtools::BasicEvent<CountEvent>
+    { };
+
+    class PingPong : public cxxtools::Connectable
+    {
+            cxxtools::EventLoop _pingLoop;
+            cxxtools::EventLoop _pongLoop;
+            unsigned _rounds;
+
+            void onPing(const PingEvent& ev)
+            {
+                _pingLoop.commitEvent(PongEvent(ev.n));
+            }
+
+            void onPong(const PongEvent& ev)
+            {
+                if (ev.n < _rounds)
+                {
+                    _pongLoop.commitEvent(PingEvent(ev.n + 1));
+                }
+                else
+                {
+                    _pingLoop.exit();
+                    _pongLoop.exit();
+                }
+            }
+
+        public:
+            explicit PingPong(unsigned rounds)
+                : _rounds(rounds)
+            {
+                _pongLoop.event.subscribe(cxxtools::slot(*this, &PingPong::onPing));
+                _pingLoop.event.subscribe(cxxtools::slot(*this, &PingPong::onPong));
+            }
+
+            // returns round trips per second
+            double run()
+            {
+                cxxtools::Clock clock;
+                clock.start();
+
+                std::thread pongThread(&cxxtools::EventLoop::run, &_pongLoop);
+                _pongLoop.commitEvent(PingEvent(1));
+                _pingLoop.run();
+                pongThread.join();
+
+                return _rounds / clock.stop().totalSeconds();
+            }
+    };
+
+    class Producers : public cxxtools::Connectable
+    {
+            cxxtools::EventLoop _loop;
+            unsigned _threads;
+            unsigned _events;
+            unsigned long _count;
+
+            void onCount(const CountEvent&)
+            {
+                if (++_count == static_cast<unsigned long>(_threads) * _events)
+                    _loop.exit();
+            }
+
+            void produce()
+            {
+                for (unsigned n = 0; n < _events; ++n)
+                    _loop.commitEvent(CountEvent());
+            }
+
+        public:
+            Producers(unsigned threads, unsigned events)
+                : _threads(threads),
+                  _events(events),
+                  _count(0)
+            {
+                _loop.event.subscribe(cxxtools::slot(*this, &Producers::onCount));
+            }
+
+            // returns events per second
+            double run()
+            {
+                cxxtools::Clock clock;
+                clock.start();
+
+                std::vector<std::thread> producers;
+                for (unsigned n = 0; n < _threads; ++n)
+                    producers.push_back(std::thread(&Producers::produce, this));
+
+                _loop.run();
+
+                for (unsigned n = 0; n < producers.size(); ++n)
+                    producers[n].join();
+
+                return _count / clock.stop().totalSeconds();
+            }
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        unsigned rounds = cxxtools::Arg<unsigned>(argc, argv, 'n', 100000);
+        unsigned threads = cxxtools::Arg<unsigned>(argc, argv, 't', 4);
+        unsigned events = cxxtools::Arg<unsigned>(argc, argv, 'e', 250000);
+
+        std::cout << "benchmark event queue of the event loop\n\n"
+                     "options:\n"
+                     "   -n <number>       number of ping pong round trips (default: 100000)\n"
+                     "   -t <number>       number of producer threads (default: 4)\n"
+                     "   -e <number>       number of events per producer thread (default: 250000)\n" << std::endl;
+
+        double pingPong = PingPong(rounds).run();
+        std::cout << "ping pong: " << std::fixed << std::setprecision(0) << pingPong << " round trips/s ("
+                  << std::setprecision(2) << 1e6 / pingPong << " us per round trip)" << std::endl;
+
+        double produced = Producers(threads, events).run();
+        std::cout << threads << " producers: " << std::setprecision(0) << produced << " events/s" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
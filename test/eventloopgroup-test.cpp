@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/eventloopgroup.h"
+#include "cxxtools/eventloop.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+class EventLoopGroupTest : public cxxtools::unit::TestSuite
+{
+public:
+    EventLoopGroupTest()
+    : cxxtools::unit::TestSuite("eventloopgroup")
+    {
+        registerMethod("post", *this, &EventLoopGroupTest::post);
+        registerMethod("execute", *this, &EventLoopGroupTest::execute);
+        registerMethod("executeException", *this, &EventLoopGroupTest::executeException);
+        registerMethod("stop", *this, &EventLoopGroupTest::stop);
+        registerMethod("roundRobin", *this, &EventLoopGroupTest::roundRobin);
+        registerMethod("leastLoaded", *this, &EventLoopGroupTest::leastLoaded);
+    }
+
+    void post()
+    {
+        cxxtools::EventLoopGroup group(2);
+        group.start();
+
+        std::thread::id ids[2];
+        for (unsigned n = 0; n < 2; ++n)
+            group.post(group.loop(n), [&ids, n] { ids[n] = std::this_thread::get_id(); });
+
+        group.stop();
+
+        CXXTOOLS_UNIT_ASSERT(ids[0] != std::thread::id());
+        CXXTOOLS_UNIT_ASSERT(ids[1] != std::thread::id());
+        CXXTOOLS_UNIT_ASSERT(ids[0] != ids[1]);
+        CXXTOOLS_UNIT_ASSERT(ids[0] != std::this_thread::get_id());
+    }
+
+    void execute()
+    {
+        cxxtools::EventLoopGroup group(2);
+        group.start();
+
+        std::thread::id id;
+        group.execute(1, [&id] { id = std::this_thread::get_id(); });
+        CXXTOOLS_UNIT_ASSERT(id != std::thread::id());
+        CXXTOOLS_UNIT_ASSERT(id != std::this_thread::get_id());
+
+        // called directly when not running
+        group.stop();
+        group.execute(1, [&id] { id = std::this_thread::get_id(); });
+        CXXTOOLS_UNIT_ASSERT(id == std::this_thread::get_id());
+    }
+
+    void executeException()
+    {
+        cxxtools::EventLoopGroup group(1);
+        group.start();
+
+        CXXTOOLS_UNIT_ASSERT_THROW(group.execute(0, [] { throw std::runtime_error("fail"); }), std::runtime_error);
+
+        // the loop is still running
+        unsigned count = 0;
+        group.execute(0, [&count] { ++count; });
+        CXXTOOLS_UNIT_ASSERT_EQUALS(count, 1u);
+    }
+
+    void stop()
+    {
+        cxxtools::EventLoopGroup group(2);
+        group.start();
+
+        std::atomic<unsigned> count(0);
+        for (unsigned n = 0; n < 1000; ++n)
+            group.post(n % 2, [&count] { ++count; });
+
+        group.stop();
+        CXXTOOLS_UNIT_ASSERT(!group.running());
+        CXXTOOLS_UNIT_ASSERT_EQUALS(count.load(), 1000u);
+    }
+
+    void roundRobin()
+    {
+        cxxtools::EventLoopGroup group(3);
+        group.assignment(cxxtools::EventLoopGroup::RoundRobin);
+
+        group.assign(0);
+        group.assign(0);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(group.assign(), 0u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(group.assign(), 1u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(group.assign(), 2u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(group.assign(), 0u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(group.load(0), 4u);
+    }
+
+    void leastLoaded()
+    {
+        cxxtools::EventLoopGroup group(3);
+
+        group.assign(0);
+        group.assign(0);
+        group.assign(1);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(group.assign(), 2u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(group.load(2), 1u);
+
+        group.release(0);
+        group.release(0);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(group.assign(), 0u);
+    }
+};
+
+cxxtools::unit::RegisterTest<EventLoopGroupTest> register_EventLoopGroupTest;
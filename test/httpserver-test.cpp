@@ -0,0 +1,728 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/http/server.h"
+#include "cxxtools/http/client.h"
+#include "cxxtools/http/clientpool.h"
+#include "cxxtools/http/fileservice.h"
+#include "cxxtools/http/request.h"
+#include "cxxtools/http/reply.h"
+#include "cxxtools/http/responder.h"
+#include "cxxtools/http/service.h"
+#include "cxxtools/eventloop.h"
+#include "cxxtools/eventloopgroup.h"
+#include "cxxtools/regex.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fstream>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // replies with the request body or with "hello" if there is none
+    class EchoResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit EchoResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream& out, cxxtools::http::Request& request, cxxtools::http::Reply& reply)
+            {
+                reply.setHeader("Content-Type", "text/plain");
+                std::string body = request.bodyStr();
+                out << (body.empty() ? std::string("hello") : body);
+            }
+    };
+
+    std::string streamData(std::size_t size)
+    {
+        std::string data;
+        for (unsigned n = 0; data.size() < size; ++n)
+            data += static_cast<char>('a' + n % 26);
+        return data;
+    }
+
+    // sends a large body with Reply::beginStream; "/stream" uses chunked
+    // encoding and "/streamlength" sets the content length
+    class StreamResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit StreamResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream&, cxxtools::http::Request& request, cxxtools::http::Reply& reply)
+            {
+                std::string part = streamData(1000);
+                std::size_t size = 5000 * part.size();
+
+                reply.setHeader("Content-Type", "text/plain");
+                if (request.url() == "/streamlength")
+                {
+                    std::ostringstream l;
+                    l << size;
+                    reply.setHeader("Content-Length", l.str().c_str());
+                }
+
+                std::ostream& out = reply.beginStream();
+                for (std::size_t n = 0; n < size; n += part.size())
+                {
+                    // mix small and large writes
+                    if (n % 3 == 0)
+                        out.write(part.data(), part.size());
+                    else
+                        for (unsigned i = 0; i < part.size(); ++i)
+                            out << part[i];
+                }
+            }
+    };
+}
+
+class HttpServerTest : public cxxtools::unit::TestSuite
+{
+    private:
+        cxxtools::EventLoop _loop;
+        std::unique_ptr<cxxtools::http::Server> _server;
+        cxxtools::http::CachedService<EchoResponder> _service;
+        cxxtools::http::CachedService<StreamResponder> _streamService;
+        std::unique_ptr<cxxtools::http::FileService> _fileService;
+        std::unique_ptr<cxxtools::EventLoopGroup> _group;
+        std::string _documentRoot;
+        std::thread _thread;
+        std::string _listen;
+        unsigned short _port;
+        std::size_t _maxRequestBodySize;
+
+    public:
+        HttpServerTest()
+        : cxxtools::unit::TestSuite("httpserver"),
+          _listen("127.0.0.1"),
+          _port(8001),
+          _maxRequestBodySize(0)
+        {
+            registerMethod("WorkerThreadsGet", *this, &HttpServerTest::WorkerThreadsGet);
+            registerMethod("EventLoopsGet", *this, &HttpServerTest::EventLoopsGet);
+            registerMethod("EventLoopsPost", *this, &HttpServerTest::EventLoopsPost);
+            registerMethod("EventLoopsBodyTooLarge", *this, &HttpServerTest::EventLoopsBodyTooLarge);
+            registerMethod("EventLoopsNotFound", *this, &HttpServerTest::EventLoopsNotFound);
+            registerMethod("EventLoopsKeepAlive", *this, &HttpServerTest::EventLoopsKeepAlive);
+            registerMethod("EventLoopsManyClients", *this, &HttpServerTest::EventLoopsManyClients);
+            registerMethod("WorkerThreadsReusePort", *this, &HttpServerTest::WorkerThreadsReusePort);
+            registerMethod("EventLoopsReusePort", *this, &HttpServerTest::EventLoopsReusePort);
+            registerMethod("WorkerThreadsLargeReply", *this, &HttpServerTest::WorkerThreadsLargeReply);
+            registerMethod("EventLoopsLargeReply", *this, &HttpServerTest::EventLoopsLargeReply);
+            registerMethod("WorkerThreadsFile", *this, &HttpServerTest::WorkerThreadsFile);
+            registerMethod("EventLoopsFile", *this, &HttpServerTest::EventLoopsFile);
+            registerMethod("WorkerThreadsStream", *this, &HttpServerTest::WorkerThreadsStream);
+            registerMethod("EventLoopsStream", *this, &HttpServerTest::EventLoopsStream);
+            registerMethod("WorkerThreadsPipelining", *this, &HttpServerTest::WorkerThreadsPipelining);
+            registerMethod("EventLoopsPipelining", *this, &HttpServerTest::EventLoopsPipelining);
+            registerMethod("EventLoopsClientPool", *this, &HttpServerTest::EventLoopsClientPool);
+            registerMethod("EventLoopsSharedGroup", *this, &HttpServerTest::EventLoopsSharedGroup);
+            registerMethod("EventLoopsTerminateSendsReply", *this, &HttpServerTest::EventLoopsTerminateSendsReply);
+            registerMethod("EventLoopsTerminateClosingReplies", *this, &HttpServerTest::EventLoopsTerminateClosingReplies);
+
+            char* PORT = getenv("UTEST_PORT");
+            if (PORT)
+            {
+                std::istringstream s(PORT);
+                s >> _port;
+            }
+
+            char* LISTEN = getenv("UTEST_LISTEN");
+            if (LISTEN)
+                _listen = LISTEN;
+        }
+
+        void startServer(cxxtools::http::Server::ThreadingMode mode, bool reusePort = false)
+        {
+            _server.reset(new cxxtools::http::Server(_loop, mode));
+            _server->minThreads(reusePort ? 2 : 1);
+            _server->ioThreads(2);
+            _server->reusePort(reusePort);
+            if (_maxRequestBodySize)
+                _server->maxRequestBodySize(_maxRequestBodySize);
+            if (_group)
+                _server->eventLoopGroup(*_group);
+            _server->listen(_listen, _port);
+            _server->addService("/echo", _service);
+            _server->addService("/stream", _streamService);
+            _server->addService("/streamlength", _streamService);
+            if (_fileService)
+                _server->addService(cxxtools::Regex("^/files/"), *_fileService);
+            _thread = std::thread(&cxxtools::EventLoop::run, &_loop);
+        }
+
+        void tearDown()
+        {
+            if (_thread.joinable())
+            {
+                _loop.exit();
+                _thread.join();
+            }
+
+            _server.reset();
+            _group.reset();
+            _maxRequestBodySize = 0;
+
+            if (_fileService)
+            {
+                _fileService.reset();
+                ::unlink((_documentRoot + "/data.txt").c_str());
+                ::rmdir(_documentRoot.c_str());
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // WorkerThreadsGet
+        //
+        void WorkerThreadsGet()
+        {
+            startServer(cxxtools::http::Server::WorkerThreads);
+
+            cxxtools::http::Client client(_listen, _port);
+            const cxxtools::http::Reply& reply = client.get("/echo", cxxtools::Seconds(5));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body(), "hello");
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsGet
+        //
+        void EventLoopsGet()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+
+            cxxtools::http::Client client(_listen, _port);
+            const cxxtools::http::Reply& reply = client.get("/echo", cxxtools::Seconds(5));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body(), "hello");
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsSharedGroup
+        //
+        void EventLoopsSharedGroup()
+        {
+            _group.reset(new cxxtools::EventLoopGroup(2));
+            startServer(cxxtools::http::Server::EventLoops);
+
+            {
+                // a second server on the same loops
+                cxxtools::EventLoop loop;
+                cxxtools::http::Server server(loop, cxxtools::http::Server::EventLoops);
+                server.eventLoopGroup(*_group);
+                server.minThreads(1);
+                server.listen(_listen, _port + 1);
+                server.addService("/echo", _service);
+                std::thread thread(&cxxtools::EventLoop::run, &loop);
+
+                cxxtools::http::Client client(_listen, _port + 1);
+                const cxxtools::http::Reply& reply = client.get("/echo", cxxtools::Seconds(5));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body(), "hello");
+
+                // terminates the server and closes its connection
+                loop.exit();
+                thread.join();
+            }
+
+            CXXTOOLS_UNIT_ASSERT(_group->running());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_group->load(0) + _group->load(1), 0u);
+
+            cxxtools::http::Client client(_listen, _port);
+            const cxxtools::http::Reply& reply = client.get("/echo", cxxtools::Seconds(5));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body(), "hello");
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsTerminateSendsReply
+        //
+        void EventLoopsTerminateSendsReply()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+
+            // much larger than the socket buffers, so the reply is still
+            // being sent when the server terminates
+            std::string body;
+            for (unsigned n = 0; body.size() < 10000000; ++n)
+                body += static_cast<char>('a' + n % 26);
+
+            cxxtools::http::Client client(_listen, _port);
+            cxxtools::http::Request request("/echo");
+            request.method("POST");
+            request.body() << body;
+            client.execute(request, cxxtools::Seconds(10));
+
+            // terminates the server while we read the body
+            _loop.exit();
+
+            const cxxtools::http::Reply& reply = client.readBody();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body().size(), body.size());
+
+            _thread.join();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsTerminateClosingReplies
+        //
+        void EventLoopsTerminateClosingReplies()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+
+            std::string body;
+            for (unsigned n = 0; body.size() < 2000000; ++n)
+                body += static_cast<char>('a' + n % 26);
+
+            // the server closes each connection, when its reply is sent,
+            // while it terminates
+            std::vector<std::unique_ptr<cxxtools::http::Client>> clients;
+            for (unsigned n = 0; n < 4; ++n)
+            {
+                clients.emplace_back(new cxxtools::http::Client(_listen, _port));
+                cxxtools::http::Request request("/echo");
+                request.method("POST");
+                request.header().setHeader("Connection", "close");
+                request.body() << body;
+                clients.back()->execute(request, cxxtools::Seconds(10));
+            }
+
+            _loop.exit();
+
+            for (unsigned n = 0; n < clients.size(); ++n)
+            {
+                const cxxtools::http::Reply& reply = clients[n]->readBody();
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body().size(), body.size());
+            }
+
+            _thread.join();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsPost
+        //
+        void EventLoopsPost()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+
+            // larger than the stream buffer, so the body arrives in pieces
+            std::string body;
+            for (unsigned n = 0; body.size() < 100000; ++n)
+                body += static_cast<char>('a' + n % 26);
+
+            cxxtools::http::Client client(_listen, _port);
+            cxxtools::http::Request request("/echo");
+            request.method("POST");
+            request.body() << body;
+            client.execute(request, cxxtools::Seconds(5));
+            const cxxtools::http::Reply& reply = client.readBody();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body().size(), body.size());
+            CXXTOOLS_UNIT_ASSERT(reply.body() == body);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsBodyTooLarge
+        //
+        void EventLoopsBodyTooLarge()
+        {
+            _maxRequestBodySize = 1000;
+            startServer(cxxtools::http::Server::EventLoops);
+
+            cxxtools::http::Client client(_listen, _port);
+            cxxtools::http::Request request("/echo");
+            request.method("POST");
+            request.body() << std::string(1000, 'a');
+            client.execute(request, cxxtools::Seconds(5));
+            const cxxtools::http::Reply& reply = client.readBody();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body().size(), 1000u);
+
+            cxxtools::http::Client client2(_listen, _port);
+            request.body() << 'a';
+            client2.execute(request, cxxtools::Seconds(5));
+            const cxxtools::http::Reply& reply2 = client2.readBody();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply2.httpReturnCode(), 413u);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsNotFound
+        //
+        void EventLoopsNotFound()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+
+            cxxtools::http::Client client(_listen, _port);
+            const cxxtools::http::Reply& reply = client.get("/unknown", cxxtools::Seconds(5));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 404u);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsKeepAlive
+        //
+        void EventLoopsKeepAlive()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+
+            cxxtools::http::Client client(_listen, _port);
+            for (unsigned n = 0; n < 10; ++n)
+            {
+                std::ostringstream body;
+                body << "request " << n;
+
+                cxxtools::http::Request request("/echo");
+                request.method("POST");
+                request.body() << body.str();
+                client.execute(request, cxxtools::Seconds(5));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(client.readBody().body(), body.str());
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsManyClients
+        //
+        void EventLoopsManyClients()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+
+            // keep all connections open and interleave the requests
+            std::vector<std::unique_ptr<cxxtools::http::Client>> clients;
+            for (unsigned n = 0; n < 100; ++n)
+                clients.emplace_back(new cxxtools::http::Client(_listen, _port));
+
+            for (unsigned r = 0; r < 3; ++r)
+            {
+                for (unsigned n = 0; n < clients.size(); ++n)
+                {
+                    std::ostringstream body;
+                    body << "client " << n << " request " << r;
+
+                    cxxtools::http::Request request("/echo");
+                    request.method("POST");
+                    request.body() << body.str();
+                    clients[n]->execute(request, cxxtools::Seconds(5));
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(clients[n]->readBody().body(), body.str());
+                }
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // WorkerThreadsReusePort
+        //
+        void WorkerThreadsReusePort()
+        {
+            startServer(cxxtools::http::Server::WorkerThreads, true);
+            requestNewConnections();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsReusePort
+        //
+        void EventLoopsReusePort()
+        {
+            startServer(cxxtools::http::Server::EventLoops, true);
+            requestNewConnections();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // WorkerThreadsLargeReply
+        //
+        void WorkerThreadsLargeReply()
+        {
+            startServer(cxxtools::http::Server::WorkerThreads);
+            requestLargeReplies();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsLargeReply
+        //
+        void EventLoopsLargeReply()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+            requestLargeReplies();
+        }
+
+        void requestLargeReplies()
+        {
+            // the reply body is much larger than the socket buffer, so it
+            // is sent in several writes
+            std::string body;
+            for (unsigned n = 0; body.size() < 1000000; ++n)
+                body += static_cast<char>('a' + n % 26);
+
+            cxxtools::http::Client client(_listen, _port);
+            for (unsigned n = 0; n < 2; ++n)
+            {
+                cxxtools::http::Request request("/echo");
+                request.method("POST");
+                request.body() << body;
+                client.execute(request, cxxtools::Seconds(10));
+                const cxxtools::http::Reply& reply = client.readBody();
+
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body().size(), body.size());
+                CXXTOOLS_UNIT_ASSERT(reply.body() == body);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // WorkerThreadsFile
+        //
+        void WorkerThreadsFile()
+        {
+            std::string content = createDocumentRoot();
+            startServer(cxxtools::http::Server::WorkerThreads);
+            requestFiles(content);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsFile
+        //
+        void EventLoopsFile()
+        {
+            std::string content = createDocumentRoot();
+            startServer(cxxtools::http::Server::EventLoops);
+            requestFiles(content);
+        }
+
+        std::string createDocumentRoot()
+        {
+            char dir[] = "/tmp/cxxtools-httpserver-XXXXXX";
+            CXXTOOLS_UNIT_ASSERT(mkdtemp(dir) != 0);
+            _documentRoot = dir;
+            _fileService.reset(new cxxtools::http::FileService(_documentRoot, "/files"));
+
+            std::string content;
+            for (unsigned n = 0; content.size() < 1000000; ++n)
+                content += static_cast<char>('a' + n % 26);
+
+            std::ofstream f((_documentRoot + "/data.txt").c_str());
+            f << content;
+            f.close();
+
+            return content;
+        }
+
+        void requestFiles(const std::string& content)
+        {
+            // all requests use the same connection, so that the file body
+            // must be followed correctly by the next reply
+            cxxtools::http::Client client(_listen, _port);
+
+            const cxxtools::http::Reply& reply = client.get("/files/data.txt", cxxtools::Seconds(10));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body().size(), content.size());
+            CXXTOOLS_UNIT_ASSERT(reply.body() == content);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(reply.getHeader("Content-Type")), "text/plain");
+            CXXTOOLS_UNIT_ASSERT(reply.hasHeader("Last-Modified"));
+            std::string lastModified = reply.getHeader("Last-Modified");
+
+            cxxtools::http::Request request("/files/data.txt");
+            request.setHeader("Range", "bytes=10-19");
+            client.execute(request, cxxtools::Seconds(5));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.readBody().httpReturnCode(), 206u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.body(), content.substr(10, 10));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(client.header().getHeader("Content-Range")), "bytes 10-19/1000000");
+
+            request.setHeader("Range", "bytes=-5");
+            client.execute(request, cxxtools::Seconds(5));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.readBody().httpReturnCode(), 206u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.body(), content.substr(content.size() - 5));
+
+            request.setHeader("Range", "bytes=2000000-");
+            client.execute(request, cxxtools::Seconds(5));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.readBody().httpReturnCode(), 416u);
+
+            request.removeHeader("Range");
+            request.setHeader("If-Modified-Since", lastModified.c_str());
+            client.execute(request, cxxtools::Seconds(5));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.readBody().httpReturnCode(), 304u);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/files/../data.txt", cxxtools::Seconds(5)).httpReturnCode(), 404u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/files/missing.txt", cxxtools::Seconds(5)).httpReturnCode(), 404u);
+
+            const cxxtools::http::Reply& again = client.get("/files/data.txt", cxxtools::Seconds(10));
+            CXXTOOLS_UNIT_ASSERT(again.body() == content);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // WorkerThreadsStream
+        //
+        void WorkerThreadsStream()
+        {
+            startServer(cxxtools::http::Server::WorkerThreads);
+            requestStreams();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsStream
+        //
+        void EventLoopsStream()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+            requestStreams();
+        }
+
+        void requestStreams()
+        {
+            std::string part = streamData(1000);
+            std::string body;
+            for (unsigned n = 0; n < 5000; ++n)
+                body += part;
+
+            cxxtools::http::Client client(_listen, _port);
+
+            const cxxtools::http::Reply& reply = client.get("/stream", cxxtools::Seconds(20));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT(reply.header().chunkedTransferEncoding());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body().size(), body.size());
+            CXXTOOLS_UNIT_ASSERT(reply.body() == body);
+
+            const cxxtools::http::Reply& reply2 = client.get("/streamlength", cxxtools::Seconds(20));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply2.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT(!reply2.header().chunkedTransferEncoding());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply2.body().size(), body.size());
+            CXXTOOLS_UNIT_ASSERT(reply2.body() == body);
+
+            // the connection is kept alive after a streamed reply
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/echo", cxxtools::Seconds(5)).body(), "hello");
+        }
+
+        ////////////////////////////////////////////////////////////
+        // WorkerThreadsPipelining
+        //
+        void WorkerThreadsPipelining()
+        {
+            startServer(cxxtools::http::Server::WorkerThreads);
+            requestPipelined();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsPipelining
+        //
+        void EventLoopsPipelining()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+            requestPipelined();
+        }
+
+        void requestPipelined()
+        {
+            cxxtools::http::Client client(_listen, _port);
+
+            for (unsigned r = 0; r < 2; ++r)
+            {
+                for (unsigned n = 0; n < 5; ++n)
+                {
+                    std::ostringstream body;
+                    body << "request " << r << '.' << n;
+
+                    cxxtools::http::Request request("/echo");
+                    request.method("POST");
+                    request.body() << body.str();
+                    client.sendRequest(request, cxxtools::Seconds(5));
+                }
+
+                CXXTOOLS_UNIT_ASSERT_EQUALS(client.pendingReplies(), 5u);
+
+                for (unsigned n = 0; n < 5; ++n)
+                {
+                    std::ostringstream body;
+                    body << "request " << r << '.' << n;
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(client.readReply(cxxtools::Seconds(5)).body(), body.str());
+                }
+
+                CXXTOOLS_UNIT_ASSERT_EQUALS(client.pendingReplies(), 0u);
+            }
+
+            // a normal request on the same connection
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/echo", cxxtools::Seconds(5)).body(), "hello");
+        }
+
+        ////////////////////////////////////////////////////////////
+        // EventLoopsClientPool
+        //
+        void EventLoopsClientPool()
+        {
+            startServer(cxxtools::http::Server::EventLoops);
+
+            cxxtools::http::ClientPool pool(2);
+            std::atomic<unsigned> ok(0);
+
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < 4; ++t)
+                threads.emplace_back([this, &pool, &ok, t]() {
+                    for (unsigned n = 0; n < 10; ++n)
+                    {
+                        std::ostringstream body;
+                        body << "thread " << t << " request " << n;
+
+                        cxxtools::http::PooledClient client = pool.acquire(_listen, _port);
+                        cxxtools::http::Request request("/echo");
+                        request.method("POST");
+                        request.body() << body.str();
+                        client->execute(request, cxxtools::Seconds(5));
+                        if (client->readBody().body() == body.str())
+                            ++ok;
+                    }
+                });
+
+            for (unsigned t = 0; t < threads.size(); ++t)
+                threads[t].join();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(ok.load(), 40u);
+
+            // the connections are kept for reuse
+            cxxtools::http::PooledClient client = pool.acquire(_listen, _port);
+            CXXTOOLS_UNIT_ASSERT(client->isConnected());
+        }
+
+        void requestNewConnections()
+        {
+            for (unsigned n = 0; n < 20; ++n)
+            {
+                cxxtools::http::Client client(_listen, _port);
+                const cxxtools::http::Reply& reply = client.get("/echo", cxxtools::Seconds(5));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(reply.body(), "hello");
+            }
+        }
+};
+
+cxxtools::unit::RegisterTest<HttpServerTest> register_HttpServerTest;
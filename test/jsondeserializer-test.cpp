@@ -31,6 +31,7 @@
 #include "cxxtools/jsondeserializer.h"
 #include "cxxtools/json.h"
 #include "cxxtools/log.h"
+#include <algorithm>
 
 //log_define("cxxtools.test.jsondeserializer")
 //
@@ -89,6 +90,51 @@ namespace
     {
     }
 
+    // Stream buffer, which passes the data in small chunks.
+    class ChunkedStreamBuf : public std::streambuf
+    {
+            const char* _p;
+            const char* _e;
+            unsigned _chunkSize;
+
+        public:
+            ChunkedStreamBuf(const std::string& data, unsigned chunkSize)
+                : _p(data.data()),
+                  _e(data.data() + data.size()),
+                  _chunkSize(chunkSize)
+            { }
+
+        protected:
+            int_type underflow()
+            {
+                if (_p == _e)
+                    return traits_type::eof();
+
+                char* b = const_cast<char*>(_p);
+                unsigned n = std::min(static_cast<unsigned>(_e - _p), _chunkSize);
+                setg(b, b, b + n);
+                _p += n;
+                return traits_type::to_int_type(*b);
+            }
+    };
+
+    // Parses json with the character based parser.
+    cxxtools::SerializationInfo parseChars(const std::string& json)
+    {
+        std::istringstream in(json);
+        cxxtools::TextIStream tin(in, new cxxtools::Utf8Codec());
+        cxxtools::JsonDeserializer deserializer(tin);
+        cxxtools::SerializationInfo si;
+        deserializer.deserialize(si);
+        return si;
+    }
+
+    std::string toJson(const cxxtools::SerializationInfo& si)
+    {
+        std::ostringstream out;
+        out << cxxtools::Json(si);
+        return out.str();
+    }
 }
 
 class JsonDeserializerTest : public cxxtools::unit::TestSuite
@@ -114,6 +160,14 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
             registerMethod("testTrailingComma", *this, &JsonDeserializerTest::testTrailingComma);
             registerMethod("testIStreamEof", *this, &JsonDeserializerTest::testIStreamEof);
             registerMethod("testIStreamFail", *this, &JsonDeserializerTest::testIStreamFail);
+            registerMethod("testStream", *this, &JsonDeserializerTest::testStream);
+            registerMethod("testStreamEmpty", *this, &JsonDeserializerTest::testStreamEmpty);
+            registerMethod("testStreamNoArray", *this, &JsonDeserializerTest::testStreamNoArray);
+            registerMethod("testUtf8Chunks", *this, &JsonDeserializerTest::testUtf8Chunks);
+            registerMethod("testUtf8StreamChunks", *this, &JsonDeserializerTest::testUtf8StreamChunks);
+            registerMethod("testUtf8LineNo", *this, &JsonDeserializerTest::testUtf8LineNo);
+            registerMethod("testUtf8Values", *this, &JsonDeserializerTest::testUtf8Values);
+            registerMethod("testUtf8Invalid", *this, &JsonDeserializerTest::testUtf8Invalid);
         }
 
         void testInt()
@@ -433,6 +487,229 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_NOTHROW(in >> cxxtools::Json(si));
             CXXTOOLS_UNIT_ASSERT(in.fail());
         }
+
+        void testStream()
+        {
+            std::istringstream in(
+                "[ {\"intValue\": 17, \"stringValue\": \"foo\", \"doubleValue\": 1.5, \"boolValue\": true},\n"
+                "  {\"intValue\": 18, \"stringValue\": \"bar\", \"doubleValue\": -2, \"boolValue\": false, \"nullValue\": null},\n"
+                "  {\"intValue\": 19, \"stringValue\": \"baz\", \"doubleValue\": 0, \"boolValue\": true} ]");
+
+            cxxtools::JsonDeserializer deserializer;
+            deserializer.beginStream(in);
+
+            TestObject obj;
+            CXXTOOLS_UNIT_ASSERT(deserializer.next(obj));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.intValue, 17);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.stringValue, "foo");
+            CXXTOOLS_UNIT_ASSERT(!obj.nullValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(deserializer.si().memberCount(), 1u);
+
+            CXXTOOLS_UNIT_ASSERT(deserializer.next(obj));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.intValue, 18);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.doubleValue, -2);
+            CXXTOOLS_UNIT_ASSERT(obj.nullValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(deserializer.si().memberCount(), 1u);
+
+            CXXTOOLS_UNIT_ASSERT(deserializer.next(obj));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.intValue, 19);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(obj.stringValue, "baz");
+
+            CXXTOOLS_UNIT_ASSERT(!deserializer.next(obj));
+            CXXTOOLS_UNIT_ASSERT(!deserializer.next(obj));
+
+            std::istringstream in2("[1,2,3]");
+            deserializer.beginStream(in2);
+            int value;
+            int sum = 0;
+            while (deserializer.next(value))
+                sum += value;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sum, 6);
+        }
+
+        void testStreamEmpty()
+        {
+            std::istringstream in(" [ ] ");
+            cxxtools::JsonDeserializer deserializer;
+            deserializer.beginStream(in);
+
+            int value;
+            CXXTOOLS_UNIT_ASSERT(!deserializer.next(value));
+        }
+
+        void testStreamNoArray()
+        {
+            std::istringstream in("{\"a\": 1}");
+            cxxtools::JsonDeserializer deserializer;
+            deserializer.beginStream(in);
+
+            int value;
+            CXXTOOLS_UNIT_ASSERT_THROW(deserializer.next(value), cxxtools::SerializationError);
+        }
+
+        void testUtf8Chunks()
+        {
+            const std::string json =
+                "{\n"
+                "  \"int\": -4711,\n"
+                "  \"double\": 3.25e-3,\n"
+                "  plain: \"plain key\",\n"
+                "  \"string\": \"a \\\"quoted\\\" \\\\ string\\twith \\u00e4 \\ud83d\\ude00 escapes and a long tail of plain characters\",\n"
+                "  \"utf8\": \"K\xc3\xa4se Stra\xc3\x9f" "e \xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x98\x80\",\n"
+                "  /* comment */\n"
+                "  \"array\": [1, 2.5, \"three\", true, false, null, [], {}, [[1],[2,3]]],\n"
+                "  // line comment\n"
+                "  \"object\": {\"a\": {\"b\": [ { \"c\": \"d\" } ]}},\n"
+                "  \"trailing\": [1, 2, ],\n"
+                "}\n";
+
+            const std::string expected = toJson(parseChars(json));
+
+            for (unsigned chunkSize = 1; chunkSize <= 40; ++chunkSize)
+            {
+                ChunkedStreamBuf sb(json, chunkSize);
+                std::istream in(&sb);
+                cxxtools::JsonDeserializer deserializer(in);
+                cxxtools::SerializationInfo si;
+                deserializer.deserialize(si);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(si), expected);
+            }
+
+            cxxtools::SerializationInfo si;
+            std::istringstream in(json);
+            in >> cxxtools::Json(si);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(si), expected);
+
+            cxxtools::String s;
+            si.getMember("utf8") >>= s;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::Utf8Codec::encode(s), "K\xc3\xa4se Stra\xc3\x9f" "e \xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x98\x80");
+        }
+
+        void testUtf8StreamChunks()
+        {
+            const std::string json = "[ {\"a\": \"x\"}, {\"a\": \"\xc3\xa4\"}, {\"a\": 42} ] {\"rest\": 1}";
+
+            for (unsigned chunkSize = 1; chunkSize <= 8; ++chunkSize)
+            {
+                ChunkedStreamBuf sb(json, chunkSize);
+                std::istream in(&sb);
+
+                cxxtools::JsonDeserializer deserializer;
+                deserializer.beginStream(in);
+
+                cxxtools::String value;
+                cxxtools::SerializationInfo si;
+                CXXTOOLS_UNIT_ASSERT(deserializer.next(si));
+                si.getMember("a") >>= value;
+                CXXTOOLS_UNIT_ASSERT_EQUALS(value, cxxtools::String(L"x"));
+                CXXTOOLS_UNIT_ASSERT(deserializer.next(si));
+                si.getMember("a") >>= value;
+                CXXTOOLS_UNIT_ASSERT_EQUALS(value, cxxtools::String(L"\xe4"));
+                CXXTOOLS_UNIT_ASSERT(deserializer.next(si));
+                si.getMember("a") >>= value;
+                CXXTOOLS_UNIT_ASSERT_EQUALS(value, cxxtools::String(L"42"));
+                CXXTOOLS_UNIT_ASSERT(!deserializer.next(si));
+
+                // the data after the array stays in the stream
+                int rest = 0;
+                in >> cxxtools::Json(si);
+                si.getMember("rest") >>= rest;
+                CXXTOOLS_UNIT_ASSERT_EQUALS(rest, 1);
+            }
+        }
+
+        void testUtf8LineNo()
+        {
+            const std::string json = "{\n  \"a\": 1,\n  \"b\": \"x\n\"\n  ]\n}";
+
+            std::string msg;
+            try
+            {
+                parseChars(json);
+            }
+            catch (const cxxtools::JsonParserError& e)
+            {
+                msg = e.what();
+            }
+
+            CXXTOOLS_UNIT_ASSERT(msg.find("line 5:") != std::string::npos);
+
+            std::istringstream in(json);
+            try
+            {
+                cxxtools::JsonDeserializer deserializer(in);
+                CXXTOOLS_UNIT_FAIL("JsonParserError expected");
+            }
+            catch (const cxxtools::JsonParserError& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(e.what()), msg);
+            }
+        }
+
+        void testUtf8Values()
+        {
+            std::istringstream in("{\"a\": \"plain \\\"ascii\\\"\", \"b\": \"\xc3\xa4\", \"c\": \"\\u00e4\", \"d\": -5}");
+            cxxtools::JsonDeserializer deserializer(in);
+            cxxtools::SerializationInfo si;
+            deserializer.deserialize(si);
+
+            // ascii strings need no conversion to std::string
+            CXXTOOLS_UNIT_ASSERT(si.getMember("a").isString8());
+            CXXTOOLS_UNIT_ASSERT(si.getMember("b").isString());
+            CXXTOOLS_UNIT_ASSERT(si.getMember("c").isString());
+
+            std::string a;
+            si.getMember("a") >>= a;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a, "plain \"ascii\"");
+
+            cxxtools::String b, c;
+            si.getMember("b") >>= b;
+            si.getMember("c") >>= c;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b, cxxtools::String(L"\xe4"));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c, cxxtools::String(L"\xe4"));
+
+            int d = 0;
+            si.getMember("d") >>= d;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(d, -5);
+        }
+
+        void testUtf8Invalid()
+        {
+            static const char* invalid[] = {
+                "\"\xc0\x80\"",               // overlong nul
+                "\"\xc1\xbf\"",               // overlong ascii
+                "\"\xe0\x9f\xbf\"",           // overlong 2 byte value
+                "\"\xf0\x8f\xbf\xbf\"",       // overlong 3 byte value
+                "\"\xed\xa0\x80\"",           // high surrogate
+                "\"\xed\xbf\xbf\"",           // low surrogate
+                "\"\xf4\x90\x80\x80\"",       // beyond U+10FFFF
+                "\"\x80\"",                   // continuation byte
+                0
+            };
+
+            for (unsigned n = 0; invalid[n]; ++n)
+            {
+                std::istringstream in(invalid[n]);
+                try
+                {
+                    cxxtools::JsonDeserializer deserializer(in);
+                    CXXTOOLS_UNIT_FAIL("JsonParserError expected");
+                }
+                catch (const cxxtools::JsonParserError&)
+                {
+                }
+            }
+
+            // largest values of each length
+            std::istringstream in("[\"\xdf\xbf\", \"\xef\xbf\xbf\", \"\xf4\x8f\xbf\xbf\"]");
+            cxxtools::JsonDeserializer deserializer(in);
+            std::vector<cxxtools::String> data;
+            deserializer.deserialize(data);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(data.size(), 3u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<int32_t>(data[0][0].value()), 0x7ff);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<int32_t>(data[1][0].value()), 0xffff);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<int32_t>(data[2][0].value()), 0x10ffff);
+        }
 };
 
 cxxtools::unit::RegisterTest<JsonDeserializerTest> register_JsonDeserializerTest;
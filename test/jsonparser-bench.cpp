@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the throughput of the json parser.
+ *
+ * The same document is parsed through the utf-8 parser, which reads bytes
+ * directly from the stream buffer and through the character based parser,
+ * which gets its input decoded by a TextIStream.
+ */
+
+#include <cxxtools/jsondeserializer.h>
+#include <cxxtools/jsonserializer.h>
+#include <cxxtools/serializationinfo.h>
+#include <cxxtools/textstream.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/convert.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    struct Record
+    {
+        int id;
+        std::string name;
+        std::string description;
+        double value;
+        bool active;
+        std::vector<int> numbers;
+    };
+
+    void operator<<= (cxxtools::SerializationInfo& si, const Record& r)
+    {
+        si.addMember("id") <<= r.id;
+        si.addMember("name") <<= r.name;
+        si.addMember("description") <<= r.description;
+        si.addMember("value") <<= r.value;
+        si.addMember("active") <<= r.active;
+        si.addMember("numbers") <<= r.numbers;
+    }
+
+    std::string createDocument(unsigned count, bool beautify)
+    {
+        std::vector<Record> records(count);
+        for (unsigned n = 0; n < count; ++n)
+        {
+            Record& r = records[n];
+            r.id = n;
+            r.name = "record " + cxxtools::convert<std::string>(n);
+            r.description = "a somewhat longer text with \"quotes\" and unicode characters: K\xc3\xa4se Stra\xc3\x9f" "e";
+            r.value = n * 0.125;
+            r.active = n & 1;
+            for (unsigned i = 0; i < 5; ++i)
+                r.numbers.push_back(n * i);
+        }
+
+        std::ostringstream out;
+        cxxtools::JsonSerializer serializer(out);
+        serializer.beautify(beautify);
+        serializer.serialize(records).finish();
+        return out.str();
+    }
+
+    void report(const char* name, std::size_t size, unsigned loops, cxxtools::Timespan t)
+    {
+        double mb = static_cast<double>(size) * loops / (1024 * 1024);
+        std::cout << name << ": " << t << " " << mb / t.totalSeconds() << " MB/s" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> count(argc, argv, 'n', 10000);
+        cxxtools::Arg<unsigned> loops(argc, argv, 'l', 10);
+        cxxtools::Arg<bool> beautify(argc, argv, 'B');
+        cxxtools::Arg<const char*> file(argc, argv, 'f');
+
+        std::cout << "benchmark json parser\n\n"
+                     "options:\n"
+                     "   -n <number>       specify number of records in generated document\n"
+                     "   -l <number>       specify number of loops\n"
+                     "   -B                beautify generated document\n"
+                     "   -f <file>         parse json file instead of generated document\n" << std::endl;
+
+        std::string data;
+        if (file.isSet())
+        {
+            std::ifstream in(file);
+            std::ostringstream s;
+            s << in.rdbuf();
+            data = s.str();
+        }
+        else
+            data = createDocument(count, beautify);
+
+        std::cout << "document size: " << data.size() << " bytes" << std::endl;
+
+        cxxtools::Clock clock;
+
+        clock.start();
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            std::istringstream in(data);
+            cxxtools::TextIStream tin(in, new cxxtools::Utf8Codec());
+            cxxtools::JsonDeserializer deserializer(tin);
+        }
+
+        report("character parser", data.size(), loops, clock.stop());
+
+        clock.start();
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            std::istringstream in(data);
+            cxxtools::JsonDeserializer deserializer(in);
+        }
+
+        report("utf-8 parser", data.size(), loops, clock.stop());
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -32,6 +32,7 @@
 #include "cxxtools/remoteexception.h"
 #include "cxxtools/remoteprocedure.h"
 #include "cxxtools/http/server.h"
+#include "cxxtools/http/clientpool.h"
 #include "cxxtools/eventloop.h"
 #include "cxxtools/log.h"
 #include "cxxtools/ioerror.h"
@@ -39,6 +40,7 @@
 #include "cxxtools/net/addrinfo.h"
 #include <stdlib.h>
 #include <sstream>
+#include <thread>
 
 log_define("cxxtools.test.jsonrpchttp")
 
@@ -112,6 +114,7 @@ class JsonRpcHttpTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &JsonRpcHttpTest::PrepareConnect);
             registerMethod("Connect", *this, &JsonRpcHttpTest::Connect);
             registerMethod("Multiple", *this, &JsonRpcHttpTest::Multiple);
+            registerMethod("ClientPool", *this, &JsonRpcHttpTest::ClientPool);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -835,6 +838,52 @@ class JsonRpcHttpTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // ClientPool
+        //
+        void ClientPool()
+        {
+            cxxtools::json::HttpService service;
+            service.registerMethod("multiply", *this, &JsonRpcHttpTest::multiplyInt);
+            _server->addService("/rpc", service);
+
+            // more clients than connections
+            cxxtools::http::ClientPool pool(2);
+            std::vector<cxxtools::json::HttpClient> clients;
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                clients.push_back(cxxtools::json::HttpClient(_listen, _port, "/rpc"));
+                clients.back().clientPool(&pool);
+                clients.back().timeout(cxxtools::Seconds(5));
+            }
+
+            // the server runs in the event loop, so the syncronous calls are
+            // made in a separate thread
+            unsigned ok = 0;
+            std::thread thread([this, &clients, &ok]() {
+                try
+                {
+                    for (unsigned n = 0; n < 20; ++n)
+                    {
+                        cxxtools::RemoteProcedure<int, int, int> multiply(clients[n % clients.size()], "multiply");
+                        if (multiply(n, 3) == static_cast<int>(n * 3))
+                            ++ok;
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    log_error("pooled call failed: " << e.what());
+                }
+
+                _loop.exit();
+            });
+
+            _loop.run();
+            thread.join();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(ok, 20u);
+        }
+
 };
 
 cxxtools::unit::RegisterTest<JsonRpcHttpTest> register_JsonRpcHttpTest;
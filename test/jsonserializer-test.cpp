@@ -119,6 +119,7 @@ class JsonSerializerTest : public cxxtools::unit::TestSuite
             registerMethod("testPlainEmpty", *this, &JsonSerializerTest::testPlainEmpty);
             registerMethod("testEmptyObject", *this, &JsonSerializerTest::testEmptyObject);
             registerMethod("testDirect", *this, &JsonSerializerTest::testDirect);
+            registerMethod("testFormatValue", *this, &JsonSerializerTest::testFormatValue);
             registerMethod("testEasyJson", *this, &JsonSerializerTest::testEasyJson);
             registerMethod("testPlainkey", *this, &JsonSerializerTest::testPlainkey);
             registerMethod("testTimespan", *this, &JsonSerializerTest::testTimespan);
@@ -305,6 +306,60 @@ class JsonSerializerTest : public cxxtools::unit::TestSuite
 
         }
 
+        void testFormatValue()
+        {
+            std::vector<int> ints;
+            ints.push_back(-4);
+            ints.push_back(17);
+
+            std::set<double> doubles;
+            doubles.insert(1.5);
+            doubles.insert(-0.25);
+
+            std::list<std::vector<std::string>> strings(2);
+            strings.front().push_back("foo");
+            strings.back().push_back("bar\n");
+
+            std::vector<TestObject> objects(2);
+            objects[1].intValue = 5;
+            objects[1].stringValue = "five";
+
+            cxxtools::SerializationInfo si;
+            si <<= ints;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(ints), toJson(si));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(ints), "[-4,17]");
+
+            si.clear();
+            si <<= doubles;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(doubles), toJson(si));
+
+            si.clear();
+            si <<= strings;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(strings), toJson(si));
+
+            si.clear();
+            si <<= objects;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(toJson(objects), toJson(si));
+
+            std::ostringstream out1;
+            cxxtools::JsonSerializer serializer1(out1);
+            serializer1.serialize(ints, "ints")
+                       .serialize(objects, "objects")
+                       .finish();
+
+            cxxtools::SerializationInfo si1;
+            si1 <<= ints;
+            cxxtools::SerializationInfo si2;
+            si2 <<= objects;
+            std::ostringstream out2;
+            cxxtools::JsonSerializer serializer2(out2);
+            serializer2.serialize(si1, "ints")
+                       .serialize(si2, "objects")
+                       .finish();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out1.str(), out2.str());
+        }
+
         void testEasyJson()
         {
             TestObject data;
@@ -26,6 +26,19 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+/*
+ * Measures the throughput of the logging library.
+ *
+ * The threads (-t) log the messages in parallel. Without -s or -a the
+ * benchmark runs once with synchronous and once with asynchronous
+ * logging. Asynchronous times include flushing the buffer, so the numbers
+ * tell how fast messages reach the appender, not just the queue.
+ *
+ * The global operator new is replaced to count heap allocations, which are
+ * reported per message. With -n the messages contain formatted numbers.
+ * With -B the log file is written in binary format (see cxxlogdecode).
+ */
+
 #include <cxxtools/arg.h>
 #include <cxxtools/timespan.h>
 #include <cxxtools/clock.h>
@@ -35,53 +48,102 @@
 #include <vector>
 #include <stdexcept>
 #include <iomanip>
-#include <memory>
 #include <thread>
+#include <atomic>
+#include <new>
+#include <cstdlib>
 
-#include <sys/time.h>
+namespace
+{
+    std::atomic<unsigned long> allocations(0);
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
 
 namespace bench
 {
     log_define("bench")
 
-    class Logtester
+    bool numbers = false;
+
+    void logMessages(unsigned long count, bool enabled)
     {
-            std::thread _thread;
-            unsigned long _count;
-            unsigned long _loops;
-            bool _enabled;
-
-        public:
-            Logtester(unsigned long count,
-                                unsigned long loops,
-                                unsigned long enabled)
-                : _thread(&Logtester::run, this),
-                  _count(count),
-                  _loops(loops),
-                  _enabled(enabled)
-                  { }
-
-            void join()
-            { _thread.join(); }
-
-            void setCount(unsigned long count)     { _count = count; }
-            void setLoops(unsigned long loops)     { _loops = loops; }
-            void setEnabled(bool sw = true)         { _enabled = sw; }
-
-            void run();
-    };
-
-    void Logtester::run()
+        if (enabled && numbers)
+            for (unsigned long i = 0; i < count; ++i)
+                log_info("info message " << i << " value " << i * 0.25 << " offset " << -static_cast<long>(i));
+        else if (enabled)
+            for (unsigned long i = 0; i < count; ++i)
+                log_info("info message");
+        else
+            for (unsigned long i = 0; i < count; ++i)
+                log_debug("debug message");
+    }
+
+    // runs count messages in the given number of threads and returns the time
+    cxxtools::Seconds measure(unsigned long count, unsigned numthreads, bool enabled)
     {
-        for (unsigned long l = 0; l < _loops; ++l)
+        cxxtools::Clock cl;
+        cl.start();
+
+        if (numthreads <= 1)
         {
-            if (_enabled)
-                for (unsigned long i = 0; i < _count; ++i)
-                    log_info("info message");
-            else
-                for (unsigned long i = 0; i < _count; ++i)
-                    log_debug("debug message");
+            logMessages(count, enabled);
+        }
+        else
+        {
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < numthreads; ++t)
+                threads.push_back(std::thread(&logMessages, count / numthreads, enabled));
+            for (unsigned t = 0; t < threads.size(); ++t)
+                threads[t].join();
+        }
+
+        cxxtools::LogManager::getInstance().flush();
+
+        return cl.stop();
+    }
+
+    void run(const char* title, unsigned long loops, unsigned numthreads, bool enabled, cxxtools::Seconds total)
+    {
+        std::cout << title << ", " << numthreads << " threads:" << std::endl;
+
+        double result = 0;
+        for (unsigned long count = 1; count > 0; count <<= 1)
+        {
+            unsigned long a0 = allocations;
+            cxxtools::Seconds T = measure(count * loops, numthreads, enabled);
+            unsigned long a = allocations - a0;
+            result = count * loops / T;
+
+            std::cout << "count=" << std::setw(10) << (count * loops)
+                << "  T=" << std::setw(10) << std::setprecision(6) << T
+                << "  " << std::setw(12) << std::setprecision(12) << result << " msg/s"
+                << "  " << std::setw(8) << std::setprecision(3) << static_cast<double>(a) / (count * loops) << " allocs/msg" << std::endl;
+
+            if (T >= total)
+                break;
         }
+
+        unsigned long dropped = cxxtools::LogManager::getInstance().droppedMessages();
+        if (dropped > 0)
+            std::cout << dropped << " messages dropped" << std::endl;
     }
 }
 
@@ -99,6 +161,13 @@ int main(int argc, char* argv[])
         cxxtools::Arg<std::string> logfile(argc, argv, 'f', "/dev/null");
         cxxtools::Arg<bool> norollingfile(argc, argv, 'r');
 
+        cxxtools::Arg<bool> syncOnly(argc, argv, 's');
+        cxxtools::Arg<bool> asyncOnly(argc, argv, 'a');
+        cxxtools::Arg<bool> drop(argc, argv, 'd');
+        cxxtools::Arg<unsigned> bufferSize(argc, argv, 'b', 8192);
+        bench::numbers = cxxtools::Arg<bool>(argc, argv, 'n');
+        cxxtools::Arg<bool> binary(argc, argv, 'B');
+
         cxxtools::LogConfiguration logConfiguration;
         logConfiguration.setRootLevel(cxxtools::Logger::LOG_LEVEL_INFO);
 
@@ -129,47 +198,23 @@ int main(int argc, char* argv[])
                 logConfiguration.setFile(logfile, 1024*1024, 0);
         }
 
-        log_init(logConfiguration);
+        if (binary)
+            logConfiguration.setBinary();
 
-        unsigned long count = 1;
-
-        typedef std::vector<std::unique_ptr<bench::Logtester> > Threads;
-        Threads threads;
-        for (unsigned t = 0; t < numthreads; ++t)
-            threads.emplace_back(new bench::Logtester(count, loops.getValue() / numthreads.getValue(), enable));
-
-        while (count > 0)
+        if (!asyncOnly)
         {
-            std::cout << "count=" << (count * loops) << '\t' << std::flush;
-
-            for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
-                (*it)->setCount(count);
-
-            cxxtools::Clock cl;
-            cl.start();
-
-            if (threads.size() == 1)
-            {
-                (*threads.begin())->run();
-            }
-            else
-            {
-                for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
-                    (*it)->join();
-            }
-
-            cxxtools::Seconds T = cl.stop();
-
-            std::cout.precision(6);
-            std::cout << " T=" << T << '\t' << std::setprecision(12) << (count / T * loops)
-                << " msg/s" << std::endl;
-
-            if (T >= total)
-                break;
-
-            count <<= 1;
+            log_init(logConfiguration);
+            bench::run("synchronous", loops, numthreads, enable, total);
         }
 
+        if (!syncOnly)
+        {
+            logConfiguration.setAsync(true, bufferSize,
+                drop ? cxxtools::LogConfiguration::OverflowDrop
+                     : cxxtools::LogConfiguration::OverflowBlock);
+            log_init(logConfiguration);
+            bench::run("asynchronous", loops, numthreads, enable, total);
+        }
     }
     catch (const std::exception& e)
     {
@@ -177,4 +222,3 @@ int main(int argc, char* argv[])
         return -1;
     }
 }
-
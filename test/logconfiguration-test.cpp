@@ -31,6 +31,7 @@
 #include "cxxtools/unit/registertest.h"
 #include <sstream>
 #include <cxxtools/properties.h>
+#include <cxxtools/serializationinfo.h>
 
 class LogconfigurationTest : public cxxtools::unit::TestSuite
 {
@@ -45,6 +46,8 @@ class LogconfigurationTest : public cxxtools::unit::TestSuite
       registerMethod("rootLevelTest", *this, &LogconfigurationTest::rootLevelTest);
       registerMethod("hierachicalTest", *this, &LogconfigurationTest::hierachicalTest);
       registerMethod("convertLogFlagsTest", *this, &LogconfigurationTest::convertLogFlagsTest);
+      registerMethod("asyncTest", *this, &LogconfigurationTest::asyncTest);
+      registerMethod("binaryTest", *this, &LogconfigurationTest::binaryTest);
     }
 
     void logLevelTest();
@@ -54,6 +57,8 @@ class LogconfigurationTest : public cxxtools::unit::TestSuite
     void rootLevelTest();
     void hierachicalTest();
     void convertLogFlagsTest();
+    void asyncTest();
+    void binaryTest();
 };
 
 void LogconfigurationTest::logLevelTest()
@@ -257,5 +262,58 @@ void LogconfigurationTest::convertLogFlagsTest()
   CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::LogConfiguration::strToLogFlags("blah"), std::runtime_error);
 }
 
+void LogconfigurationTest::asyncTest()
+{
+  std::istringstream properties(
+    "rootlogger=INFO\n"
+    "async=true\n"
+    "asyncBufferSize=1024\n"
+    "overflow=drop\n");
+
+  cxxtools::LogConfiguration config;
+  properties >> cxxtools::Properties(config);
+
+  cxxtools::SerializationInfo si;
+  si <<= config;
+
+  bool async = false;
+  unsigned bufferSize = 0;
+  std::string overflow;
+  CXXTOOLS_UNIT_ASSERT(si.getMember("async", async));
+  CXXTOOLS_UNIT_ASSERT(si.getMember("asyncBufferSize", bufferSize));
+  CXXTOOLS_UNIT_ASSERT(si.getMember("overflow", overflow));
+  CXXTOOLS_UNIT_ASSERT(async);
+  CXXTOOLS_UNIT_ASSERT_EQUALS(bufferSize, 1024u);
+  CXXTOOLS_UNIT_ASSERT_EQUALS(overflow, "drop");
+
+  std::istringstream invalid(
+    "rootlogger=INFO\n"
+    "async=true\n"
+    "overflow=wait\n");
+  CXXTOOLS_UNIT_ASSERT_THROW(invalid >> cxxtools::Properties(config), std::runtime_error);
+}
+
+void LogconfigurationTest::binaryTest()
+{
+  std::istringstream properties(
+    "rootlogger=INFO\n"
+    "file=app.log\n"
+    "binary=true\n");
+
+  cxxtools::LogConfiguration config;
+  properties >> cxxtools::Properties(config);
+
+  cxxtools::SerializationInfo si;
+  si <<= config;
+
+  bool binary = false;
+  CXXTOOLS_UNIT_ASSERT(si.getMember("binary", binary));
+  CXXTOOLS_UNIT_ASSERT(binary);
+
+  config.setBinary(false);
+  si.clear();
+  si <<= config;
+  CXXTOOLS_UNIT_ASSERT(si.findMember("binary") == 0);
+}
 
 cxxtools::unit::RegisterTest<LogconfigurationTest> register_LogconfigurationTest;
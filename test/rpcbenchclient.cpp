@@ -33,6 +33,7 @@
 #include <cxxtools/bin/rpcclient.h>
 #include <cxxtools/json/rpcclient.h>
 #include <cxxtools/json/httpclient.h>
+#include <cxxtools/http/clientpool.h>
 #include <cxxtools/sslctx.h>
 #include <cxxtools/clock.h>
 #include <cxxtools/timespan.h>
@@ -188,6 +189,7 @@ int main(int argc, char* argv[])
         cxxtools::Arg<unsigned short> port(argc, argv, 'p', binary ? 7003 : json ? 7004 : 7002);
         cxxtools::Arg<bool> ssl(argc, argv, 's');
         cxxtools::Arg<cxxtools::Seconds> maxtime(argc, argv, 'T');
+        cxxtools::Arg<unsigned> poolSize(argc, argv, 'P', 0);
 
         BenchClient::numRequests(cxxtools::Arg<unsigned>(argc, argv, 'n', 10000));
         BenchClient::vectorSize(cxxtools::Arg<unsigned>(argc, argv, 'v', 0));
@@ -206,6 +208,7 @@ int main(int argc, char* argv[])
                                          "     -b                 use binary rpc protocol\n"
                                          "     -j                 use json rpc protocol\n"
                                          "     -J                 use json rpc over http protocol\n"
+                                         "     -P number    with -J share a pool of <number> connections between the threads\n"
                                          "     -s                 enable ssl\n"
                                          "     -t number    set number of threads (default: 4)\n"
                                          "     -n number    set number of requests (default: 10000)\n"
@@ -217,6 +220,10 @@ int main(int argc, char* argv[])
                 return -1;
         }
 
+        std::unique_ptr<cxxtools::http::ClientPool> pool;
+        if (poolSize > 0)
+            pool.reset(new cxxtools::http::ClientPool(poolSize));
+
         BenchClients clients;
 
         cxxtools::SslCtx sslCtx;
@@ -238,7 +245,9 @@ int main(int argc, char* argv[])
             }
             else if (jsonhttp)
             {
-                client.reset(new cxxtools::json::HttpClient(ip, port, "/jsonrpc", sslCtx));
+                cxxtools::json::HttpClient* httpClient = new cxxtools::json::HttpClient(ip, port, "/jsonrpc", sslCtx);
+                httpClient->clientPool(pool.get());
+                client.reset(httpClient);
             }
             else // if (xmlrpc)
             {
@@ -256,6 +265,9 @@ int main(int argc, char* argv[])
         std::cout << BenchClient::requestsStarted() << " requests in " << t.totalMSecs()/1e3 << " s => " << (BenchClient::requestsStarted() / (t.totalMSecs()/1e3)) << "#/s\n"
                             << BenchClient::requestsFinished() << " finished " << BenchClient::requestsFailed() << " failed" << std::endl;
 
+        if (ssl)
+            std::cout << "ssl handshakes: " << sslCtx.sessionHits() << " resumed " << sslCtx.sessionMisses() << " full" << std::endl;
+
         for (BenchClients::iterator it = clients.begin(); it != clients.end(); ++it)
             delete *it;
     }
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the wakeup latency of the selector depending on the number of
+ * registered idle devices.
+ *
+ * A byte is written to a pipe and the selector waits until the read end
+ * reports input. The other pipes are registered for reading but stay idle.
+ */
+
+#include <cxxtools/posix/pipe.h>
+#include <cxxtools/selector.h>
+#include <cxxtools/connectable.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <sys/resource.h>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    class Receiver : public cxxtools::Connectable
+    {
+            cxxtools::IODevice& _dev;
+            char _buffer[16];
+
+        public:
+            unsigned count;
+
+            explicit Receiver(cxxtools::IODevice& dev)
+                : _dev(dev),
+                  count(0)
+            {
+                cxxtools::connect(_dev.inputReady, *this, &Receiver::onInput);
+                _dev.beginRead(_buffer, sizeof(_buffer));
+            }
+
+            void onInput(cxxtools::IODevice&)
+            {
+                _dev.endRead();
+                ++count;
+                _dev.beginRead(_buffer, sizeof(_buffer));
+            }
+    };
+
+    // returns the wakeup latency in microseconds
+    double measure(cxxtools::SelectorBase::Backend backend, unsigned idle, unsigned loops)
+    {
+        cxxtools::Selector selector(backend);
+
+        std::vector<std::unique_ptr<cxxtools::posix::Pipe>> pipes;
+        std::vector<std::unique_ptr<Receiver>> receivers;
+        for (unsigned n = 0; n < idle; ++n)
+        {
+            pipes.emplace_back(new cxxtools::posix::Pipe(cxxtools::Pipe::Async));
+            pipes.back()->out().setSelector(&selector);
+            receivers.emplace_back(new Receiver(pipes.back()->out()));
+        }
+
+        cxxtools::posix::Pipe ping(cxxtools::Pipe::Async);
+        ping.out().setSelector(&selector);
+        Receiver receiver(ping.out());
+
+        // let the selector pick up the registrations
+        selector.wait(0);
+
+        cxxtools::Clock clock;
+        clock.start();
+
+        for (unsigned n = 0; n < loops; ++n)
+        {
+            ping.write('x');
+            while (receiver.count <= n)
+                selector.wait();
+        }
+
+        cxxtools::Timespan t = clock.stop();
+        return static_cast<double>(t.totalUSecs()) / loops;
+    }
+
+    void raiseFileLimit(unsigned fds)
+    {
+        struct rlimit rl;
+        if (::getrlimit(RLIMIT_NOFILE, &rl) != 0)
+            return;
+
+        if (rl.rlim_cur < fds)
+        {
+            rl.rlim_cur = rl.rlim_max < fds ? rl.rlim_max : fds;
+            ::setrlimit(RLIMIT_NOFILE, &rl);
+        }
+    }
+
+    unsigned fileLimit()
+    {
+        struct rlimit rl;
+        if (::getrlimit(RLIMIT_NOFILE, &rl) != 0)
+            return 1024;
+        return rl.rlim_cur;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> maxIdle(argc, argv, 'n', 10000);
+        cxxtools::Arg<unsigned> loops(argc, argv, 'l', 10000);
+
+        std::cout << "benchmark selector wakeup latency\n\n"
+                     "options:\n"
+                     "   -n <number>       specify maximum number of idle pipes\n"
+                     "   -l <number>       specify number of wakeups per measurement\n" << std::endl;
+
+        raiseFileLimit(maxIdle * 2 + 64);
+        unsigned limit = (fileLimit() - 64) / 2;
+
+        std::cout << std::setw(8) << "idle"
+                  << std::setw(14) << "poll [us]"
+                  << std::setw(14) << "epoll [us]" << std::endl;
+
+        for (unsigned idle = 0; idle <= maxIdle; idle = idle == 0 ? 10 : idle * 10)
+        {
+            if (idle > limit)
+            {
+                std::cout << "file limit reached; skip " << idle << " idle pipes" << std::endl;
+                break;
+            }
+
+            double p = measure(cxxtools::SelectorBase::PollBackend, idle, loops);
+            double e = measure(cxxtools::SelectorBase::EpollBackend, idle, loops);
+
+            std::cout << std::setw(8) << idle
+                      << std::setw(14) << std::fixed << std::setprecision(2) << p
+                      << std::setw(14) << e << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/posix/pipe.h"
+#include "cxxtools/selector.h"
+#include <memory>
+
+class SelectorTest : public cxxtools::unit::TestSuite
+{
+        typedef cxxtools::SelectorBase::Backend Backend;
+
+        std::unique_ptr<cxxtools::posix::Pipe> _pipe[2];
+        char _buffer[16];
+        unsigned _count;
+
+        void onInput(cxxtools::IODevice& dev)
+        {
+            dev.endRead();
+            ++_count;
+        }
+
+        // destroys the other pipe, which has also data available
+        void onInputDestroy(cxxtools::IODevice& dev)
+        {
+            dev.endRead();
+            ++_count;
+            if (&dev == &_pipe[0]->out())
+                _pipe[1].reset();
+            else
+                _pipe[0].reset();
+        }
+
+        void input(Backend backend)
+        {
+            cxxtools::Selector selector(backend);
+            cxxtools::posix::Pipe pipe(cxxtools::Pipe::Async);
+            connect(pipe.out().inputReady, *this, &SelectorTest::onInput);
+            selector.add(pipe.out());
+
+            char buffer[16];
+            pipe.out().beginRead(buffer, sizeof(buffer));
+
+            CXXTOOLS_UNIT_ASSERT(!selector.wait(10));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 0u);
+
+            pipe.write('a');
+            CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 1u);
+
+            // not reading any more - data must not be reported
+            pipe.write('b');
+            CXXTOOLS_UNIT_ASSERT(!selector.wait(10));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 1u);
+
+            pipe.out().beginRead(buffer, sizeof(buffer));
+            CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 2u);
+        }
+
+        void removeInCallback(Backend backend)
+        {
+            cxxtools::Selector selector(backend);
+            for (unsigned n = 0; n < 2; ++n)
+            {
+                _pipe[n].reset(new cxxtools::posix::Pipe(cxxtools::Pipe::Async));
+                connect(_pipe[n]->out().inputReady, *this, &SelectorTest::onInputDestroy);
+                selector.add(_pipe[n]->out());
+                _pipe[n]->out().beginRead(_buffer, sizeof(_buffer));
+                _pipe[n]->write('a');
+            }
+
+            CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_count, 1u);
+            _pipe[0].reset();
+            _pipe[1].reset();
+        }
+
+        void wake(Backend backend)
+        {
+            cxxtools::Selector selector(backend);
+            selector.wake();
+            CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+            CXXTOOLS_UNIT_ASSERT(!selector.wait(10));
+        }
+
+    public:
+        SelectorTest()
+        : cxxtools::unit::TestSuite("selector")
+        {
+            registerMethod("backend", *this, &SelectorTest::backend);
+            registerMethod("pollInput", *this, &SelectorTest::pollInput);
+            registerMethod("epollInput", *this, &SelectorTest::epollInput);
+            registerMethod("pollRemoveInCallback", *this, &SelectorTest::pollRemoveInCallback);
+            registerMethod("epollRemoveInCallback", *this, &SelectorTest::epollRemoveInCallback);
+            registerMethod("pollWake", *this, &SelectorTest::pollWake);
+            registerMethod("epollWake", *this, &SelectorTest::epollWake);
+        }
+
+        void setUp()
+        {
+            _count = 0;
+        }
+
+        void backend()
+        {
+            cxxtools::Selector selector(cxxtools::SelectorBase::PollBackend);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(selector.backend(), cxxtools::SelectorBase::PollBackend);
+
+            cxxtools::Selector defaultSelector;
+            CXXTOOLS_UNIT_ASSERT(defaultSelector.backend() != cxxtools::SelectorBase::DefaultBackend);
+        }
+
+        void pollInput()              { input(cxxtools::SelectorBase::PollBackend); }
+        void epollInput()             { input(cxxtools::SelectorBase::EpollBackend); }
+        void pollRemoveInCallback()   { removeInCallback(cxxtools::SelectorBase::PollBackend); }
+        void epollRemoveInCallback()  { removeInCallback(cxxtools::SelectorBase::EpollBackend); }
+        void pollWake()               { wake(cxxtools::SelectorBase::PollBackend); }
+        void epollWake()              { wake(cxxtools::SelectorBase::EpollBackend); }
+};
+
+cxxtools::unit::RegisterTest<SelectorTest> register_SelectorTest;
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/serializable.h"
+#include "cxxtools/jsonserializer.h"
+#include "cxxtools/jsondeserializer.h"
+#include "cxxtools/bin/serializer.h"
+#include "cxxtools/bin/deserializer.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <sstream>
+#include <vector>
+
+namespace test
+{
+    struct Address
+    {
+        std::string street;
+        unsigned number;
+    };
+
+    CXXTOOLS_SERIALIZABLE(Address, street, number)
+
+    struct Customer
+    {
+        std::string name;
+        int age;
+        double balance;
+        bool active;
+        std::vector<std::string> phones;
+        Address address;
+    };
+
+    CXXTOOLS_SERIALIZABLE(Customer, name, age, balance, active, phones, address)
+}
+
+class SerializableTest : public cxxtools::unit::TestSuite
+{
+    public:
+        SerializableTest()
+        : cxxtools::unit::TestSuite("serializable")
+        {
+            registerMethod("testSerializationInfo", *this, &SerializableTest::testSerializationInfo);
+            registerMethod("testJson", *this, &SerializableTest::testJson);
+            registerMethod("testBin", *this, &SerializableTest::testBin);
+            registerMethod("testMemberOrder", *this, &SerializableTest::testMemberOrder);
+            registerMethod("testMissingMember", *this, &SerializableTest::testMissingMember);
+        }
+
+        static test::Customer customer()
+        {
+            test::Customer c;
+            c.name = "Tommi";
+            c.age = 42;
+            c.balance = 17.5;
+            c.active = true;
+            c.phones.push_back("123");
+            c.phones.push_back("456");
+            c.address.street = "Main street";
+            c.address.number = 5;
+            return c;
+        }
+
+        static void checkCustomer(const test::Customer& c)
+        {
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.name, "Tommi");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.age, 42);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.balance, 17.5);
+            CXXTOOLS_UNIT_ASSERT(c.active);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.phones.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.phones[1], "456");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.address.street, "Main street");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c.address.number, 5u);
+        }
+
+        void testSerializationInfo()
+        {
+            cxxtools::SerializationInfo si;
+            si <<= customer();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.typeName(), "Customer");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.memberCount(), 6u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember(0).name(), "name");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember(5).name(), "address");
+
+            test::Customer c;
+            si >>= c;
+            checkCustomer(c);
+        }
+
+        void testJson()
+        {
+            std::string json = cxxtools::JsonSerializer::toString(customer(), "customer");
+
+            std::istringstream in(json);
+            cxxtools::JsonDeserializer deserializer(in);
+            cxxtools::SerializationInfo si;
+            deserializer.deserialize(si);
+
+            test::Customer c;
+            si.getMember("customer") >>= c;
+            checkCustomer(c);
+
+            // the direct formatter writes the same data
+            cxxtools::SerializationInfo tree;
+            tree <<= customer();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(json, cxxtools::JsonSerializer::toString(tree, "customer"));
+        }
+
+        void testBin()
+        {
+            std::istringstream data(cxxtools::bin::Serializer::toString(customer()));
+
+            test::Customer c;
+            cxxtools::bin::Deserializer deserializer(data);
+            deserializer.deserialize(c);
+            checkCustomer(c);
+        }
+
+        void testMemberOrder()
+        {
+            std::istringstream in(
+                "{\"phones\": [\"123\", \"456\"], \"address\": {\"number\": 5, \"street\": \"Main street\"},"
+                " \"name\": \"Tommi\", \"active\": true, \"age\": 42, \"balance\": 17.5, \"unknown\": 1}");
+
+            test::Customer c;
+            cxxtools::JsonDeserializer deserializer(in);
+            deserializer.deserialize(c);
+            checkCustomer(c);
+        }
+
+        void testMissingMember()
+        {
+            std::istringstream in("{\"name\": \"Tommi\", \"age\": 42}");
+
+            test::Customer c;
+            cxxtools::JsonDeserializer deserializer(in);
+            CXXTOOLS_UNIT_ASSERT_THROW(deserializer.deserialize(c), cxxtools::SerializationMemberNotFound);
+        }
+};
+
+cxxtools::unit::RegisterTest<SerializableTest> register_SerializableTest;
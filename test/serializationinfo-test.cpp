@@ -64,6 +64,8 @@ class SerializationInfoTest : public cxxtools::unit::TestSuite
             registerMethod("testMove", *this, &SerializationInfoTest::testMove);
             registerMethod("testStringToBool", *this, &SerializationInfoTest::testStringToBool);
             registerMethod("testMember", *this, &SerializationInfoTest::testMember);
+            registerMethod("testManyMembers", *this, &SerializationInfoTest::testManyMembers);
+            registerMethod("testLongNames", *this, &SerializationInfoTest::testLongNames);
         }
 
         void testSiSet()
@@ -548,6 +550,97 @@ class SerializationInfoTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember(2).name(), "baz");
             CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember(3).name(), "foo");
         }
+
+        void testManyMembers()
+        {
+            cxxtools::SerializationInfo si;
+            for (unsigned n = 0; n < 100; ++n)
+                si.addMember("m" + cxxtools::convert<std::string>(n)) <<= n;
+
+            // duplicate name; the first member is found
+            si.addMember("m42") <<= 4242;
+
+            // member renamed after adding it
+            si.addMember().setName("last");
+
+            const cxxtools::SerializationInfo& csi = si;
+            for (unsigned n = 0; n < 100; ++n)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<unsigned>(csi.getMember("m" + cxxtools::convert<std::string>(n))), n);
+
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("last") != 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m100") == 0);
+            CXXTOOLS_UNIT_ASSERT_THROW(csi.getMember("foo"), cxxtools::SerializationError);
+
+            si.addMember("more");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("last") != 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("more") != 0);
+
+            // members renamed through non const access
+            si.getMember(7u).setName("seven");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m7") == 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("seven") != 0);
+
+            for (cxxtools::SerializationInfo::Iterator it = si.begin(); it != si.end(); ++it)
+                if (it->name() == "m8")
+                    it->setName("eight");
+            si.addMember("again");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m8") == 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("eight") != 0);
+
+            // members renamed through access by name
+            si.getMember("m3").setName("three");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m3") == 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("three") != 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<unsigned>(csi.getMember("three")), 3u);
+
+            si.findMember("m5")->setName("five");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m5") == 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("five") != 0);
+
+            cxxtools::SerializationInfo other;
+            other.setName("swapped");
+            si.getMember("m6").swap(other);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m6") == 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("swapped") != 0);
+
+            other.setName("assigned");
+            si.getMember("m10") = other;
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m10") == 0);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("assigned") != 0);
+
+            // the duplicate is found, when the first member is renamed
+            si.getMember("m42").setName("fortytwo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<unsigned>(csi.getMember("m42")), 4242u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<unsigned>(csi.getMember("fortytwo")), 42u);
+
+            cxxtools::SerializationInfo si2(si);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<unsigned>(si2.getMember("m99")), 99u);
+            CXXTOOLS_UNIT_ASSERT(si2.findMember("seven") != 0);
+        }
+
+        void testLongNames()
+        {
+            // names too long for the symbol table are owned by the node
+            std::string longName(100, 'x');
+            std::string longType(200, 'y');
+
+            cxxtools::SerializationInfo si;
+            si.addMember("short") <<= 1;
+            si.addMember(longName) <<= 2;
+            si.setTypeName(longType);
+
+            cxxtools::SerializationInfo si2(si);
+            si = cxxtools::SerializationInfo();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si2.typeName(), longType);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(si2.getMember(longName)), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(si2.getMember("short")), 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si2.getMember(1u).name(), longName);
+
+            si2.getMember(1u).setName("short2");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(si2.getMember("short2")), 2);
+            CXXTOOLS_UNIT_ASSERT(si2.findMember(longName) == 0);
+        }
 };
 
 cxxtools::unit::RegisterTest<SerializationInfoTest> register_SerializationInfoTest;
@@ -35,6 +35,7 @@
 #include <cxxtools/jsondeserializer.h>
 #include <cxxtools/bin/serializer.h>
 #include <cxxtools/bin/deserializer.h>
+#include <cxxtools/arena.h>
 #include <cxxtools/arg.h>
 #include <cxxtools/clock.h>
 #include <cxxtools/convert.h>
@@ -82,9 +83,71 @@ namespace
         si.setTypeName(typeName);
     }
 
+    void formatValue(cxxtools::Formatter& formatter, const std::string& name, const TestObject& obj)
+    {
+        formatter.beginObject(name, typeName);
+        cxxtools::formatMember(formatter, intValue, obj.intValue);
+        cxxtools::formatMember(formatter, stringValue, obj.stringValue);
+        cxxtools::formatMember(formatter, doubleValue, obj.doubleValue);
+        cxxtools::formatMember(formatter, boolValue, obj.boolValue);
+        cxxtools::formatMember(formatter, msValue, obj.msValue);
+        cxxtools::formatMember(formatter, dtValue, obj.dtValue);
+        formatter.finishObject();
+    }
+
+    // Object with many members to measure member lookup by name.
+    struct WideObject
+    {
+        std::vector<int> values;
+    };
+
+    std::vector<std::string> wideMemberNames;
+
+    void operator>>= (const cxxtools::SerializationInfo& si, WideObject& obj)
+    {
+        obj.values.resize(wideMemberNames.size());
+        for (unsigned n = 0; n < wideMemberNames.size(); ++n)
+            si.getMember(wideMemberNames[n]) >>= obj.values[n];
+    }
+
+    void operator<<= (cxxtools::SerializationInfo& si, const WideObject& obj)
+    {
+        for (unsigned n = 0; n < obj.values.size(); ++n)
+            si.addMember(wideMemberNames[n]) <<= obj.values[n];
+        si.setTypeName("WideObject");
+    }
+
+    // Object with many distinct member names like a json dictionary.
+    struct KeyedObject
+    {
+        std::vector<std::pair<std::string, int>> entries;
+    };
+
+    void operator>>= (const cxxtools::SerializationInfo& si, KeyedObject& obj)
+    {
+        obj.entries.clear();
+        for (cxxtools::SerializationInfo::ConstIterator it = si.begin(); it != si.end(); ++it)
+        {
+            int value;
+            *it >>= value;
+            obj.entries.emplace_back(it->name(), value);
+        }
+    }
+
+    void operator<<= (cxxtools::SerializationInfo& si, const KeyedObject& obj)
+    {
+        for (unsigned n = 0; n < obj.entries.size(); ++n)
+            si.addMember(obj.entries[n].first) <<= obj.entries[n].second;
+        si.setTypeName("KeyedObject");
+    }
+
     bool runXml = true;
     bool runJson = true;
     bool runBin = true;
+
+    cxxtools::Arena arena;
+    bool useArena = false;
+    bool useTree = false;
 }
 
 // Function, which calls the serializer.
@@ -94,14 +157,41 @@ namespace
 template <typename T, typename Serializer>
 void serialize(Serializer& serializer, const T& data)
 {
-    serializer.serialize(data, "d");
+    if (useTree)
+    {
+        cxxtools::SerializationInfo si;
+        si <<= data;
+        serializer.serialize(si, "d");
+    }
+    else
+        serializer.serialize(data, "d");
 }
 
 // This is the specialization for json.
 template <typename T>
 void serialize(cxxtools::JsonSerializer& serializer, const T& data)
 {
-    serializer.serialize(data);
+    if (useTree)
+    {
+        cxxtools::SerializationInfo si;
+        si <<= data;
+        serializer.serialize(si);
+    }
+    else
+        serializer.serialize(data);
+}
+
+// Function, which reads the serialized data into the deserializer.
+template <typename Deserializer>
+void readData(Deserializer& deserializer, std::istream& in)
+{
+    deserializer.read(in);
+}
+
+// The xml deserializer calls it parse.
+void readData(cxxtools::xml::XmlDeserializer& deserializer, std::istream& in)
+{
+    deserializer.parse(in);
 }
 
 // Measure the duration to serialize and deserialize a object and output the result.
@@ -131,7 +221,10 @@ void benchSerialization(const T& d, const char* fname = 0)
     T v2;
     clock.start();
 
-    Deserializer deserializer(data);
+    Deserializer deserializer;
+    if (useArena)
+        deserializer.setArena(&arena);
+    readData(deserializer, data);
     deserializer.deserialize(v2);
 
     cxxtools::Timespan td = clock.stop();
@@ -199,12 +292,17 @@ int main(int argc, char* argv[])
         cxxtools::Arg<unsigned> I(argc, argv, 'I', nn);
         cxxtools::Arg<unsigned> D(argc, argv, 'D', nn);
         cxxtools::Arg<unsigned> C(argc, argv, 'C', nn);
+        cxxtools::Arg<unsigned> W(argc, argv, 'W', nn / 100);
+        cxxtools::Arg<unsigned> M(argc, argv, 'M', 500);
+        cxxtools::Arg<unsigned> S(argc, argv, 'S', nn / 4);
 
         cxxtools::Arg<bool> fileoutput(argc, argv, 'f');
 
         runXml  = cxxtools::Arg<bool>(argc, argv, 'x');
         runJson = cxxtools::Arg<bool>(argc, argv, 'j');
         runBin  = cxxtools::Arg<bool>(argc, argv, 'b');
+        useArena = cxxtools::Arg<bool>(argc, argv, 'A');
+        useTree = cxxtools::Arg<bool>(argc, argv, 'T');
 
         std::cout << "size of SerializationInfo: " << sizeof(cxxtools::SerializationInfo) << std::endl;
 
@@ -213,12 +311,19 @@ int main(int argc, char* argv[])
             runXml  = runJson = runBin  = true;
         }
 
-        std::cout << "benchmark serializer with " << I.getValue() << " int vector " << D.getValue() << " double vector and " << C.getValue() << " custom vector iterations\n\n"
+        std::cout << "benchmark serializer with " << I.getValue() << " int vector " << D.getValue() << " double vector and " << C.getValue() << " custom vector iterations\n"
+                     "and " << W.getValue() << " wide objects with " << M.getValue() << " members\n"
+                     "and objects with " << S.getValue() << " distinct member names\n\n"
                      "options:\n"
                      "   -n <number>       specify number of default iterations\n"
                      "   -I <number>       specify number of iterations for int vector\n"
                      "   -D <number>       specify number of iterations for double vector\n"
                      "   -C <number>       specify number of iterations for custom object\n"
+                     "   -W <number>       specify number of iterations for wide object\n"
+                     "   -M <number>       specify number of members of wide object\n"
+                     "   -S <number>       specify number of distinct member names of keyed object\n"
+                     "   -A                deserialize into an arena\n"
+                     "   -T                serialize through a SerializationInfo\n"
                      "   -f                write serialized output to files\n" << std::endl;
 
         if (I.getValue() > 0)
@@ -263,6 +368,67 @@ int main(int argc, char* argv[])
             }
         }
 
+        if (W.getValue() > 0 && M.getValue() > 0)
+        {
+            std::cout << "vector of wide objects:" << std::endl;
+
+            for (unsigned n = 0; n < M; ++n)
+                wideMemberNames.push_back("member" + cxxtools::convert<std::string>(n));
+
+            WideObject obj;
+            for (unsigned n = 0; n < M; ++n)
+                obj.values.push_back(n);
+
+            std::vector<WideObject> v(W, obj);
+
+            if (runXml)
+            {
+                std::cout << "xml:" << std::endl;
+                benchXmlSerialization(v, fileoutput ? "wideobject.xml" : 0);
+            }
+
+            if (runJson)
+            {
+                std::cout << "json:" << std::endl;
+                benchJsonSerialization(v, fileoutput ? "wideobject.json" : 0);
+            }
+
+            if (runBin)
+            {
+                std::cout << "bin:" << std::endl;
+                benchBinSerialization(v, fileoutput ? "wideobject.bin" : 0);
+            }
+        }
+
+        if (S.getValue() > 0)
+        {
+            std::cout << "keyed objects:" << std::endl;
+
+            KeyedObject obj;
+            for (unsigned n = 0; n < S; ++n)
+                obj.entries.emplace_back("key" + cxxtools::convert<std::string>(n), n);
+
+            std::vector<KeyedObject> v(2, obj);
+
+            if (runXml)
+            {
+                std::cout << "xml:" << std::endl;
+                benchXmlSerialization(v, fileoutput ? "keyedobject.xml" : 0);
+            }
+
+            if (runJson)
+            {
+                std::cout << "json:" << std::endl;
+                benchJsonSerialization(v, fileoutput ? "keyedobject.json" : 0);
+            }
+
+            if (runBin)
+            {
+                std::cout << "bin:" << std::endl;
+                benchBinSerialization(v, fileoutput ? "keyedobject.bin" : 0);
+            }
+        }
+
     }
     catch (const std::exception& e)
     {
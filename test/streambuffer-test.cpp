@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/streambuffer.h"
+#include "cxxtools/pipe.h"
+#include "cxxtools/method.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <algorithm>
+#include <ostream>
+#include <string>
+
+class StreamBufferTest : public cxxtools::unit::TestSuite
+{
+        unsigned _released;
+
+        void onReleased()
+        { ++_released; }
+
+        static std::string readPipe(cxxtools::Pipe& pipe, std::size_t n)
+        {
+            std::string ret;
+            char buffer[64];
+            while (ret.size() < n)
+            {
+                std::size_t c = pipe.read(buffer, std::min(sizeof(buffer), n - ret.size()));
+                ret.append(buffer, c);
+            }
+            return ret;
+        }
+
+    public:
+        StreamBufferTest()
+        : cxxtools::unit::TestSuite("streambuffer"),
+          _released(0)
+        {
+            registerMethod("WriteBorrowed", *this, &StreamBufferTest::WriteBorrowed);
+            registerMethod("WriteBorrowedOverflow", *this, &StreamBufferTest::WriteBorrowedOverflow);
+            registerMethod("DiscardBorrowed", *this, &StreamBufferTest::DiscardBorrowed);
+        }
+
+        void setUp()
+        {
+            _released = 0;
+        }
+
+        void WriteBorrowed()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::StreamBuffer sb(pipe.in(), 64);
+            std::ostream out(&sb);
+
+            out << "head ";
+            sb.writeBorrowed("body", 4, cxxtools::callable(*this, &StreamBufferTest::onReleased));
+            out << " tail";
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.borrowedAvail(), 4u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_released, 0u);
+
+            out.flush();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.borrowedAvail(), 0u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_released, 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readPipe(pipe, 14), "head body tail");
+        }
+
+        void WriteBorrowedOverflow()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::StreamBuffer sb(pipe.in(), 8);
+            std::ostream out(&sb);
+
+            // the data after the borrowed buffer does not fit into the buffer
+            out << "ab";
+            sb.writeBorrowed("0123456789", 10);
+            sb.writeBorrowed("xy", 2, cxxtools::callable(*this, &StreamBufferTest::onReleased));
+            out << "cdefghijkl";
+            out.flush();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_released, 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readPipe(pipe, 24), "ab0123456789xycdefghijkl");
+        }
+
+        void DiscardBorrowed()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::StreamBuffer sb(pipe.in(), 64);
+            std::ostream out(&sb);
+
+            out << "head ";
+            sb.writeBorrowed("body", 4, cxxtools::callable(*this, &StreamBufferTest::onReleased));
+            sb.discard();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_released, 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sb.borrowedAvail(), 0u);
+
+            out << "next";
+            out.flush();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readPipe(pipe, 4), "next");
+        }
+};
+
+cxxtools::unit::RegisterTest<StreamBufferTest> register_StreamBufferTest;
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the cost of starting, restarting and stopping timers.
+ *
+ * A server usually has one keep alive timer per connection, which is
+ * restarted on each request. This is simulated by restarting random timers
+ * of a large set.
+ */
+
+#include <cxxtools/timer.h>
+#include <cxxtools/selector.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <random>
+
+namespace
+{
+    unsigned fired = 0;
+
+    void onTimeout()
+    {
+        ++fired;
+    }
+
+    void report(const char* name, unsigned count, cxxtools::Timespan t)
+    {
+        std::cout << name << ": " << t << ' '
+                  << static_cast<double>(t.totalUSecs()) * 1000 / count << " ns/op" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        cxxtools::Arg<unsigned> count(argc, argv, 'n', 100000);
+        cxxtools::Arg<unsigned> churn(argc, argv, 'c', 1000000);
+
+        std::cout << "benchmark timers\n\n"
+                     "options:\n"
+                     "   -n <number>       specify number of timers\n"
+                     "   -c <number>       specify number of timer restarts\n" << std::endl;
+
+        cxxtools::Selector selector;
+        std::vector<std::unique_ptr<cxxtools::Timer>> timers;
+        std::mt19937 rnd(42);
+        std::uniform_int_distribution<unsigned> interval(10000, 60000);
+        std::uniform_int_distribution<unsigned> pick(0, count - 1);
+
+        for (unsigned n = 0; n < count; ++n)
+        {
+            timers.emplace_back(new cxxtools::Timer(&selector));
+            cxxtools::connect(timers.back()->timeout, onTimeout);
+        }
+
+        cxxtools::Clock clock;
+
+        clock.start();
+        for (unsigned n = 0; n < count; ++n)
+            timers[n]->start(cxxtools::Milliseconds(interval(rnd)));
+        report("start", count, clock.stop());
+
+        clock.start();
+        for (unsigned n = 0; n < churn; ++n)
+            timers[pick(rnd)]->start(cxxtools::Milliseconds(interval(rnd)));
+        report("restart", churn, clock.stop());
+
+        clock.start();
+        for (unsigned n = 0; n < count; ++n)
+            timers[n]->stop();
+        report("stop", count, clock.stop());
+
+        // let all timers expire within a short time
+        std::uniform_int_distribution<unsigned> shortInterval(1, 100);
+        for (unsigned n = 0; n < count; ++n)
+            timers[n]->after(cxxtools::Milliseconds(shortInterval(rnd)));
+
+        clock.start();
+        while (fired < count)
+            selector.wait();
+        report("expire", count, clock.stop());
+
+        clock.start();
+        timers.clear();
+        report("destroy", count, clock.stop());
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
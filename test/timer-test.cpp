@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/timer.h"
+#include "cxxtools/selector.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+class TimerTest : public cxxtools::unit::TestSuite
+{
+        class Tick : public cxxtools::Connectable
+        {
+                std::string& _ticks;
+                char _name;
+
+            public:
+                cxxtools::Timer timer;
+
+                Tick(cxxtools::SelectorBase& selector, std::string& ticks, char name)
+                    : _ticks(ticks),
+                      _name(name),
+                      timer(&selector)
+                {
+                    cxxtools::connect(timer.timeout, *this, &Tick::onTimeout);
+                }
+
+                void onTimeout()
+                {
+                    _ticks += _name;
+                }
+        };
+
+        std::string _ticks;
+        std::unique_ptr<cxxtools::Timer> _other;
+
+        void waitTicks(cxxtools::Selector& selector, std::string::size_type n)
+        {
+            for (unsigned count = 0; _ticks.size() < n && count < 100; ++count)
+                selector.wait(100);
+        }
+
+        void onTimeoutDestroy()
+        {
+            _ticks += 'x';
+            _other.reset();
+        }
+
+        void onTimeoutRestart()
+        {
+            _ticks += 'r';
+            if (_ticks.size() < 3)
+                _other->after(1);
+        }
+
+    public:
+        TimerTest()
+        : cxxtools::unit::TestSuite("timer")
+        {
+            registerMethod("order", *this, &TimerTest::order);
+            registerMethod("stop", *this, &TimerTest::stop);
+            registerMethod("restart", *this, &TimerTest::restart);
+            registerMethod("destroyInCallback", *this, &TimerTest::destroyInCallback);
+            registerMethod("restartInCallback", *this, &TimerTest::restartInCallback);
+        }
+
+        void setUp()
+        {
+            _ticks.clear();
+        }
+
+        void order()
+        {
+            cxxtools::Selector selector;
+            Tick a(selector, _ticks, 'a');
+            Tick b(selector, _ticks, 'b');
+            Tick c(selector, _ticks, 'c');
+            Tick d(selector, _ticks, 'd');
+
+            c.timer.after(30);
+            a.timer.after(10);
+            d.timer.after(40);
+            b.timer.after(20);
+
+            waitTicks(selector, 4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_ticks, "abcd");
+        }
+
+        void stop()
+        {
+            cxxtools::Selector selector;
+            Tick a(selector, _ticks, 'a');
+            Tick b(selector, _ticks, 'b');
+            Tick c(selector, _ticks, 'c');
+
+            a.timer.after(10);
+            b.timer.after(20);
+            c.timer.after(30);
+            b.timer.stop();
+
+            waitTicks(selector, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_ticks, "ac");
+            CXXTOOLS_UNIT_ASSERT(!selector.wait(50));
+        }
+
+        void restart()
+        {
+            cxxtools::Selector selector;
+            Tick a(selector, _ticks, 'a');
+            Tick b(selector, _ticks, 'b');
+
+            a.timer.after(10);
+            b.timer.after(30);
+            a.timer.after(50);
+
+            waitTicks(selector, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_ticks, "ba");
+        }
+
+        void destroyInCallback()
+        {
+            cxxtools::Selector selector;
+            cxxtools::Timer timer(&selector);
+            cxxtools::connect(timer.timeout, *this, &TimerTest::onTimeoutDestroy);
+
+            _other.reset(new cxxtools::Timer(&selector));
+            cxxtools::connect(_other->timeout, *this, &TimerTest::onTimeoutDestroy);
+
+            // both timers expire in the same wait
+            timer.after(10);
+            _other->after(15);
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+            waitTicks(selector, 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_ticks, "x");
+            CXXTOOLS_UNIT_ASSERT(!selector.wait(50));
+        }
+
+        void restartInCallback()
+        {
+            cxxtools::Selector selector;
+            _other.reset(new cxxtools::Timer(&selector));
+            cxxtools::connect(_other->timeout, *this, &TimerTest::onTimeoutRestart);
+
+            _other->after(1);
+            waitTicks(selector, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_ticks, "rrr");
+            CXXTOOLS_UNIT_ASSERT(!selector.wait(50));
+            _other.reset();
+        }
+};
+
+cxxtools::unit::RegisterTest<TimerTest> register_TimerTest;
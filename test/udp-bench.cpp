@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the cost of sending and receiving udp datagrams with one system
+ * call per datagram, returning a std::string or into a buffer, and with
+ * batches sent and received with sendmmsg/recvmmsg.
+ *
+ * A burst of datagrams is sent to a receiving socket and then read back
+ * in the same thread. Doing both in one thread makes the measurement
+ * independent of scheduling, so that the time spent per datagram is the
+ * cost of the system calls. The burst must fit into the socket receive
+ * buffer; datagrams lost nevertheless are reported.
+ */
+
+#include <cxxtools/net/udp.h>
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/ioerror.h>
+#include <cxxtools/log.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+    struct Config
+    {
+        std::string ip;
+        unsigned short port;
+        unsigned size;
+        unsigned burst;
+        cxxtools::Milliseconds duration;
+    };
+
+    struct Result
+    {
+        double sendTime;    // ns per datagram
+        double recvTime;    // ns per datagram
+        double rate;        // datagrams per second
+        unsigned long lost;
+    };
+
+    enum Mode
+    {
+        String,
+        Single,
+        Batch
+    };
+
+    const char* modeName(Mode mode)
+    {
+        switch (mode)
+        {
+            case String: return "string";
+            case Single: return "single";
+            case Batch:  return "batch";
+        }
+        return "";
+    }
+
+    Result measure(const Config& config, Mode mode)
+    {
+        cxxtools::net::UdpReceiver receiver(config.ip, config.port);
+        receiver.setTimeout(100);
+        cxxtools::net::UdpSender sender(config.ip, config.port);
+
+        std::string message(config.size, 'x');
+        std::vector<char> buffer(65536);
+
+        cxxtools::net::UdpBatch sendBatch(config.burst, config.size);
+        while (!sendBatch.full())
+            sendBatch.add(message);
+        cxxtools::net::UdpBatch recvBatch(config.burst, 65536);
+
+        cxxtools::Timespan sendTime;
+        cxxtools::Timespan recvTime;
+        unsigned long sent = 0;
+        unsigned long received = 0;
+
+        cxxtools::Clock total;
+        total.start();
+
+        while (total.stop() < config.duration)
+        {
+            cxxtools::Clock clock;
+
+            clock.start();
+            if (mode == Batch)
+            {
+                sent += sender.send(sendBatch);
+            }
+            else
+            {
+                for (unsigned n = 0; n < config.burst; ++n)
+                    sender.send(message);
+                sent += config.burst;
+            }
+            sendTime += clock.stop();
+
+            clock.start();
+            unsigned n = 0;
+            try
+            {
+                while (n < config.burst)
+                {
+                    if (mode == Batch)
+                    {
+                        n += receiver.recv(recvBatch);
+                    }
+                    else if (mode == Single)
+                    {
+                        receiver.recv(&buffer[0], buffer.size());
+                        ++n;
+                    }
+                    else
+                    {
+                        std::string s = receiver.recv(buffer.size());
+                        ++n;
+                    }
+                }
+            }
+            catch (const cxxtools::IOTimeout&)
+            {
+            }
+            recvTime += clock.stop();
+            received += n;
+        }
+
+        Result result;
+        result.sendTime = sendTime.totalUSecs() * 1e3 / sent;
+        result.recvTime = recvTime.totalUSecs() * 1e3 / sent;
+        result.rate = sent / total.stop().totalSeconds();
+        result.lost = sent - received;
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        log_init();
+
+        Config config;
+        config.ip = cxxtools::Arg<std::string>(argc, argv, 'i', "127.0.0.1").getValue();
+        config.port = cxxtools::Arg<unsigned short>(argc, argv, 'p', 8003);
+        config.size = cxxtools::Arg<unsigned>(argc, argv, 'S', 100);
+        config.burst = cxxtools::Arg<unsigned>(argc, argv, 'b', 64);
+        config.duration = cxxtools::Seconds(cxxtools::Arg<double>(argc, argv, 's', 2));
+
+        std::cout << "benchmark udp send and receive\n\n"
+                     "options:\n"
+                     "   -i <ip>           ip address to send to (default: 127.0.0.1)\n"
+                     "   -p <port>         port to send to (default: 8003)\n"
+                     "   -S <bytes>        size of datagrams (default: 100)\n"
+                     "   -b <number>       number of datagrams per burst and batch (default: 64)\n"
+                     "   -s <seconds>      duration of each measurement (default: 2)\n" << std::endl;
+
+        std::cout << std::setw(10) << "mode"
+                  << std::setw(18) << "send [ns/#]"
+                  << std::setw(18) << "recv [ns/#]"
+                  << std::setw(18) << "total [#/s]"
+                  << std::setw(10) << "lost" << std::endl;
+
+        Mode modes[] = { String, Single, Batch };
+        for (Mode mode: modes)
+        {
+            Result result = measure(config, mode);
+            std::cout << std::setw(10) << modeName(mode)
+                      << std::setw(18) << std::fixed << std::setprecision(0) << result.sendTime
+                      << std::setw(18) << result.recvTime
+                      << std::setw(18) << result.rate
+                      << std::setw(10) << result.lost << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
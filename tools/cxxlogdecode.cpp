@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Converts binary log files written with LogConfiguration::setBinary to the
+ * text format of the usual log files.
+ */
+
+#include "logbinary.h"
+
+#include <cxxtools/arg.h>
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+namespace
+{
+    class Decoder
+    {
+        typedef std::vector<std::string> Dictionary;
+
+        std::ostream& _out;
+        bool _utc;
+        bool _threadIdHex;
+
+        Dictionary _levels;
+        Dictionary _categories;
+        Dictionary _formats;
+
+        std::string _body;
+
+        template <typename T>
+        static T get(const char*& p, const char* end)
+        {
+            if (end - p < static_cast<std::ptrdiff_t>(sizeof(T)))
+                throw std::runtime_error("truncated record");
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        }
+
+        static void define(Dictionary& dict, const char* p, const char* end);
+        static std::string lookup(const Dictionary& dict, uint32_t id, const char*& p, const char* end);
+
+        void start(const char* p, const char* end);
+        void message(const char* p, const char* end);
+        void putTime(int64_t time);
+
+    public:
+        Decoder(std::ostream& out, bool utc, bool threadIdHex)
+          : _out(out),
+            _utc(utc),
+            _threadIdHex(threadIdHex)
+        { }
+
+        void decode(std::istream& in);
+    };
+
+    void Decoder::decode(std::istream& in)
+    {
+        char type;
+        while (in.get(type))
+        {
+            uint32_t size;
+            if (!in.read(reinterpret_cast<char*>(&size), sizeof(size)))
+                throw std::runtime_error("truncated record");
+
+            // The body is read in chunks, so that a corrupt size field does
+            // not allocate more memory than the file actually has left.
+            _body.clear();
+            while (_body.size() < size)
+            {
+                std::size_t offset = _body.size();
+                std::size_t count = std::min<std::size_t>(size - offset, 65536);
+                _body.resize(offset + count);
+                if (!in.read(&_body[offset], count))
+                    throw std::runtime_error("corrupt record");
+            }
+
+            const char* p = _body.data();
+            const char* end = p + _body.size();
+
+            switch (type)
+            {
+                case cxxtools::logbinary::StartRecord:    start(p, end); break;
+                case cxxtools::logbinary::LevelRecord:    define(_levels, p, end); break;
+                case cxxtools::logbinary::CategoryRecord: define(_categories, p, end); break;
+                case cxxtools::logbinary::FormatRecord:   define(_formats, p, end); break;
+                case cxxtools::logbinary::MessageRecord:  message(p, end); break;
+                default:
+                    // unknown records are skipped
+                    break;
+            }
+        }
+    }
+
+    void Decoder::start(const char* p, const char* end)
+    {
+        if (end - p < static_cast<std::ptrdiff_t>(sizeof(cxxtools::logbinary::magic))
+            || std::memcmp(p, cxxtools::logbinary::magic, sizeof(cxxtools::logbinary::magic)) != 0)
+            throw std::runtime_error("not a binary log file");
+        p += sizeof(cxxtools::logbinary::magic);
+
+        if (get<unsigned char>(p, end) != cxxtools::logbinary::version)
+            throw std::runtime_error("unsupported version of binary log file");
+
+        if (get<uint32_t>(p, end) != cxxtools::logbinary::byteOrder)
+            throw std::runtime_error("binary log file was written with a different byte order");
+
+        _levels.clear();
+        _categories.clear();
+        _formats.clear();
+    }
+
+    void Decoder::define(Dictionary& dict, const char* p, const char* end)
+    {
+        uint32_t id = get<uint32_t>(p, end);
+        // ids are assigned sequentially, so a new definition takes the next one
+        if (id == 0 || id > dict.size() + 1)
+            throw std::runtime_error("corrupt record");
+
+        if (dict.size() < id)
+            dict.resize(id);
+        dict[id - 1].assign(p, end);
+    }
+
+    std::string Decoder::lookup(const Dictionary& dict, uint32_t id, const char*& p, const char* end)
+    {
+        if (id == 0)
+        {
+            uint32_t size = get<uint32_t>(p, end);
+            if (end - p < static_cast<std::ptrdiff_t>(size))
+                throw std::runtime_error("truncated record");
+            std::string text(p, size);
+            p += size;
+            return text;
+        }
+
+        if (id > dict.size())
+            throw std::runtime_error("undefined id in message");
+
+        return dict[id - 1];
+    }
+
+    void Decoder::putTime(int64_t time)
+    {
+        time_t sec = static_cast<time_t>(time / 1000000);
+        unsigned usec = static_cast<unsigned>(time % 1000000);
+
+        struct tm tt;
+        if (_utc)
+            gmtime_r(&sec, &tt);
+        else
+            localtime_r(&sec, &tt);
+
+        // same format as the text log, which has 5 fractional digits
+        char buffer[96];
+        snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d.%05u",
+            1900 + tt.tm_year, tt.tm_mon + 1, tt.tm_mday,
+            tt.tm_hour, tt.tm_min, tt.tm_sec, usec / 10);
+
+        _out << buffer;
+    }
+
+    void Decoder::message(const char* p, const char* end)
+    {
+        uint32_t levelId = get<uint32_t>(p, end);
+        uint32_t categoryId = get<uint32_t>(p, end);
+        uint32_t formatId = get<uint32_t>(p, end);
+
+        std::string level = lookup(_levels, levelId, p, end);
+        std::string category = lookup(_categories, categoryId, p, end);
+        std::string format = lookup(_formats, formatId, p, end);
+
+        int64_t time = get<int64_t>(p, end);
+        uint32_t pid = get<uint32_t>(p, end);
+        uint64_t thread = get<uint64_t>(p, end);
+
+        putTime(time);
+        _out << " [" << pid << '.';
+        if (_threadIdHex)
+        {
+            char buffer[20];
+            snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(thread));
+            _out << buffer;
+        }
+        else
+        {
+            _out << thread;
+        }
+
+        _out << "] " << level << ' ' << category << " - ";
+
+        for (std::string::const_iterator it = format.begin(); it != format.end(); ++it)
+        {
+            if (*it != cxxtools::logbinary::placeholder || p == end)
+            {
+                _out << *it;
+                continue;
+            }
+
+            char type = get<char>(p, end);
+            switch (type)
+            {
+                case cxxtools::logbinary::SignedArg:   _out << get<int64_t>(p, end); break;
+                case cxxtools::logbinary::UnsignedArg: _out << get<uint64_t>(p, end); break;
+                case cxxtools::logbinary::DoubleArg:   _out << get<double>(p, end); break;
+                default:
+                    throw std::runtime_error("unknown argument type");
+            }
+        }
+
+        _out << '\n';
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        cxxtools::Arg<bool> help(argc, argv, '?');
+        cxxtools::Arg<bool> utc(argc, argv, 'u');
+        cxxtools::Arg<bool> threadIdHex(argc, argv, 'x');
+
+        if (help)
+        {
+            std::cerr << "Usage: " << argv[0] << " {options} [files]\n"
+                         "\n"
+                         "Converts binary log files to text. Reads from stdin when no file is given.\n"
+                         "\n"
+                         "Options:\n"
+                         " -u             print times in UTC\n"
+                         " -x             print thread ids in hex\n";
+            return 0;
+        }
+
+        Decoder decoder(std::cout, utc, threadIdHex);
+
+        if (argc <= 1)
+        {
+            decoder.decode(std::cin);
+        }
+        else
+        {
+            for (int a = 1; a < argc; ++a)
+            {
+                std::ifstream in(argv[a], std::ios::binary);
+                if (!in)
+                    throw std::runtime_error(std::string("failed to open file ") + argv[a]);
+                decoder.decode(in);
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}